@@ -14,6 +14,7 @@
 //*************************************************************************
 //*************************************************************************
 #include "compressor_model.h"
+#include "sensor_prof.h"
 #include <stdio.h>
 #include <math.h>
 
@@ -24,7 +25,7 @@
  * \brief   This array defines the coefficient of compressor model
  */
 //-------------------------------------------------------------------------------------------------
-static const float COE_32[] = {	97.067,		-177.99,		297.6,		20.081,		11.098,		-1.8449,		0.44883,	0,
+const float COE_32[COMP_COE_N] = {	97.067,		-177.99,		297.6,		20.081,		11.098,		-1.8449,		0.44883,	0,
 								0,			0.65281,		0,			0,			0.096619,	-0.029134,		0.011636,	-0.11126,
 								0.073423,	-0.024061,		2.4395,		0.029512,	-119.08,	-85.79,			12.689,		-0.00026992,
 								0.00047164,	-0.00019762,	0.3311,		-0.53155,	0.18157,	0.0000024884,	390.25,		-150.24
@@ -42,25 +43,26 @@ static const float COE_32[] = {	97.067,		-177.99,		297.6,		20.081,		11.098,		-1.
 //-------------------------------------------------------------------------------------------------
 /**
  * \def
- * \brief		Define the calculation of intermediate coefficients by initial coefficients.
+ * \brief		Define the calculation of intermediate coefficients by initial coefficients k[],
+ *				COMP_COE_N values laid out like COE_32[].
 */
 //-------------------------------------------------------------------------------------------------
 #define PR(pd, ps) ((pd)/(ps))	//pd:discharge pressure, ps:suction pressure
 #define SR(compSpeed) ((compSpeed)/(COMPSPEED_RATED))
 
-#define COE_A(compSpeed) (COE_32[0]+COE_32[1]*sqrt(SR(compSpeed))+COE_32[2]*SR(compSpeed))
-#define COE_B(compSpeed) (COE_32[3]+COE_32[4]*pow(SR(compSpeed), 2)+COE_32[5]*pow(SR(compSpeed), 4))
-#define COE_C(compSpeed) (COE_32[6]+COE_32[7]*SR(compSpeed)+COE_32[8]*pow(SR(compSpeed), 2))
-#define COE_D(compSpeed) (COE_32[9]+COE_32[10]*sqrt(SR(compSpeed))+COE_32[11]*SR(compSpeed))
-#define COE_Y1(compSpeed) (COE_32[12]+COE_32[13]*SR(compSpeed)+COE_32[14]*pow(SR(compSpeed), 2))
-#define COE_Y2(compSpeed) (COE_32[15]+COE_32[16]*SR(compSpeed)+COE_32[17]*pow(SR(compSpeed), 2))
-#define COE_F(compSpeed) (COE_Y1(compSpeed)-COE_Y2(compSpeed))/(pow(COE_32[18], COE_D(compSpeed))-\
-							pow(COE_32[19], COE_D(compSpeed)))
-#define COE_E(compSpeed) COE_Y1(compSpeed)-COE_F(compSpeed)*pow(COE_32[18], COE_D(compSpeed))
-#define COE_G(compSpeed) (COE_32[20]+COE_32[21]*pow(SR(compSpeed), 2)+COE_32[22]*pow(SR(compSpeed), 4))
-#define COE_Q(compSpeed) (COE_32[23]+COE_32[24]*SR(compSpeed)+COE_32[25]*pow(SR(compSpeed), 2))
-#define COE_R(compSpeed) (COE_32[26]+COE_32[27]*pow(SR(compSpeed), 2)+COE_32[28]*pow(SR(compSpeed), 4))
-#define COE_S(compSpeed) (COE_32[29]+COE_32[30]*pow(SR(compSpeed), 2)+COE_32[31]*pow(SR(compSpeed), 4))
+#define COE_A(k, compSpeed) ((k)[0]+(k)[1]*sqrt(SR(compSpeed))+(k)[2]*SR(compSpeed))
+#define COE_B(k, compSpeed) ((k)[3]+(k)[4]*pow(SR(compSpeed), 2)+(k)[5]*pow(SR(compSpeed), 4))
+#define COE_C(k, compSpeed) ((k)[6]+(k)[7]*SR(compSpeed)+(k)[8]*pow(SR(compSpeed), 2))
+#define COE_D(k, compSpeed) ((k)[9]+(k)[10]*sqrt(SR(compSpeed))+(k)[11]*SR(compSpeed))
+#define COE_Y1(k, compSpeed) ((k)[12]+(k)[13]*SR(compSpeed)+(k)[14]*pow(SR(compSpeed), 2))
+#define COE_Y2(k, compSpeed) ((k)[15]+(k)[16]*SR(compSpeed)+(k)[17]*pow(SR(compSpeed), 2))
+#define COE_F(k, compSpeed) (COE_Y1(k, compSpeed)-COE_Y2(k, compSpeed))/(pow((k)[18], COE_D(k, compSpeed))-\
+							pow((k)[19], COE_D(k, compSpeed)))
+#define COE_E(k, compSpeed) COE_Y1(k, compSpeed)-COE_F(k, compSpeed)*pow((k)[18], COE_D(k, compSpeed))
+#define COE_G(k, compSpeed) ((k)[20]+(k)[21]*pow(SR(compSpeed), 2)+(k)[22]*pow(SR(compSpeed), 4))
+#define COE_Q(k, compSpeed) ((k)[23]+(k)[24]*SR(compSpeed)+(k)[25]*pow(SR(compSpeed), 2))
+#define COE_R(k, compSpeed) ((k)[26]+(k)[27]*pow(SR(compSpeed), 2)+(k)[28]*pow(SR(compSpeed), 4))
+#define COE_S(k, compSpeed) ((k)[29]+(k)[30]*pow(SR(compSpeed), 2)+(k)[31]*pow(SR(compSpeed), 4))
 
 
 
@@ -81,20 +83,12 @@ static const float COE_32[] = {	97.067,		-177.99,		297.6,		20.081,		11.098,		-1.
 //-------------------------------------------------------------------------------------------------
 float cal_volume_flow_rate(float pd, float ps, float compSpeed)
 {
-	float a, b, c, pr;
-	float volume_flow_rate;
+	comp_coe_t coe;
 
 	/* Calculated intermediate coefficients */
-	a = COE_A(compSpeed);
-	b = COE_B(compSpeed);
-	c = COE_C(compSpeed);
-	pr = PR(pd, ps);
-
-	/* Calculated volume flow rate */
-	volume_flow_rate = (a-b*pow(pr, c))*4.719476965*pow(10, (-4))/60;
-	volume_flow_rate = (volume_flow_rate < 0) ? 0.00000001 : volume_flow_rate;
+	cal_comp_coe(compSpeed, &coe);
 
-	return volume_flow_rate;
+	return cal_volume_flow_rate_coe(&coe, pd, ps);
 }
 
 
@@ -116,20 +110,119 @@ float cal_volume_flow_rate(float pd, float ps, float compSpeed)
 //-------------------------------------------------------------------------------------------------
 float cal_power(float pd, float ps, float compSpeed)
 {
-	float d, e, f, g, pr;
-	float volume_flow_rate, power;
+	comp_coe_t coe;
 
 	/* Calculated intermediate coefficients */
-	d = COE_D(compSpeed);
-	e = COE_E(compSpeed);
-	f = COE_F(compSpeed);
-	g = COE_G(compSpeed);
+	cal_comp_coe(compSpeed, &coe);
+
+	return cal_power_coe(&coe, pd, ps, cal_volume_flow_rate_coe(&coe, pd, ps));
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_comp_coe()
+ *
+ * \brief		Calculated intermediate coefficients of the compressor model.
+ *
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[out]	coe = intermediate coefficients.
+*/
+//-------------------------------------------------------------------------------------------------
+void cal_comp_coe(float compSpeed, comp_coe_t *coe)
+{
+	cal_comp_coe_k(COE_32, compSpeed, coe);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_comp_coe_k()
+ *
+ * \brief		Calculated intermediate coefficients of the compressor model from a set of
+ *				initial coefficients.
+ *
+ * \param[in]	k = COMP_COE_N initial coefficients laid out like COE_32[].
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[out]	coe = intermediate coefficients.
+*/
+//-------------------------------------------------------------------------------------------------
+void cal_comp_coe_k(const float *k, float compSpeed, comp_coe_t *coe)
+{
+	SENSOR_PROF_BEGIN();
+
+	coe->a = COE_A(k, compSpeed);
+	coe->b = COE_B(k, compSpeed);
+	coe->c = COE_C(k, compSpeed);
+	coe->d = COE_D(k, compSpeed);
+	coe->e = COE_E(k, compSpeed);
+	coe->f = COE_F(k, compSpeed);
+	coe->g = COE_G(k, compSpeed);
+	SENSOR_PROF_END(SENSOR_PROF_COMP_COE);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_volume_flow_rate_coe()
+ *
+ * \brief		Calculated volume flow rate from precomputed coefficients.
+ * 				volume_flow_rate = (a-b*pr^c)*4.719476965*10^(-4)/60
+ *
+ * \param[in]	coe = intermediate coefficients from cal_comp_coe().
+ * \param[in]	pd = discharge pressure in kPa.
+ * \param[in]	ps = suction pressure in kPa.
+ *
+ * \return		volume flow rate in m^3/s.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_volume_flow_rate_coe(const comp_coe_t *coe, float pd, float ps)
+{
+	float pr;
+	float volume_flow_rate;
+
 	pr = PR(pd, ps);
 
 	/* Calculated volume flow rate */
-	volume_flow_rate = cal_volume_flow_rate(pd, ps, compSpeed);
+	volume_flow_rate = (coe->a-coe->b*pow(pr, coe->c))*4.719476965*pow(10, (-4))/60;
+	volume_flow_rate = (volume_flow_rate < 0) ? 0.00000001 : volume_flow_rate;
+
+	return volume_flow_rate;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_power_coe()
+ *
+ * \brief		Calculated power from precomputed coefficients and volume flow rate.
+ * 				power = ((e+f*pr^d)*ps*0.000145*1000*volume_flow_rate/(4.719476965*10^(-4)/60))+g
+ *
+ * \param[in]	coe = intermediate coefficients from cal_comp_coe().
+ * \param[in]	pd = discharge pressure in kPa.
+ * \param[in]	ps = suction pressure in kPa.
+ * \param[in]	volume_flow_rate = result of cal_volume_flow_rate_coe() at the same pd, ps.
+ *
+ * \return		power in W.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_power_coe(const comp_coe_t *coe, float pd, float ps, float volume_flow_rate)
+{
+	float pr;
+	float power;
+
+	pr = PR(pd, ps);
+
 	/* Calculated power */
-	power = ((e+f*pow(pr, d))*ps*0.000145*1000*volume_flow_rate/(4.719476965*pow(10, (-4))/60))+g;
+	power = ((coe->e+coe->f*pow(pr, coe->d))*ps*0.000145*1000*volume_flow_rate/(4.719476965*pow(10, (-4))/60))+coe->g;
 	power = (power < 0) ? 0 : power;
 
 	return power;
@@ -154,11 +247,38 @@ float cal_power(float pd, float ps, float compSpeed)
 */
 //-------------------------------------------------------------------------------------------------
 float cal_current(float pd, float ps, float compSpeed, float U)
+{
+	comp_coe_t coe;
+
+	/* Calculated intermediate coefficients */
+	cal_comp_coe(compSpeed, &coe);
+
+	return cal_current_coe(&coe, pd, ps, U);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_current_coe()
+ *
+ * \brief		Calculated current from precomputed coefficients.
+ *
+ * \param[in]	coe = intermediate coefficients from cal_comp_coe().
+ * \param[in]	pd = discharge pressure in kPa.
+ * \param[in]	ps = suction pressure in kPa.
+ * \param[in]	U = the voltage of compressor.
+ *
+ * \return		current in A.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_current_coe(const comp_coe_t *coe, float pd, float ps, float U)
 {
 	float power, current;
 
 	/* Calculated power */
-	power = cal_power(pd, ps, compSpeed);
+	power = cal_power_coe(coe, pd, ps, cal_volume_flow_rate_coe(coe, pd, ps));
 
 	/* Calculated current */
 	if (U <= 0)
@@ -187,18 +307,18 @@ void compressor_model_test(void)
 	/* Calculated Pr */
 	pr = PR(Pd, Ps);
 	sr = SR(CompSpeed);
-	COE_A = COE_A(CompSpeed);
-	COE_B = COE_B(CompSpeed);
-	COE_C = COE_C(CompSpeed);
-	COE_D = COE_D(CompSpeed);
-	COE_Y1 = COE_Y1(CompSpeed);
-	COE_Y2 = COE_Y2(CompSpeed);
-	COE_F = COE_F(CompSpeed);
-	COE_E = COE_E(CompSpeed);
-	COE_G = COE_G(CompSpeed);
-	COE_Q = COE_Q(CompSpeed);
-	COE_R = COE_R(CompSpeed);
-	COE_S = COE_S(CompSpeed);
+	COE_A = COE_A(COE_32, CompSpeed);
+	COE_B = COE_B(COE_32, CompSpeed);
+	COE_C = COE_C(COE_32, CompSpeed);
+	COE_D = COE_D(COE_32, CompSpeed);
+	COE_Y1 = COE_Y1(COE_32, CompSpeed);
+	COE_Y2 = COE_Y2(COE_32, CompSpeed);
+	COE_F = COE_F(COE_32, CompSpeed);
+	COE_E = COE_E(COE_32, CompSpeed);
+	COE_G = COE_G(COE_32, CompSpeed);
+	COE_Q = COE_Q(COE_32, CompSpeed);
+	COE_R = COE_R(COE_32, CompSpeed);
+	COE_S = COE_S(COE_32, CompSpeed);
 	printf("pr = %f: \r\n", pr);
 	printf("sr = %f: \r\n", sr);
 	printf("COE_A = %f: \r\n", COE_A);
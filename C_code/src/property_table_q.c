@@ -0,0 +1,297 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		property_table_q.c
+ *
+ * \brief		Lookup tables of R410A gas density for the fixed-point prediction.
+ * \brief		GENERATED by tools/gen_property_table_q.c, do not edit.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "property_table_q.h"
+
+
+const q16_t dens_sat_q[DENS_SAT_N] = {
+	144992, 152846, 161051, 169619, 178561, 187891, 197620, 207761,
+	218328, 229334, 240793, 252717, 265122, 278021, 291428, 305359,
+	319829, 334852, 350444, 366620, 383397, 400790, 418817, 437492,
+	456833, 476858, 497583, 519025, 541204, 564136, 587840, 612334,
+	637638, 663770, 690750, 718598, 747333, 776976, 807548, 839070,
+	871563, 905049, 939550, 975090, 1011691, 1049377, 1088172, 1128101,
+	1169189, 1211463, 1254948, 1299671, 1345662, 1392948, 1441560, 1491527,
+	1542881, 1595654, 1649880, 1705592, 1762828, 1821623, 1882015, 1944045,
+	2007753, 2073182, 2140376, 2209381, 2280246, 2353020, 2427756, 2504507,
+	2583331, 2664288, 2747439, 2832849, 2920587, 3010725, 3103337, 3198502,
+	3296303, 3396828, 3500168, 3606420, 3715686, 3828072, 3943694, 4062671,
+	4185129, 4311203, 4441035, 4574775, 4712585, 4854632, 5001099, 5152176,
+	5308068, 5468993, 5635183, 5806885, 5984365, 6167907, 6357813, 6554410,
+	6758046, 6969099, 7187971, 7415099, 7650952, 7896040, 8150911, 8416161,
+	8692437, 8980441, 9280942, 9594772, 9922847, 10266166, 10625829, 11003044,
+	11399143, 11815599, 12254044, 12716289, 13204356, 13720498, 14267248, 14847451,
+};
+
+
+const q16_t dens_sh_q[DENS_SH_TS_N][DENS_SH_SSH_N] = {
+	{144992, 141922, 138999, 136212, 133551, 131009, 128577, 126246,
+	 124011, 121863, 119798, 117809, 115890, 114037, 112244, 110506,
+	 108820, 107181, 105585, 104028, 102507, 101019, 99560, 98127,
+	 96717, 95328, 93957, 92601, 91259, 89927, 88605, 87289},
+	{161051, 157644, 154401, 151310, 148360, 145542, 142847, 140265,
+	 137789, 135411, 133124, 130922, 128797, 126745, 124759, 122835,
+	 120967, 119151, 117382, 115656, 113969, 112317, 110697, 109105,
+	 107538, 105992, 104466, 102956, 101459, 99973, 98496, 97025},
+	{178561, 174785, 171191, 167768, 164503, 161384, 158402, 155546,
+	 152808, 150178, 147650, 145215, 142866, 140598, 138402, 136275,
+	 134209, 132200, 130242, 128332, 126464, 124634, 122838, 121073,
+	 119333, 117617, 115921, 114241, 112575, 110920, 109273, 107631},
+	{197620, 193439, 189463, 185677, 182066, 178620, 175325, 172171,
+	 169147, 166244, 163453, 160766, 158174, 155670, 153247, 150898,
+	 148618, 146399, 144237, 142126, 140061, 138037, 136050, 134094,
+	 132168, 130265, 128382, 126517, 124665, 122824, 120990, 119161},
+	{218328, 213706, 209312, 205130, 201144, 197340, 193705, 190226,
+	 186892, 183692, 180616, 177655, 174799, 172039, 169369, 166781,
+	 164267, 161821, 159437, 157108, 154828, 152594, 150398, 148237,
+	 146105, 143999, 141913, 139845, 137790, 135745, 133706, 131671},
+	{240793, 235688, 230838, 226224, 221829, 217637, 213632, 209801,
+	 206130, 202608, 199223, 195964, 192821, 189786, 186848, 184000,
+	 181233, 178541, 175915, 173350, 170839, 168375, 165953, 163567,
+	 161213, 158884, 156577, 154288, 152011, 149742, 147479, 145218},
+	{265122, 259490, 254144, 249060, 244220, 239606, 235199, 230986,
+	 226950, 223078, 219358, 215778, 212326, 208991, 205764, 202635,
+	 199595, 196635, 193749, 190928, 188164, 185452, 182785, 180155,
+	 177559, 174989, 172441, 169909, 167390, 164878, 162369, 159860},
+	{291428, 285223, 279336, 273741, 268418, 263345, 258503, 253875,
+	 249444, 245194, 241112, 237184, 233397, 229739, 226199, 222766,
+	 219431, 216183, 213015, 209917, 206881, 203900, 200966, 198072,
+	 195213, 192380, 189570, 186775, 183991, 181213, 178435, 175655},
+	{319829, 312999, 306523, 300373, 294525, 288955, 283642, 278565,
+	 273706, 269048, 264575, 260271, 256122, 252116, 248238, 244478,
+	 240824, 237265, 233792, 230395, 227065, 223793, 220571, 217391,
+	 214246, 211129, 208033, 204951, 201879, 198810, 195740, 192662},
+	{350444, 342934, 335818, 329066, 322648, 316540, 310716, 305154,
+	 299833, 294734, 289839, 285130, 280592, 276209, 271968, 267855,
+	 263857, 259964, 256162, 252442, 248794, 245208, 241674, 238184,
+	 234730, 231304, 227898, 224505, 221119, 217734, 214343, 210941},
+	{383397, 375147, 367337, 359931, 352897, 346205, 339829, 333743,
+	 327924, 322349, 316999, 311854, 306896, 302109, 297476, 292983,
+	 288616, 284361, 280206, 276139, 272148, 268222, 264352, 260527,
+	 256739, 252978, 249236, 245505, 241777, 238047, 234307, 230551},
+	{418817, 409763, 401198, 393083, 385382, 378060, 371088, 364436,
+	 358079, 351992, 346152, 340537, 335128, 329906, 324852, 319951,
+	 315187, 310544, 306008, 301567, 297206, 292915, 288682, 284496,
+	 280345, 276222, 272115, 268017, 263919, 259814, 255693, 251551},
+	{456833, 446906, 437523, 428641, 420217, 412215, 404599, 397338,
+	 390402, 383763, 377396, 371277, 365383, 359693, 354188, 348848,
+	 343657, 338597, 333652, 328808, 324051, 319366, 314742, 310165,
+	 305624, 301108, 296607, 292111, 287611, 283097, 278563, 273999},
+	{497583, 486707, 476438, 466724, 457520, 448782, 440472, 432555,
+	 424995, 417763, 410830, 404169, 397755, 391564, 385574, 379764,
+	 374115, 368608, 363224, 357948, 352764, 347656, 342610, 337612,
+	 332650, 327710, 322783, 317855, 312918, 307961, 302976, 297954},
+	{541204, 529299, 518069, 507456, 497409, 487878, 478821, 470196,
+	 461967, 454098, 446557, 439315, 432343, 425615, 419105, 412791,
+	 406651, 400664, 394810, 389071, 383428, 377864, 372365, 366914,
+	 361497, 356100, 350711, 345317, 339906, 334468, 328993, 323472},
+	{587840, 574819, 562549, 550964, 540006, 529620, 519758, 510373,
+	 501424, 492871, 484679, 476814, 469244, 461941, 454875, 448022,
+	 441357, 434856, 428497, 422261, 416126, 410074, 404087, 398148,
+	 392241, 386351, 380463, 374564, 368640, 362680, 356673, 350608},
+	{637638, 623407, 610011, 597376, 585435, 574129, 563400, 553199,
+	 543477, 534191, 525301, 516769, 508559, 500640, 492980, 485550,
+	 478322, 471272, 464373, 457604, 450941, 444365, 437854, 431391,
+	 424957, 418534, 412108, 405662, 399183, 392657, 386072, 379416},
+	{690750, 675207, 660593, 646824, 633824, 621526, 609866, 598788,
+	 588237, 578165, 568528, 559282, 550389, 541812, 533516, 525469,
+	 517641, 510002, 502526, 495187, 487959, 480820, 473748, 466720,
+	 459718, 452722, 445715, 438678, 431598, 424458, 417246, 409948},
+	{747333, 730369, 714437, 699443, 685302, 671937, 659277, 647256,
+	 635817, 624905, 614467, 604459, 594835, 585555, 576580, 567875,
+	 559405, 551139, 543046, 535096, 527264, 519522, 511846, 504213,
+	 496600, 488986, 481351, 473677, 465946, 458141, 450248, 442253},
+	{807548, 789044, 771687, 755372, 740002, 725489, 711754, 698724,
+	 686333, 674520, 663228, 652404, 642000, 631970, 622272, 612864,
+	 603710, 594773, 586020, 577419, 568939, 560551, 552228, 543945,
+	 535675, 527396, 519085, 510722, 502287, 493763, 485132, 476379},
+	{871563, 851390, 832494, 814753, 798059, 782312, 767423, 753311,
+	 739902, 727126, 714920, 703227, 691990, 681160, 670689, 660533,
+	 650648, 640996, 631539, 622241, 613069, 603990, 594974, 585992,
+	 577016, 568021, 558982, 549875, 540680, 531375, 521944, 512369},
+	{939551, 917571, 897011, 877733, 859612, 842539, 826413, 811142,
+	 796642, 782837, 769657, 757035, 744911, 733228, 721934, 710979,
+	 700317, 689902, 679694, 669652, 659740, 649921, 640162, 630431,
+	 620697, 610931, 601106, 591197, 581179, 571031, 560733, 550265},
+	{1011691, 987755, 965397, 944460, 924806, 906308, 888854, 872341,
+	 856676, 841772, 827550, 813939, 800869, 788278, 776108, 764303,
+	 752811, 741584, 730574, 719739, 709036, 698426, 687871, 677336,
+	 666787, 656193, 645522, 634746, 623840, 612779, 601541, 590105},
+	{1088172, 1062117, 1037815, 1015091, 993786, 973758, 954881, 937039,
+	 920127, 904050, 888718, 874052, 859975, 846417, 833314, 820604,
+	 808229, 796136, 784272, 772589, 761042, 749586, 738179, 726783,
+	 715359, 703872, 692290, 680580, 668714, 656665, 644408, 631923},
+	{1169189, 1140838, 1114437, 1089785, 1066704, 1045034, 1024631, 1005367,
+	 987124, 969794, 953279, 937488, 922339, 907753, 893657, 879984,
+	 866670, 853654, 840880, 828294, 815844, 803483, 791164, 778844,
+	 766481, 754035, 741471, 728753, 715850, 702732, 689373, 675748},
+	{1254948, 1224109, 1195439, 1168710, 1143718, 1120284, 1098247, 1077461,
+	 1057795, 1039129, 1021353, 1004366, 988075, 972394, 957243, 942546,
+	 928232, 914234, 900491, 886941, 873529, 860200, 846905, 833594,
+	 820222, 806745, 793123, 779318, 765295, 751021, 736467, 721608},
+	{1345662, 1312128, 1281006, 1252036, 1224990, 1199663, 1175875, 1153462,
+	 1132276, 1112185, 1093065, 1074804, 1057300, 1040455, 1024182, 1008395,
+	 993018, 977976, 963199, 948622, 934182, 919820, 905479, 891106,
+	 876651, 862065, 847304, 832326, 817093, 801568, 785721, 769522},
+	{1441560, 1405104, 1371331, 1339946, 1310689, 1283331, 1257666, 1233513,
+	 1210705, 1189094, 1168543, 1148927, 1130132, 1112050, 1094584, 1077640,
+	 1061131, 1044977, 1029101, 1013429, 997892, 982424, 966965, 951454,
+	 935835, 920057, 904069, 887826, 871285, 854407, 837158, 819508},
+	{1542881, 1503256, 1466617, 1432627, 1400992, 1371453, 1343779, 1317765,
+	 1293225, 1269994, 1247919, 1226861, 1206693, 1187297, 1168563, 1150389,
+	 1132678, 1115342, 1098294, 1081454, 1064746, 1048098, 1031441, 1014709,
+	 997841, 980780, 963471, 945862, 927909, 909568, 890802, 871578},
+	{1649880, 1606817, 1567077, 1530277, 1496084, 1464204, 1434377, 1406373,
+	 1379985, 1355027, 1331330, 1308739, 1287112, 1266319, 1246238, 1226756,
+	 1207768, 1189173, 1170878, 1152793, 1134836, 1116925, 1098985, 1080945,
+	 1062736, 1044295, 1025561, 1006480, 987000, 967076, 946666, 1649880},
+	{1762828, 1716032, 1672937, 1633105, 1596159, 1561765, 1529632, 1499501,
+	 1471141, 1444342, 1418918, 1394695, 1371518, 1349240, 1327729, 1306858,
+	 1286511, 1266578, 1246954, 1227543, 1208252, 1188991, 1169678, 1150234,
+	 1130584, 1110658, 1090390, 1069719, 1048590, 1026952, 1004762, 1762828},
+	{1882015, 1831163, 1784435, 1741331, 1701420, 1664328, 1629725, 1597319,
+	 1566853, 1538093, 1510830, 1484873, 1460048, 1436193, 1413162, 1390815,
+	 1369024, 1347667, 1326629, 1305804, 1285087, 1264384, 1243601, 1222651,
+	 1201453, 1179928, 1158006, 1135619, 1112707, 1089215, 1065096, 1882015},
+	{2007753, 1952491, 1901827, 1855188, 1812086, 1772094, 1734843, 1700006,
+	 1667291, 1636441, 1607221, 1579419, 1552843, 1527314, 1502669, 1478754,
+	 1455427, 1432555, 1410011, 1387677, 1365439, 1343192, 1320834, 1298268,
+	 1275406, 1252161, 1228455, 1204215, 1179375, 1153876, 1127667, 2007753},
+	{2140376, 2080315, 2025382, 1974924, 1928383, 1885277, 1845189, 1807750,
+	 1772636, 1739557, 1708254, 1678490, 1650053, 1622745, 1596384, 1570803,
+	 1545844, 1521360, 1497212, 1473269, 1449406, 1425507, 1401461, 1377161,
+	 1352509, 1327411, 1301781, 1275540, 1248615, 1220943, 1192469, 2140376},
+	{2280246, 2214957, 2155393, 2100805, 2050557, 2004103, 1960972, 1920750,
+	 1883073, 1847619, 1814098, 1782248, 1751833, 1722634, 1694452, 1667100,
+	 1640406, 1614206, 1588348, 1562688, 1537090, 1511423, 1485567, 1459405,
+	 1432828, 1405734, 1378028, 1349624, 1320444, 1290418, 1259489, 2280246},
+	{2427756, 2356765, 2292170, 2233113, 2178866, 2128812, 2082417, 2039217,
+	 1998804, 1960817, 1924934, 1890865, 1858348, 1827140, 1797022, 1767788,
+	 1739248, 1711222, 1683542, 1656050, 1628596, 1601037, 1573239, 1545076,
+	 1516428, 1487182, 1457235, 1426494, 1394872, 1362296, 1328705, 2427756},
+	{2583331, 2506114, 2436050, 2372151, 2313589, 2259661, 2209764, 2163375,
+	 2120038, 2079350, 2040952, 2004523, 1969770, 1936428, 1904253, 1873018,
+	 1842513, 1812542, 1782920, 1753472, 1724033, 1694448, 1664568, 1634254,
+	 1603375, 1571808, 1539442, 1506172, 1471907, 1436568, 2583331, 2583331},
+	{2747439, 2663412, 2587394, 2518248, 2455024, 2396925, 2343267, 2293463,
+	 2247001, 2203432, 2162355, 2123413, 2086283, 2050672, 2016310, 1982947,
+	 1950353, 1918310, 1886616, 1855079, 1823517, 1791759, 1759644, 1727017,
+	 1693735, 1659665, 1624683, 1588678, 1551550, 1513214, 2747439, 2747439},
+	{2920587, 2829103, 2746596, 2671754, 2603490, 2540896, 2483198, 2429735,
+	 2379932, 2333287, 2289355, 2247739, 2208082, 2170058, 2133370, 2097744,
+	 2062926, 2028676, 1994771, 1961001, 1927167, 1893080, 1858563, 1823447,
+	 1787575, 1750802, 1712993, 1674026, 1633795, 1592210, 2920587, 2920587},
+	{3103337, 3003670, 2914080, 2833050, 2759333, 2691891, 2629850, 2572463,
+	 2519087, 2469158, 2422182, 2377719, 2335372, 2294782, 2255621, 2217587,
+	 2180399, 2143796, 2107532, 2071375, 2035107, 1998521, 1961423, 1923627,
+	 1884963, 1845270, 1804402, 1762227, 1718632, 1673520, 3103337, 3103337},
+	{3296303, 3187642, 3090310, 3002547, 2922921, 2850248, 2783534, 2721938,
+	 2664736, 2611301, 2561079, 2513583, 2468373, 2425053, 2383260, 2342663,
+	 2302952, 2263839, 2225054, 2186344, 2147469, 2108201, 2068326, 2027643,
+	 1985964, 1943115, 1898936, 1853284, 1806039, 1757098, 3296303, 3296303},
+	{3500168, 3381599, 3275789, 3180692, 3094658, 3016332, 2944587, 2878472,
+	 2817174, 2759990, 2706305, 2655577, 2607319, 2561093, 2516500, 2473172,
+	 2430771, 2388981, 2347503, 2306061, 2264389, 2222239, 2179377, 2135582,
+	 2090647, 2044383, 1996617, 1947195, 1895987, 1842886, 3500168, 3500168},
+	{3715686, 3586179, 3471068, 3367969, 3274975, 3190536, 3113368, 3042398,
+	 2976710, 2915518, 2858138, 2803964, 2752459, 2703139, 2655563, 2609327,
+	 2564059, 2519409, 2475053, 2430683, 2386012, 2340765, 2294686, 2247532,
+	 2199078, 2149118, 2097464, 2043949, 1988437, 1930815, 3715686, 3715686},
+	{3943694, 3802083, 3676748, 3564903, 3464341, 3373282, 3290266, 3214074,
+	 3143679, 3078199, 3016871, 2959023, 2904058, 2851442, 2800689, 2751353,
+	 2703025, 2655322, 2607886, 2560381, 2512488, 2463910, 2414363, 2363583,
+	 2311323, 2257358, 2201485, 2143527, 2083334, 3943694, 3943694, 3943694},
+	{4185129, 4030084, 3893486, 3772066, 3663262, 3565027, 3475694, 3393884,
+	 3318438, 3248368, 3182821, 3121051, 3062398, 3006270, 2952130, 2899490,
+	 2847897, 2796930, 2746197, 2695329, 2643977, 2591811, 2538524, 2483825,
+	 2427445, 2369138, 2308685, 2245895, 2180613, 4185129, 4185129, 4185129},
+	{4441035, 4271040, 4122005, 3990081, 3872287, 3766262, 3670101, 3582239,
+	 3501367, 3426380, 3356323, 3290367, 3227780, 3167907, 3110157, 3053991,
+	 2998910, 2944455, 2890191, 2835715, 2780642, 2724613, 2667288, 2608350,
+	 2547505, 2484486, 2419055, 2351010, 2280187, 4441035, 4441035, 4441035},
+	{4712585, 4525896, 4363093, 4219624, 4092007, 3977515, 3873965, 3779577,
+	 3692875, 3612615, 3537734, 3467307, 3400522, 3336655, 3275054, 3215124,
+	 3156319, 3098130, 3040083, 2981731, 2922656, 2862460, 2800773, 2737246,
+	 2671559, 2603421, 2532577, 2458809, 2381949, 4712585, 4712585, 4712585},
+	{5001099, 4795706, 4617618, 4461431, 4323063, 4199353, 4087796, 3986366,
+	 3893392, 3807478, 3727433, 3652227, 3580961, 3512832, 3447122, 3383174,
+	 3320387, 3258201, 3196096, 3133582, 3070196, 3005504, 2939099, 2870600,
+	 2799657, 2725953, 2649214, 2569210, 2485767, 5001099, 5001099, 5001099},
+	{5308068, 5081636, 4886532, 4716301, 4566144, 4432385, 4312142, 4203104,
+	 4103379, 4011395, 3925819, 3845505, 3769453, 3696775, 3626678, 3558438,
+	 3491392, 3424927, 3358467, 3291476, 3223445, 3153898, 3082386, 3008494,
+	 2931838, 2852076, 2768913, 2682105, 2591478, 5308068, 5308068, 5308068},
+	{5635183, 5384988, 5170876, 4985101, 4821990, 4677260, 4547582, 4430317,
+	 4323319, 4224816, 4133314, 4047536, 3966371, 3888836, 3814053, 3741226,
+	 3669625, 3598573, 3527439, 3455630, 3382590, 3307793, 3230748, 3150999,
+	 3068129, 2981767, 2891594, 2797358, 2698884, 5635183, 5635183, 5635183},
+	{5984365, 5707208, 5471794, 5268767, 5091397, 4934667, 4794730, 4668559,
+	 4553719, 4448209, 4350356, 4258732, 4172103, 4089380, 4009593, 3931863,
+	 3855385, 3779416, 3703259, 3626263, 3547815, 3467339, 3384293, 3298179,
+	 3208540, 3114977, 3017148, 2914793, 2807740, 5984365, 5984365, 5984365},
+	{6357813, 6049910, 5790534, 5568310, 5375207, 5205334, 5054226, 4918407,
+	 4795107, 4682064, 4577399, 4479519, 4387049, 4298784, 4213651, 4130678,
+	 4048980, 3967736, 3886180, 3803595, 3719305, 3632677, 3543116, 3450074,
+	 3353057, 3251628, 3145428, 3034188, 2917747, 6357813, 6357813, 6357813},
+	{6758046, 6414890, 6128456, 5884808, 5674314, 5490022, 5326736, 5180457,
+	 5048023, 4926878, 4814907, 4710331, 4611618, 4517433, 4426586, 4338008,
+	 4250718, 4163814, 4076451, 3987839, 3897234, 3803936, 3707294, 3606706,
+	 3501632, 3391602, 3276238, 3155265, 3028543, 6758046, 6758046, 6758046},
+	{7187971, 6804150, 6487035, 6219410, 5989649, 5789515, 5612942, 5455312,
+	 5313015, 5183152, 5063345, 4951601, 4846217, 4745706, 4648756, 4554182,
+	 4460904, 4367925, 4274314, 4179199, 4081759, 3981224, 3876877, 3768057,
+	 3654176, 3534731, 3409320, 3277675, 3139684, 7187971, 7187971, 7187971},
+	{7650953, 7219915, 6867858, 6573316, 6322169, 6104607, 5913522, 5743571,
+	 5590619, 5451377, 5323166, 5203754, 5091240, 4983976, 4880506, 4779521,
+	 4679829, 4580328, 4479991, 4377855, 4273014, 4164618, 4051876, 3934066,
+	 3810547, 3680777, 3544342, 3400982, 3250630, 7650952, 7650952, 7650952},
+	{8150911, 7664647, 7272613, 6947767, 6672835, 6436079, 6229134, 6045804,
+	 5881344, 5732016, 5594796, 5467183, 5347056, 5232585, 5122154, 5014317,
+	 4907755, 4801251, 4693672, 4583951, 4471089, 4354145, 4232250, 4104609,
+	 3970526, 3829423, 3680874, 3524642, 3360724, 8150911, 8150911, 8150911},
+	{8692437, 8141056, 7703066, 7344005, 7042578, 6784663, 6560383, 6362529,
+	 6185645, 6025476, 5878609, 5742234, 5613986, 5491829, 5373973, 5258815,
+	 5144899, 5030878, 4915497, 4797580, 4676017, 4549771, 4417881, 4279476,
+	 4133799, 3980239, 3818364, 3647977, 3469165, 8692437, 8692437, 8692437},
+	{9280941, 8652093, 8161016, 7763222, 7432243, 7150997, 6907774, 6694163,
+	 6503881, 6332075, 6174889, 6029167, 5892268, 5761927, 5636159, 5513189,
+	 5391403, 5269314, 5145531, 5018751, 4887746, 4751366, 4608551, 4458344,
+	 4299928, 4132656, 3956107, 3770144, 3574979, 3371242, 9280942, 9280942},
+	{9922846, 9200916, 8648213, 8206476, 7842517, 7535551, 7271648, 7040967,
+	 6836260, 6651989, 6483789, 6328116, 6182021, 6042982, 5908797, 5777499,
+	 5647303, 5516559, 5383728, 5247364, 5106103, 4958674, 4803902, 4640741,
+	 4468307, 4285927, 4093206, 3890096, 3676985, 3454770, 3224928, 9922847},
+	{10625829, 9790809, 9166234, 8674565, 8273806, 7938527, 7652091, 7402964,
+	 7182769, 6985182, 6805262, 6639028, 6483184, 6334924, 6191805, 6051647,
+	 5912472, 5772453, 5629881, 5483150, 5330748, 5171260, 5003390, 4825992,
+	 4638116, 4439073, 4228517, 4006535, 3773752, 3531419, 3281486, 3026610},
+	{11399143, 10425007, 9716263, 9167837, 8726080, 8359712, 8048808, 7779822,
+	 7543067, 7331315, 7138975, 6961577, 6795437, 6637437, 6484863, 6335302,
+	 6186561, 6036613, 5883561, 5725620, 5561106, 5388450, 5206218, 5013157,
+	 4808254, 4590820, 4360593, 4117855, 3863553, 3599404, 3327958, 3052576},
+	{12254044, 11106380, 10298762, 9685904, 9198629, 8798285, 8460950, 8170705,
+	 7916344, 7689613, 7484189, 7295054, 7118099, 6949856, 6787317, 6627808,
+	 6468899, 6308341, 6144026, 5973966, 5796286, 5609243, 5411251, 5200944,
+	 4977253, 4739516, 4487606, 4222079, 3944319, 3656652, 3362382, 3065716},
+	{13204355, 11836840, 10912942, 10227231, 9689738, 9252535, 8886878, 8574062,
+	 8301140, 8058699, 7839599, 7638218, 7449978, 7271031, 7098043, 6928056,
+	 6758374, 6586504, 6410100, 6226948, 6034959, 5832192, 5616898, 5387595,
+	 5143172, 4883032, 4607257, 4316788, 4013596, 3700790, 3382612, 3064263},
+	{14267249, 12616293, 11555960, 10788549, 10196231, 9719498, 9323850, 8987354,
+	 8695094, 8436364, 8203125, 7989097, 7789192, 7599146, 7415277, 7234310,
+	 7053264, 6869368, 6680015, 6482736, 6275203, 6055255, 5820967, 5570742,
+	 5303456, 5018637, 4716674, 4399047, 4068505, 3729158, 3386382, 3046498},
+};
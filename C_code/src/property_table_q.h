@@ -0,0 +1,58 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		property_table_q.h
+ *
+ * \brief		Lookup tables of R410A gas density for the fixed-point prediction.
+ * \brief		The tables are generated from refrigerant_property.c by
+ * \brief		tools/gen_property_table_q.c, see property_table_q.c.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _PROPERTY_TABLE_Q_H_   	        			// Re-include guard
+#define _PROPERTY_TABLE_Q_H_	    		        	// Re-include guard
+
+#include "sensor_predict_q.h"
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief		Grid of the tables. The steps are powers of two so an index is a shift.
+ */
+//-------------------------------------------------------------------------------------------------
+#define DENS_SAT_TS_MIN		(-64)	// saturation temperature of the first entry in ℃
+#define DENS_SAT_TS_SHIFT	(0)		// step of saturation temperature 2^0 = 1 ℃
+#define DENS_SAT_N			(128)
+
+#define DENS_SH_TS_MIN		(-64)	// saturation temperature of the first row in ℃
+#define DENS_SH_TS_SHIFT	(1)		// step of saturation temperature 2^1 = 2 ℃
+#define DENS_SH_TS_N		(64)
+#define DENS_SH_SSH_SHIFT	(2)		// step of superheat 2^2 = 4 ℃, first column is 0 ℃
+#define DENS_SH_SSH_N		(32)
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \var     dens_sat_q[]
+ * \brief   Density of saturated gas in kg/m^3 (Q16.16) by saturation temperature.
+ */
+//-------------------------------------------------------------------------------------------------
+extern const q16_t dens_sat_q[DENS_SAT_N];
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \var     dens_sh_q[][]
+ * \brief   Density of superheated gas in kg/m^3 (Q16.16) by saturation temperature and superheat.
+ */
+//-------------------------------------------------------------------------------------------------
+extern const q16_t dens_sh_q[DENS_SH_TS_N][DENS_SH_SSH_N];
+
+#endif                                      // re-include guard
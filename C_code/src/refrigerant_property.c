@@ -15,6 +15,7 @@
 //*************************************************************************
 //*************************************************************************
 #include "refrigerant_property.h"
+#include "sensor_prof.h"
 #include <stdio.h>
 #include <math.h>
 
@@ -46,7 +47,12 @@ static const double COE[] = {	0.0169347786859482,			-0.0000391263315032514,		0.0
 //-------------------------------------------------------------------------------------------------
 float cal_t_sat(float p)
 {
-	return -2107.935 / (log(p*1000)-21.8205)-256.2377;
+	float t_sat;
+	SENSOR_PROF_BEGIN();
+
+	t_sat = -2107.935 / (log(p*1000)-21.8205)-256.2377;
+	SENSOR_PROF_END(SENSOR_PROF_T_SAT);
+	return t_sat;
 }
 
 
@@ -66,11 +72,31 @@ float cal_t_sat(float p)
 */
 //-------------------------------------------------------------------------------------------------
 float cal_h_sat_gas(float p)
+{
+	/* Calculated saturation temperature */
+	return cal_h_sat_gas_ts(cal_t_sat(p));
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_h_sat_gas_ts()
+ *
+ * \brief		Calculated Saturated gas Enthalpy from a known saturation temperature.
+ *				h_sat_gas = 280998.3+332.614*t_sat-4.699265*t_sat^2-51.2569*10^(-3)*t_sat^3
+ *
+ * \param[in]	ts = saturation temperature in ℃, as returned by cal_t_sat().
+ *
+ * \return		Enthalpy of saturated gas in kJ/kg.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_h_sat_gas_ts(float ts)
 {
 	double t_sat, h_sat_gas;
 
-	/* Calculated saturation temperature */
-	t_sat = cal_t_sat(p);
+	t_sat = ts;
 	/* Calculated Saturated gas Enthalpy */
 	h_sat_gas = 280998.3+332.614*t_sat-4.699265*pow(t_sat,2)-51.2569*pow(10,-3)*pow(t_sat,3);
 
@@ -99,12 +125,39 @@ float cal_h_sat_gas(float p)
 //-------------------------------------------------------------------------------------------------
 float cal_h_sh_gas(float p, float t)
 {
-	double t_sat, h_sat_gas, h_sh_gas;
+	float t_sat, h_sh_gas;
+	SENSOR_PROF_BEGIN();
 
 	/* Calculated saturation temperature */
 	t_sat = cal_t_sat(p);
-	/* Calculated Saturated gas Enthalpy */
-	h_sat_gas = cal_h_sat_gas(p);
+
+	h_sh_gas = cal_h_sh_gas_ts(t_sat, cal_h_sat_gas_ts(t_sat), t);
+	SENSOR_PROF_END(SENSOR_PROF_H_SH_GAS);
+	return h_sh_gas;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_h_sh_gas_ts()
+ *
+ * \brief		Calculated Enthalpy of superheated gas from a known saturation state.
+ *
+ * \param[in]	ts = saturation temperature in ℃, as returned by cal_t_sat().
+ * \param[in]	hs = enthalpy of saturated gas in kJ/kg, as returned by cal_h_sat_gas().
+ * \param[in]	t = Gas temperature in ℃.
+ *
+ * \return		Enthalpy of superheated gas in kJ/kg.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_h_sh_gas_ts(float ts, float hs, float t)
+{
+	double t_sat, h_sat_gas, h_sh_gas;
+
+	t_sat = ts;
+	h_sat_gas = hs;
 	/* Calculated superheated gas Enthalpy */
 	h_sh_gas = 	(1 + 3.3247*pow(10,-3)*(t-t_sat)+3.62592*pow(10,-7)*pow((t-t_sat),2)
 					+ 30.40633*pow(10,-6)*(t-t_sat)*t_sat
@@ -133,11 +186,30 @@ float cal_h_sh_gas(float p, float t)
  */
 //-------------------------------------------------------------------------------------------------
 float cal_vol_sat_gas(float p)
+{
+	/* Calculated saturation temperature */
+	return cal_vol_sat_gas_ts(cal_t_sat(p));
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_vol_sat_gas_ts()
+ *
+ * \brief		Calculated Saturated gas specific volume from a known saturation temperature.
+ *
+ * \param[in]	ts = saturation temperature in ℃, as returned by cal_t_sat().
+ *
+ * \return		Saturated gas specific volume in m^3/s.
+ */
+//-------------------------------------------------------------------------------------------------
+float cal_vol_sat_gas_ts(float ts)
 {
 	double t_sat, v_sat_gas;
 
-	/* Calculated saturation temperature */
-	t_sat = cal_t_sat(p);
+	t_sat = ts;
 	/* Calculated Saturated gas specific volume */
 	v_sat_gas = exp((-11.93809+1873.567/(t_sat+273.15))) * (5.24253-369.32461*pow(10,(-4))*
  						t_sat+111.95294*pow(10,(-6))*pow(t_sat,2)-31.84587*pow(10,(-7))*pow(t_sat,3));
@@ -162,11 +234,31 @@ float cal_vol_sat_gas(float p)
  */
 //-------------------------------------------------------------------------------------------------
 float cal_dens_sh_gas(float p, float t)
+{
+	/* Calculated saturation temperature */
+	return cal_dens_sh_gas_ts(cal_t_sat(p), t);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_dens_sh_gas_ts()
+ *
+ * \brief		Calculated density of superheated gas from a known saturation temperature.
+ *
+ * \param[in]	ts = saturation temperature in ℃, as returned by cal_t_sat().
+ * \param[in]	t = Gas temperature in ℃.
+ *
+ * \return		Density of superheated gas in kg/m^3.
+ */
+//-------------------------------------------------------------------------------------------------
+float cal_dens_sh_gas_ts(float ts, float t)
 {
 	double t_sat, t_sat_f, dens_sat_gas, coe_A, coe_B, coe_C, coe_D, y, dens_sh_gas;
 
-	/* Calculated saturation temperature */
-	t_sat = cal_t_sat(p);
+	t_sat = ts;
 	t_sat_f = t_sat+273.15;
 	/* Calculated Density of Saturated gas */
 	dens_sat_gas = pow((1/(exp((-11.93809+1873.567/(t_sat+273.15)))*(5.24253-369.32461*pow(10,(-4)) *
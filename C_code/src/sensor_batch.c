@@ -0,0 +1,152 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		sensor_batch.c
+ *
+ * \brief		Batch entry points of the model. The rows go through estimator_step(), so
+ * \brief		runs of equal inputs are solved once.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "sensor_batch.h"
+#include "sensor_predict.h"
+#include "compressor_model.h"
+#include "refrigerant_property.h"
+#include <stddef.h>
+#include <math.h>
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			batch_at()
+ *
+ * \brief		Row i of a column as float.
+*/
+//-------------------------------------------------------------------------------------------------
+static float batch_at(batch_col_t c, long i)
+{
+	return (float)c.v[i * c.stride];
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			batch_init()
+ *
+ * \brief		Estimator context with the constants of a batch.
+ *
+ * \return		factor from the speed column to the speed of the model.
+*/
+//-------------------------------------------------------------------------------------------------
+static float batch_init(estimator_ctx_t *ctx, const batch_cfg_t *cfg)
+{
+	estimator_params_t params;
+
+	estimator_init(ctx);
+	estimator_default_params(&params);
+	params.fw = cfg->fw;
+	if (cfg->coe != NULL)
+		params.coe = cfg->coe;
+	estimator_set_params(ctx, &params);
+
+	/* the model divides by COMPSPEED_RATED */
+	if ((cfg->comp_speed_rated > 0) && (cfg->comp_speed_rated != COMPSPEED_RATED))
+		return (float)(COMPSPEED_RATED / cfg->comp_speed_rated);
+	return 1;
+}
+
+
+long batch_tdis(const batch_cfg_t *cfg, long n, batch_col_t p_dis, batch_col_t p_suc, batch_col_t comp_speed,
+				batch_col_t t_suc, double *t_dis)
+{
+	estimator_ctx_t ctx;
+	estimator_sample_t sample = {0};
+	estimator_outputs_t out;
+	float speed = batch_init(&ctx, cfg);
+	long unsolved = 0;
+
+	for (long i = 0; i < n; i++)
+	{
+		sample.p_dis_g = (float)(batch_at(p_dis, i) - BATCH_P_ATM);
+		sample.p_suc_g = (float)(batch_at(p_suc, i) - BATCH_P_ATM);
+		sample.compSpeed = batch_at(comp_speed, i) * speed;
+		sample.t_suc = batch_at(t_suc, i);
+		estimator_step(&ctx, &sample, EST_OUT_TDIS, &out);
+		if (out.not_converged & EST_OUT_TDIS)
+		{
+			t_dis[i] = NAN;
+			unsolved++;
+		}
+		else
+			t_dis[i] = out.t_dis;
+	}
+	return unsolved;
+}
+
+
+long batch_pdis_temp(const batch_cfg_t *cfg, long n, batch_col_t t_dis, batch_col_t p_suc, batch_col_t comp_speed,
+					 batch_col_t t_suc, double *p_dis)
+{
+	estimator_ctx_t ctx;
+	estimator_sample_t sample = {0};
+	estimator_outputs_t out;
+	float speed = batch_init(&ctx, cfg);
+	long unsolved = 0;
+
+	for (long i = 0; i < n; i++)
+	{
+		sample.t_dis = batch_at(t_dis, i);
+		sample.p_suc_g = (float)(batch_at(p_suc, i) - BATCH_P_ATM);
+		sample.compSpeed = batch_at(comp_speed, i) * speed;
+		sample.t_suc = batch_at(t_suc, i);
+		estimator_step(&ctx, &sample, EST_OUT_PDIS_TEMP, &out);
+		if (!(out.valid & EST_OUT_PDIS_TEMP))
+			p_dis[i] = NAN;
+		else
+			p_dis[i] = out.p_dis_temp + BATCH_P_ATM;
+		if (!(out.valid & EST_OUT_PDIS_TEMP) || (out.not_converged & EST_OUT_PDIS_TEMP))
+			unsolved++;
+	}
+	return unsolved;
+}
+
+
+long batch_pdis_curr(const batch_cfg_t *cfg, long n, batch_col_t p_suc, batch_col_t I_test, batch_col_t comp_speed,
+					 batch_col_t U, double *p_dis)
+{
+	estimator_ctx_t ctx;
+	estimator_sample_t sample = {0};
+	estimator_outputs_t out;
+	float speed = batch_init(&ctx, cfg);
+	long unsolved = 0;
+
+	for (long i = 0; i < n; i++)
+	{
+		sample.p_suc_g = (float)(batch_at(p_suc, i) - BATCH_P_ATM);
+		sample.I_test = batch_at(I_test, i);
+		sample.compSpeed = batch_at(comp_speed, i) * speed;
+		sample.U = batch_at(U, i);
+		estimator_step(&ctx, &sample, EST_OUT_PDIS_CURR, &out);
+		p_dis[i] = out.p_dis_curr + BATCH_P_ATM;
+		if (out.not_converged & EST_OUT_PDIS_CURR)
+			unsolved++;
+	}
+	return unsolved;
+}
+
+
+void batch_density(long n, batch_col_t p, batch_col_t t, double *dens)
+{
+	for (long i = 0; i < n; i++)
+	{
+		dens[i] = cal_dens_sh_gas(batch_at(p, i), batch_at(t, i));
+	}
+}
@@ -0,0 +1,139 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		sensor_batch.h
+ *
+ * \brief		Batch entry points of the model for callers outside the controller, e.g. the
+ * \brief		Python reference through ctypes (sensor_native.py). Every function runs one
+ * \brief		output over n rows of double columns with the conventions of the Python
+ * \brief		reference: absolute pressures in kPa, fw, rated speed and coefficients per call.
+ * \brief		A column is a pointer and a stride in elements, so numpy arrays and pandas
+ * \brief		columns are read where they are, and stride 0 repeats one value for all rows.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _SENSOR_BATCH_H_   	        				// Re-include guard
+#define _SENSOR_BATCH_H_	    		        		// Re-include guard
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define BATCH_P_ATM			(101.35)	// kPa, gage pressure = absolute pressure - BATCH_P_ATM
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		batch_col_t
+ * \brief		Input column, row i is v[i*stride].
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	const double *v;
+	long stride;		// in elements, 0 for one value for every row
+} batch_col_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		batch_cfg_t
+ * \brief		Model constants of a batch, see estimator_params_t.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	double fw;					// fraction of the power which heats the gas, FW
+	double comp_speed_rated;	// rated speed, in the unit of the speed column, 0 for COMPSPEED_RATED
+	const float *coe;			// COMP_COE_N coefficients of the compressor, NULL for COE_32
+} batch_cfg_t;
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			batch_tdis()
+ *
+ * \brief		Discharge gas temperature, see pred_Tdis().
+ *
+ * \param[in]	cfg = model constants.
+ * \param[in]	n = number of rows.
+ * \param[in]	p_dis = discharge pressure in kPa (absolute).
+ * \param[in]	p_suc = suction pressure in kPa (absolute).
+ * \param[in]	comp_speed = compressor speed.
+ * \param[in]	t_suc = suction temperature in ℃.
+ * \param[out]	t_dis = n temperatures in ℃, NaN without a root.
+ *
+ * \return		number of rows without a root.
+*/
+//-------------------------------------------------------------------------------------------------
+long batch_tdis(const batch_cfg_t *cfg, long n, batch_col_t p_dis, batch_col_t p_suc, batch_col_t comp_speed,
+				batch_col_t t_suc, double *t_dis);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			batch_pdis_temp()
+ *
+ * \brief		Discharge gas pressure from the discharge temperature, see pred_Pdis_temp().
+ *
+ * \param[in]	cfg = model constants.
+ * \param[in]	n = number of rows.
+ * \param[in]	t_dis = discharge temperature in ℃.
+ * \param[in]	p_suc = suction pressure in kPa (absolute).
+ * \param[in]	comp_speed = compressor speed.
+ * \param[in]	t_suc = suction temperature in ℃.
+ * \param[out]	p_dis = n pressures in kPa (absolute), the best estimate if not converged, NaN
+ *				if the suction state is not valid.
+ *
+ * \return		number of rows not converged or without a value.
+*/
+//-------------------------------------------------------------------------------------------------
+long batch_pdis_temp(const batch_cfg_t *cfg, long n, batch_col_t t_dis, batch_col_t p_suc, batch_col_t comp_speed,
+					 batch_col_t t_suc, double *p_dis);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			batch_pdis_curr()
+ *
+ * \brief		Discharge gas pressure from the current of the compressor, see pred_Pdis_curr().
+ *
+ * \param[in]	cfg = model constants, fw is not used.
+ * \param[in]	n = number of rows.
+ * \param[in]	p_suc = suction pressure in kPa (absolute).
+ * \param[in]	I_test = current of the driver in A.
+ * \param[in]	comp_speed = compressor speed.
+ * \param[in]	U = voltage of the compressor in V.
+ * \param[out]	p_dis = n pressures in kPa (absolute), the best estimate if not converged.
+ *
+ * \return		number of rows not converged.
+*/
+//-------------------------------------------------------------------------------------------------
+long batch_pdis_curr(const batch_cfg_t *cfg, long n, batch_col_t p_suc, batch_col_t I_test, batch_col_t comp_speed,
+					 batch_col_t U, double *p_dis);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			batch_density()
+ *
+ * \brief		Density of superheated gas, see cal_dens_sh_gas().
+ *
+ * \param[in]	n = number of rows.
+ * \param[in]	p = pressure in kPa (absolute).
+ * \param[in]	t = gas temperature in ℃.
+ * \param[out]	dens = n densities in kg/m^3.
+*/
+//-------------------------------------------------------------------------------------------------
+void batch_density(long n, batch_col_t p, batch_col_t t, double *dens);
+
+#endif                                      // re-include guard
@@ -0,0 +1,768 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		sensor_predict_q.c
+ *
+ * \brief		Fixed-point prediction of the sensor, for controllers without FPU.
+ * \brief		Same model as sensor_predict.c, refrigerant_property.c and compressor_model.c.
+ * \brief		Units: pressure kPa, temperature ℃, enthalpy kJ/kg, power W, volume flow
+ * \brief		in units of the compressor map (m^3/s = vf * 4.719476965*10^(-4)/60).
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "sensor_predict_q.h"
+#include "property_table_q.h"
+#include "compressor_model.h"
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief		Model constants.
+ */
+//-------------------------------------------------------------------------------------------------
+#define FW_Q			Q16(0.8)								// same as FW
+#define P_ATM_Q			Q16(101.35)								// gage to absolute pressure
+#define LN2_Q30			QN(0.69314718055994531, 30)
+#define VF_TO_H_Q		Q16(60.0/4.719476965e-4/1000)			// 1/(m^3/s per vf unit)/(J per kJ)
+#define VF_MIN_Q		Q16(0.00000001*60/4.719476965e-4)		// 0.00000001 m^3/s
+#define COMPSPEED_RATED_Q	Q16(COMPSPEED_RATED)
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \const	COE_32_Q[]
+ * \brief   Coefficient of compressor model, same as COE_32[] in compressor_model.c.
+ */
+//-------------------------------------------------------------------------------------------------
+static const q16_t COE_32_Q[] = {	Q16(97.067),		Q16(-177.99),		Q16(297.6),			Q16(20.081),
+									Q16(11.098),		Q16(-1.8449),		Q16(0.44883),		Q16(0),
+									Q16(0),				Q16(0.65281),		Q16(0),				Q16(0),
+									Q16(0.096619),		Q16(-0.029134),		Q16(0.011636),		Q16(-0.11126),
+									Q16(0.073423),		Q16(-0.024061),		Q16(2.4395),		Q16(0.029512),
+									Q16(-119.08),		Q16(-85.79),		Q16(12.689)
+								};
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \const	H_SAT_Q32[], H_SH_A_Q48[], H_SH_B_Q48[]
+ * \brief   Polynomials of refrigerant_property.c in t_sat, lowest order first.
+ *			h_sat_gas = (280998.3+332.614*t_sat-4.699265*t_sat^2-51.2569*10^(-3)*t_sat^3)/1000
+ *			h_sh_gas = (1+A*(t-t_sat)+B*(t-t_sat)^2)*h_sat_gas
+ *			A = 3.3247*10^(-3)+30.40633*10^(-6)*t_sat+76.64206*10^(-8)*t_sat^2
+ *			B = 3.62592*10^(-7)-18.47693*10^(-8)*t_sat-60.2765*10^(-10)*t_sat^2
+ */
+//-------------------------------------------------------------------------------------------------
+static const int64_t H_SAT_Q32[] = {QN(280.9983, 32), QN(0.332614, 32), QN(-0.004699265, 32), QN(-0.0000512569, 32)};
+static const int64_t H_SH_A_Q48[] = {QN(3.3247e-3, 48), QN(30.40633e-6, 48), QN(76.64206e-8, 48)};
+static const int64_t H_SH_B_Q48[] = {QN(3.62592e-7, 48), QN(-18.47693e-8, 48), QN(-60.2765e-10, 48)};
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		comp_coe_q_t
+ * \brief		Intermediate coefficients of the compressor model, see comp_coe_t.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	q16_t a, b, c, d;	// Q16.16
+	int32_t e, f;		// Q2.30, |e|,|f| < 2
+	q16_t g;			// Q16.16, W
+} comp_coe_q_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		suction_state_q_t
+ * \brief		Properties of the suction gas, see suction_state_t in sensor_predict.c.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	q16_t p_suc;	// suction gas pressure in kPa_a(absolute pressure)
+	q16_t ssh;		// superheated of suction gas
+	q16_t dens_gas;	// density of scution gas.
+	q16_t h_suc;	// enthalpy of suction gas in kJ/kg
+} suction_state_q_t;
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			q16_mul()
+ *
+ * \brief		Q16.16 multiplication with 64 bit intermediate.
+*/
+//-------------------------------------------------------------------------------------------------
+static q16_t q16_mul(q16_t a, q16_t b)
+{
+	return (q16_t)(((int64_t)a * b) >> 16);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			q16_div()
+ *
+ * \brief		Q16.16 division with 64 bit intermediate, b must not be 0.
+*/
+//-------------------------------------------------------------------------------------------------
+static q16_t q16_div(q16_t a, q16_t b)
+{
+	return (q16_t)(((int64_t)a << 16) / b);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			isqrt64()
+ *
+ * \brief		Bitwise integer square root.
+*/
+//-------------------------------------------------------------------------------------------------
+static uint32_t isqrt64(uint64_t x)
+{
+	uint64_t res = 0, bit = (uint64_t)1 << 62;
+
+	while (bit > x)
+		bit >>= 2;
+	while (bit)
+	{
+		if (x >= res + bit)
+		{
+			x -= res + bit;
+			res = (res >> 1) + bit;
+		}
+		else
+			res >>= 1;
+		bit >>= 2;
+	}
+	return (uint32_t)res;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			poly_q()
+ *
+ * \brief		Horner evaluation of c[0]+c[1]*x+...+c[n-1]*x^(n-1).
+ *
+ * \param[in]	c = coefficients in any Q format, the result has the same format.
+ * \param[in]	n = number of coefficients.
+ * \param[in]	x = Q16.16 value.
+*/
+//-------------------------------------------------------------------------------------------------
+static int64_t poly_q(const int64_t *c, int n, q16_t x)
+{
+	int64_t acc = c[n-1];
+
+	for (int i = n-2; i >= 0; i--)
+		acc = ((acc * x) >> 16) + c[i];
+
+	return acc;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			q16_log2()
+ *
+ * \brief		Integer base 2 logarithm. The mantissa is normalized to [1,2) in Q2.30 and
+ *				the fraction bits are produced by repeated squaring.
+ *
+ * \param[in]	x = Q16.16 value, must be > 0.
+ *
+ * \return		log2(x) in Q16.16, INT32_MIN if x <= 0.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t q16_log2(q16_t x)
+{
+	uint64_t z;
+	q16_t y = 0;
+
+	if (x <= 0)
+		return INT32_MIN;
+
+	/* integer part, z in [1,2) Q2.30 */
+	z = (uint64_t)x << 14;
+	while (z >= ((uint64_t)2 << 30))
+	{
+		z >>= 1;
+		y += Q16_ONE;
+	}
+	while (z < ((uint64_t)1 << 30))
+	{
+		z <<= 1;
+		y -= Q16_ONE;
+	}
+
+	/* fraction part */
+	for (int i = 1; i <= 16; i++)
+	{
+		z = (z * z) >> 30;
+		if (z >= ((uint64_t)2 << 30))
+		{
+			z >>= 1;
+			y += Q16_ONE >> i;
+		}
+	}
+
+	return y;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			q16_exp2()
+ *
+ * \brief		Integer base 2 exponential. 2^frac by its degree 7 Taylor series in Q2.30,
+ *				then shifted by the integer part.
+ *
+ * \param[in]	x = Q16.16 value.
+ *
+ * \return		2^x in Q16.16, saturated to INT32_MAX.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t q16_exp2(q16_t x)
+{
+	static const int64_t EXP2_Q30[] = {	QN(1.0, 30),				QN(0.69314718055994531, 30),	QN(0.24022650695910071, 30),
+										QN(0.05550410866482158, 30),	QN(0.00961812910762848, 30),	QN(0.00133335581464284, 30),
+										QN(0.00015403530393381, 30),	QN(0.00001525273380405, 30)};
+	int32_t n = x >> 16;					// floor
+	q16_t frac = x & (Q16_ONE - 1);
+	int64_t m = poly_q(EXP2_Q30, 8, frac);	// 2^frac in Q2.30, [1,2)
+
+	n -= 14;								// Q2.30 to Q16.16
+	if (n >= 0)
+	{
+		if (n > 1)
+			return INT32_MAX;
+		m <<= n;
+		return (m > INT32_MAX) ? INT32_MAX : (q16_t)m;
+	}
+	if (n < -62)
+		return 0;
+	return (q16_t)((m + ((int64_t)1 << (-n - 1))) >> -n);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			q16_sqrt()
+ *
+ * \brief		Integer square root.
+ *
+ * \param[in]	x = Q16.16 value.
+ *
+ * \return		sqrt(x) in Q16.16, 0 if x <= 0.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t q16_sqrt(q16_t x)
+{
+	if (x <= 0)
+		return 0;
+	return (q16_t)isqrt64((uint64_t)x << 16);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			q16_pow()
+ *
+ * \brief		x^y = 2^(y*log2(x)) for x > 0.
+*/
+//-------------------------------------------------------------------------------------------------
+static q16_t q16_pow(q16_t x, q16_t y)
+{
+	return q16_exp2(q16_mul(y, q16_log2(x)));
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_t_sat_q()
+ *
+ * \brief		Calculated saturation temperature.
+ *				t_sat = -2107.935/(ln(pa*1000)-21.8205)-256.2377
+ *
+ * \param[in]	p = Pressure in kPa, Q16.16.
+ *
+ * \return		saturation temperature in ℃, Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+static q16_t cal_t_sat_q(q16_t p)
+{
+	q16_t ln_p;
+
+	/* ln(p*1000)-21.8205 = log2(p)*ln(2)+ln(1000)-21.8205 */
+	ln_p = (q16_t)(((int64_t)q16_log2(p) * LN2_Q30) >> 30);
+
+	return q16_div(Q16(-2107.935), ln_p + Q16(6.90775527898213705 - 21.8205)) - Q16(256.2377);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_h_sat_gas_q()
+ *
+ * \brief		Calculated Saturated gas Enthalpy in kJ/kg, Q16.16.
+ *
+ * \param[in]	ts = saturation temperature in ℃, Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+static q16_t cal_h_sat_gas_q(q16_t ts)
+{
+	return (q16_t)(poly_q(H_SAT_Q32, 4, ts) >> 16);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_h_sh_gas_q()
+ *
+ * \brief		Calculated Enthalpy of superheated gas in kJ/kg, Q16.16.
+ *
+ * \param[in]	ts = saturation temperature in ℃, Q16.16.
+ * \param[in]	hs = enthalpy of saturated gas in kJ/kg, Q16.16.
+ * \param[in]	t = Gas temperature in ℃, Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+static q16_t cal_h_sh_gas_q(q16_t ts, q16_t hs, q16_t t)
+{
+	q16_t dt = t - ts;
+	int64_t coe_A, coe_B, r;
+
+	coe_A = poly_q(H_SH_A_Q48, 3, ts);
+	coe_B = poly_q(H_SH_B_Q48, 3, ts);
+
+	/* r = (A+B*dt)*dt in Q32 */
+	r = (((coe_A + ((coe_B * dt) >> 16)) >> 16) * dt) >> 16;
+
+	return hs + (q16_t)(((int64_t)hs * r) >> 32);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			table_index()
+ *
+ * \brief		Cell and weight of a table lookup, x clamped to the table range.
+ *
+ * \param[in]	x = offset from the first grid point, Q16.16.
+ * \param[in]	shift = grid step 2^shift.
+ * \param[in]	n = grid points.
+ * \param[out]	i = index of the cell, 0...n-2.
+ * \param[out]	w = weight of point i+1, Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+static void table_index(q16_t x, int shift, int n, int *i, q16_t *w)
+{
+	if (x < 0)
+		x = 0;
+	if (x >= ((n-1) << (16 + shift)))
+		x = ((n-1) << (16 + shift)) - 1;
+	*i = x >> (16 + shift);
+	*w = (x >> shift) & (Q16_ONE - 1);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_dens_sat_gas_q()
+ *
+ * \brief		Density of saturated gas in kg/m^3 by linear interpolation of
+ *				property_table_q.c, ts clamped to the table range.
+ *
+ * \param[in]	ts = saturation temperature in ℃, Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+static q16_t cal_dens_sat_gas_q(q16_t ts)
+{
+	int i;
+	q16_t w;
+
+	table_index(ts - Q16(DENS_SAT_TS_MIN), DENS_SAT_TS_SHIFT, DENS_SAT_N, &i, &w);
+
+	return dens_sat_q[i] + q16_mul(dens_sat_q[i+1] - dens_sat_q[i], w);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_dens_sh_gas_q()
+ *
+ * \brief		Density of superheated gas in kg/m^3 by bilinear interpolation of
+ *				property_table_q.c, inputs clamped to the table range.
+ *
+ * \param[in]	ts = saturation temperature in ℃, Q16.16.
+ * \param[in]	ssh = superheat in ℃, Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+static q16_t cal_dens_sh_gas_q(q16_t ts, q16_t ssh)
+{
+	int i, j;
+	q16_t wi, wj, d0, d1;
+
+	table_index(ts - Q16(DENS_SH_TS_MIN), DENS_SH_TS_SHIFT, DENS_SH_TS_N, &i, &wi);
+	table_index(ssh, DENS_SH_SSH_SHIFT, DENS_SH_SSH_N, &j, &wj);
+
+	d0 = dens_sh_q[i][j] + q16_mul(dens_sh_q[i][j+1] - dens_sh_q[i][j], wj);
+	d1 = dens_sh_q[i+1][j] + q16_mul(dens_sh_q[i+1][j+1] - dens_sh_q[i+1][j], wj);
+
+	return d0 + q16_mul(d1 - d0, wi);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_comp_coe_q()
+ *
+ * \brief		Calculated intermediate coefficients of the compressor model, see cal_comp_coe().
+*/
+//-------------------------------------------------------------------------------------------------
+static void cal_comp_coe_q(q16_t compSpeed, comp_coe_q_t *coe)
+{
+	const q16_t *k = COE_32_Q;
+	q16_t sr, sr_sqrt, sr2, sr4, y1, y2, p18, p19;
+
+	sr = q16_div(compSpeed, COMPSPEED_RATED_Q);
+	sr_sqrt = q16_sqrt(sr);
+	sr2 = q16_mul(sr, sr);
+	sr4 = q16_mul(sr2, sr2);
+
+	coe->a = k[0] + q16_mul(k[1], sr_sqrt) + q16_mul(k[2], sr);
+	coe->b = k[3] + q16_mul(k[4], sr2) + q16_mul(k[5], sr4);
+	coe->c = k[6] + q16_mul(k[7], sr) + q16_mul(k[8], sr2);
+	coe->d = k[9] + q16_mul(k[10], sr_sqrt) + q16_mul(k[11], sr);
+	y1 = k[12] + q16_mul(k[13], sr) + q16_mul(k[14], sr2);
+	y2 = k[15] + q16_mul(k[16], sr) + q16_mul(k[17], sr2);
+	p18 = q16_pow(k[18], coe->d);
+	p19 = q16_pow(k[19], coe->d);
+	coe->f = (int32_t)(((int64_t)(y1 - y2) << 30) / (p18 - p19));
+	coe->e = (int32_t)(((int64_t)y1 << 14) - (((int64_t)coe->f * p18) >> 16));
+	coe->g = k[20] + q16_mul(k[21], sr2) + q16_mul(k[22], sr4);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_volume_flow_rate_q()
+ *
+ * \brief		Calculated volume flow rate a-b*pr^c in units of the compressor map, Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+static q16_t cal_volume_flow_rate_q(const comp_coe_q_t *coe, q16_t pr)
+{
+	q16_t vf;
+
+	vf = coe->a - q16_mul(coe->b, q16_pow(pr, coe->c));
+
+	return (vf < VF_MIN_Q) ? VF_MIN_Q : vf;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_power_q()
+ *
+ * \brief		Calculated power (e+f*pr^d)*ps*0.145*vf+g in W, Q16.16 in 64 bit.
+*/
+//-------------------------------------------------------------------------------------------------
+static int64_t cal_power_q(const comp_coe_q_t *coe, q16_t pr, q16_t ps, q16_t vf)
+{
+	int64_t ef, ps_vf, power;
+
+	ef = coe->e + (((int64_t)coe->f * q16_pow(pr, coe->d)) >> 16);	// Q2.30
+	ps_vf = ((((int64_t)ps * QN(0.000145*1000, 30)) >> 30) * vf) >> 16;	// Q16.16
+	power = (((ef >> 8) * ps_vf) >> 22) + coe->g;
+
+	return (power < 0) ? 0 : power;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_h_dis_q()
+ *
+ * \brief		Calculated enthalpy of discharge gas in kJ/kg, h_suc+power*fw/mr.
+*/
+//-------------------------------------------------------------------------------------------------
+static q16_t cal_h_dis_q(const suction_state_q_t *suc, const comp_coe_q_t *coe, q16_t p_dis, q16_t fw)
+{
+	q16_t pr, vf;
+	int64_t power, mr;
+
+	pr = q16_div(p_dis, suc->p_suc);
+	vf = cal_volume_flow_rate_q(coe, pr);
+	power = cal_power_q(coe, pr, suc->p_suc, vf);
+	mr = ((int64_t)vf * suc->dens_gas) >> 16;
+	if (mr <= 0)
+		mr = 1;
+
+	return suc->h_suc + (q16_t)((((power * fw) >> 16) * VF_TO_H_Q) / mr);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_suction_state_q()
+ *
+ * \brief		Calculated properties of the suction gas.
+*/
+//-------------------------------------------------------------------------------------------------
+static void cal_suction_state_q(q16_t p_suc_g, q16_t t_suc, suction_state_q_t *suc)
+{
+	q16_t ts_suc, hs_suc;
+
+	suc->p_suc = p_suc_g + P_ATM_Q;
+	ts_suc = cal_t_sat_q(suc->p_suc);
+	suc->ssh = t_suc - ts_suc;
+	hs_suc = cal_h_sat_gas_q(ts_suc);
+	if (suc->ssh > Q16_ONE)
+	{
+		suc->dens_gas = cal_dens_sh_gas_q(ts_suc, suc->ssh);
+		suc->h_suc = cal_h_sh_gas_q(ts_suc, hs_suc, t_suc);
+	}
+	else
+	{
+		suc->dens_gas = cal_dens_sat_gas_q(ts_suc);
+		suc->h_suc = hs_suc;
+	}
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Tdis_q()
+ *
+ * \brief		Predict temperature of discharge gas, fixed-point version of pred_Tdis().
+ *				h_sh_gas(p_dis, t_dis) = h_dis is a quadratic in dt = t_dis-ts_dis:
+ *				B*dt^2+A*dt-k = 0 with k = h_dis/hs_dis-1, solved as dt = 2k/(A+sqrt(A^2+4Bk)).
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	t_suc = suction gas temperature in ℃, Q16.16.
+ * \param[in]	p_dis_g = discharge gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	compSpeed = compressor speed in rpm, Q16.16.
+ *
+ * \return		discharge gas temperature in ℃, Q16.16, Q16(TDIS_NO_ROOT_VALUE) if there is no
+ *				solution.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t pred_Tdis_q(q16_t p_suc_g, q16_t t_suc, q16_t p_dis_g, q16_t compSpeed)
+{
+	q16_t t_dis;
+
+	pred_Tdis_q_status(p_suc_g, t_suc, p_dis_g, compSpeed, &t_dis);
+	return t_dis;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Tdis_q_status()
+ *
+ * \brief		Predict temperature of discharge gas and report whether the quadratic has a
+ *				root, fixed-point version of pred_Tdis_status().
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	t_suc = suction gas temperature in ℃, Q16.16.
+ * \param[in]	p_dis_g = discharge gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	compSpeed = compressor speed in rpm, Q16.16.
+ * \param[out]	t_dis = discharge gas temperature in ℃, Q16.16, Q16(TDIS_NO_ROOT_VALUE) if there
+ *				is no root.
+ *
+ * \return		TDIS_OK or TDIS_NO_ROOT.
+*/
+//-------------------------------------------------------------------------------------------------
+tdis_status_t pred_Tdis_q_status(q16_t p_suc_g, q16_t t_suc, q16_t p_dis_g, q16_t compSpeed, q16_t *t_dis)
+{
+	suction_state_q_t suc;
+	comp_coe_q_t coe;
+	q16_t p_dis, ts_dis, hs_dis, h_dis, z_fw;
+	int64_t k, coe_A, coe_B, disc, den;
+
+	p_dis = p_dis_g + P_ATM_Q;
+	cal_suction_state_q(p_suc_g, t_suc, &suc);
+	cal_comp_coe_q(compSpeed, &coe);
+
+	/* Calculated enthalpy of discharge gas */
+	if (suc.ssh < 2*Q16_ONE)
+		z_fw = q16_mul(Q16(0.2), suc.ssh) + Q16(0.6);
+	else
+		z_fw = Q16_ONE;
+	h_dis = cal_h_dis_q(&suc, &coe, p_dis, q16_mul(FW_Q, z_fw));
+
+	/* quadratic in dt, Q4.28 */
+	ts_dis = cal_t_sat_q(p_dis);
+	hs_dis = cal_h_sat_gas_q(ts_dis);
+	k = ((int64_t)(h_dis - hs_dis) << 28) / hs_dis;
+	coe_A = poly_q(H_SH_A_Q48, 3, ts_dis) >> 20;
+	coe_B = poly_q(H_SH_B_Q48, 3, ts_dis);
+	disc = coe_A * coe_A + ((coe_B * k) >> 18);		// Q56, 4*B*k = (B<<2)*k
+	if (disc < 0)
+	{
+		*t_dis = Q16(TDIS_NO_ROOT_VALUE);
+		return TDIS_NO_ROOT;
+	}
+	den = coe_A + isqrt64((uint64_t)disc);
+	if (den <= 0)
+	{
+		*t_dis = Q16(TDIS_NO_ROOT_VALUE);
+		return TDIS_NO_ROOT;
+	}
+
+	*t_dis = ts_dis + (q16_t)(((2 * k) << 16) / den);
+	return TDIS_OK;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_temp_q()
+ *
+ * \brief		Predict pressure of discharge gas by temperature, fixed-point version of
+ *				pred_Pdis_temp(). The bisection also stops when the bracket is one LSB wide.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	t_suc = suction gas temperature in ℃, Q16.16.
+ * \param[in]	t_dis = discharge gas temperature in ℃, Q16.16.
+ * \param[in]	compSpeed = compressor speed in rpm, Q16.16.
+ *
+ * \return		discharge gas pressure in kPa(gage pressure), Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t pred_Pdis_temp_q(q16_t p_suc_g, q16_t t_suc, q16_t t_dis, q16_t compSpeed)
+{
+	suction_state_q_t suc;
+	comp_coe_q_t coe;
+	q16_t pd_int1 = Q16(100), pd_int2 = Q16(4300), pd_int = 0;
+	q16_t h_dis, hd_int, ts_int, diff;
+
+	cal_suction_state_q(p_suc_g, t_suc, &suc);
+	cal_comp_coe_q(compSpeed, &coe);
+
+	for (int i = 0; i < 100 && (pd_int2 - pd_int1) > 1; i++)
+	{
+		pd_int = pd_int1 + ((pd_int2 - pd_int1) >> 1);
+
+		/* Calculated enthalpy of discharge gas */
+		h_dis = cal_h_dis_q(&suc, &coe, pd_int, FW_Q);
+
+		/* Calculated enthalpy of int discharge gas */
+		ts_int = cal_t_sat_q(pd_int);
+		hd_int = cal_h_sh_gas_q(ts_int, cal_h_sat_gas_q(ts_int), t_dis);
+
+		/* reset pd_int1 or pd_int2, 0.1 J/kg */
+		diff = hd_int - h_dis;
+		if ((diff < Q16(0.0001)) && (diff > -Q16(0.0001)))
+			break;
+		if (diff < 0)
+			pd_int2 = pd_int;
+		else
+			pd_int1 = pd_int;
+	}
+
+	return pd_int - P_ATM_Q;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_curr_q()
+ *
+ * \brief		Predict pressure of discharge gas by current, fixed-point version of
+ *				pred_Pdis_curr().
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	I_test = the current of driver in amp, Q16.16.
+ * \param[in]	compSpeed = compressor speed in rpm, Q16.16.
+ * \param[in]	U = the voltage of compressor, Q16.16.
+ *
+ * \return		discharge gas pressure in kPa(gage pressure), Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t pred_Pdis_curr_q(q16_t p_suc_g, q16_t I_test, q16_t compSpeed, q16_t U)
+{
+	comp_coe_q_t coe;
+	q16_t Pd_int1 = Q16(100), Pd_int2 = Q16(4300), Pd_int = 0;
+	q16_t p_suc, pr, vf, I;
+
+	p_suc = p_suc_g + P_ATM_Q;
+	cal_comp_coe_q(compSpeed, &coe);
+
+	for (int i = 0; i < 20; i++)
+	{
+		Pd_int = Pd_int1 + ((Pd_int2 - Pd_int1) >> 1);
+
+		/* calculating current I */
+		if (U <= 0)
+			I = 0;
+		else
+		{
+			pr = q16_div(Pd_int, p_suc);
+			vf = cal_volume_flow_rate_q(&coe, pr);
+			I = (q16_t)((cal_power_q(&coe, pr, p_suc, vf) << 16) / U);
+		}
+		if ((I - I_test < Q16(0.001)) && (I - I_test > -Q16(0.001)))
+			break;
+		if (I < I_test)
+			Pd_int1 = Pd_int;
+		else
+			Pd_int2 = Pd_int;
+	}
+
+	return Pd_int - P_ATM_Q;
+}
@@ -0,0 +1,168 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		sensor_predict_q.h
+ *
+ * \brief		Fixed-point prediction of the sensor, for controllers without FPU.
+ * \brief		Integer only: no float operation and no libm call at run time.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _SENSOR_PREDICT_Q_H_   	        			// Re-include guard
+#define _SENSOR_PREDICT_Q_H_	    		        	// Re-include guard
+
+#include "sensor_predict.h"
+#include <stdint.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief		Q16.16 format. Q16() and QN() are for constants only, the compiler folds them.
+ */
+//-------------------------------------------------------------------------------------------------
+#define Q16_ONE			(65536)
+#define QN(x, n)		((int64_t)((x) * (double)((int64_t)1 << (n)) + (((x) >= 0) ? 0.5 : -0.5)))
+#define Q16(x)			((q16_t)QN(x, 16))
+#define Q16_TO_FLOAT(x)	((float)(x) / Q16_ONE)		// host side only
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+typedef int32_t q16_t;	// signed Q16.16, range +-32767.99998, resolution 1.5e-5
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum
+ * \brief
+ */
+//------------------------------------------------------------------------------------------------
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			q16_log2()
+ *
+ * \brief		Integer base 2 logarithm.
+ *
+ * \param[in]	x = Q16.16 value, must be > 0.
+ *
+ * \return		log2(x) in Q16.16, INT32_MIN if x <= 0.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t q16_log2(q16_t x);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			q16_exp2()
+ *
+ * \brief		Integer base 2 exponential.
+ *
+ * \param[in]	x = Q16.16 value.
+ *
+ * \return		2^x in Q16.16, saturated to INT32_MAX.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t q16_exp2(q16_t x);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			q16_sqrt()
+ *
+ * \brief		Integer square root.
+ *
+ * \param[in]	x = Q16.16 value.
+ *
+ * \return		sqrt(x) in Q16.16, 0 if x <= 0.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t q16_sqrt(q16_t x);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Tdis_q()
+ *
+ * \brief		Predict temperature of discharge gas, fixed-point version of pred_Tdis().
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	t_suc = suction gas temperature in ℃, Q16.16.
+ * \param[in]	p_dis_g = discharge gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	compSpeed = compressor speed in rpm, Q16.16.
+ *
+ * \return		discharge gas temperature in ℃, Q16.16, Q16(TDIS_NO_ROOT_VALUE) if there is no
+ *				solution.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t pred_Tdis_q(q16_t p_suc_g, q16_t t_suc, q16_t p_dis_g, q16_t compSpeed);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Tdis_q_status()
+ *
+ * \brief		Fixed-point version of pred_Tdis_status().
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	t_suc = suction gas temperature in ℃, Q16.16.
+ * \param[in]	p_dis_g = discharge gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	compSpeed = compressor speed in rpm, Q16.16.
+ * \param[out]	t_dis = discharge gas temperature in ℃, Q16.16, Q16(TDIS_NO_ROOT_VALUE) if there
+ *				is no root.
+ *
+ * \return		TDIS_OK or TDIS_NO_ROOT.
+*/
+//-------------------------------------------------------------------------------------------------
+tdis_status_t pred_Tdis_q_status(q16_t p_suc_g, q16_t t_suc, q16_t p_dis_g, q16_t compSpeed, q16_t *t_dis);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_temp_q()
+ *
+ * \brief		Predict pressure of discharge gas by temperature, fixed-point version of
+ *				pred_Pdis_temp().
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	t_suc = suction gas temperature in ℃, Q16.16.
+ * \param[in]	t_dis = discharge gas temperature in ℃, Q16.16.
+ * \param[in]	compSpeed = compressor speed in rpm, Q16.16.
+ *
+ * \return		discharge gas pressure in kPa(gage pressure), Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t pred_Pdis_temp_q(q16_t p_suc_g, q16_t t_suc, q16_t t_dis, q16_t compSpeed);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_curr_q()
+ *
+ * \brief		Predict pressure of discharge gas by current, fixed-point version of
+ *				pred_Pdis_curr().
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure), Q16.16.
+ * \param[in]	I_test = the current of driver in amp, Q16.16.
+ * \param[in]	compSpeed = compressor speed in rpm, Q16.16.
+ * \param[in]	U = the voltage of compressor, Q16.16.
+ *
+ * \return		discharge gas pressure in kPa(gage pressure), Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+q16_t pred_Pdis_curr_q(q16_t p_suc_g, q16_t I_test, q16_t compSpeed, q16_t U);
+
+#endif                                      // re-include guard
@@ -0,0 +1,58 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		sensor_prof.h
+ *
+ * \brief		Execution time probes of the model. Without SENSOR_PROF the probes are empty;
+ * \brief		with it they record cycles through cycle_prof.h, which the target provides
+ * \brief		(Mini_VRV: Core/Inc/cycle_prof.h, DWT cycle counter).
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _SENSOR_PROF_H_								// Re-include guard
+#define _SENSOR_PROF_H_								// Re-include guard
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		sensor_prof_id_t
+ * \brief		Probes of the model.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	SENSOR_PROF_PRED_TDIS = 0,	// pred_Tdis()
+	SENSOR_PROF_EST_STEP,		// estimator_step()
+	SENSOR_PROF_SUCTION,		// suction gas properties, cal_suction_state()
+	SENSOR_PROF_COMP_COE,		// compressor coefficients, cal_comp_coe_k()
+	SENSOR_PROF_PDIS_TEMP,		// solver of the discharge pressure by temperature
+	SENSOR_PROF_PDIS_CURR,		// solver of the discharge pressure by current
+	SENSOR_PROF_T_SAT,			// cal_t_sat()
+	SENSOR_PROF_H_SH_GAS,		// cal_h_sh_gas(), once per iteration of the temperature solver
+	SENSOR_PROF_N
+} sensor_prof_id_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def			SENSOR_PROF_BEGIN(), SENSOR_PROF_END()
+ * \brief		SENSOR_PROF_BEGIN() after the declarations of a function, SENSOR_PROF_END(id)
+ *				before each return.
+ */
+//-------------------------------------------------------------------------------------------------
+#ifdef SENSOR_PROF
+#include "cycle_prof.h"
+#define SENSOR_PROF_BEGIN()		uint32_t sensor_prof_t0 = cycle_prof_now()
+#define SENSOR_PROF_END(id)		cycle_prof_record((id), cycle_prof_now() - sensor_prof_t0)
+#else
+#define SENSOR_PROF_BEGIN()
+#define SENSOR_PROF_END(id)		((void)0)
+#endif
+
+#endif                                      // re-include guard
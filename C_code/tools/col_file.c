@@ -0,0 +1,232 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		col_file.c
+ *
+ * \brief		Columnar binary cache of the logs for the host tools.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "col_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			col_size()
+ *
+ * \brief		Bytes of one value of a column type.
+ *
+ * \return		the size, 0 for an unknown type.
+*/
+//-------------------------------------------------------------------------------------------------
+static size_t col_size(uint32_t type)
+{
+	return (type == COL_I64) ? sizeof(int64_t) : (type == COL_F32) ? sizeof(float) : 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			col_align()
+ *
+ * \brief		Round a file offset up to the next COL_ALIGN boundary, where a column starts.
+*/
+//-------------------------------------------------------------------------------------------------
+static uint64_t col_align(uint64_t x)
+{
+	return (x + COL_ALIGN - 1) & ~(uint64_t)(COL_ALIGN - 1);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			col_read_all()
+ *
+ * \brief		Read the whole file into the heap, used where mmap is not available.
+*/
+//-------------------------------------------------------------------------------------------------
+static int col_read_all(col_file_t *f, const char *path)
+{
+	FILE *fp;
+	long size;
+	uint8_t *buf;
+
+	if ((fp = fopen(path, "rb")) == NULL)
+		return -1;
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if ((size <= 0) || ((buf = malloc(size)) == NULL) || (fread(buf, 1, size, fp) != (size_t)size))
+	{
+		if (size > 0)
+			free(buf);
+		fclose(fp);
+		return -1;
+	}
+	fclose(fp);
+
+	f->data = buf;
+	f->size = (size_t)size;
+	f->mapped = 0;
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			col_check()
+ *
+ * \brief		Validate header and descriptors against the file size.
+*/
+//-------------------------------------------------------------------------------------------------
+static int col_check(const col_file_t *f)
+{
+	const col_header_t *hdr = f->hdr;
+	uint64_t bytes;
+
+	if ((f->size < sizeof(col_header_t)) || (memcmp(hdr->magic, COL_MAGIC, sizeof(hdr->magic)) != 0) ||
+		(hdr->endian != COL_ENDIAN) || (hdr->n_cols > (f->size - sizeof(col_header_t)) / sizeof(col_desc_t)))
+	{
+		return 0;
+	}
+	for (uint32_t i = 0; i < hdr->n_cols; i++)
+	{
+		const col_desc_t *c = &f->cols[i];
+
+		if ((col_size(c->type) == 0) || (c->offset % COL_ALIGN) || (c->offset > f->size) ||
+			(memchr(c->name, '\0', COL_NAME_MAX) == NULL))
+		{
+			return 0;
+		}
+		bytes = hdr->n_rows * col_size(c->type);
+		if ((hdr->n_rows > f->size) || (bytes > f->size - c->offset))
+			return 0;
+	}
+	return 1;
+}
+
+
+int col_open(col_file_t *f, const char *path)
+{
+	memset(f, 0, sizeof(*f));
+
+#ifndef _WIN32
+	int fd;
+	struct stat st;
+	void *p = MAP_FAILED;
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return -1;
+	if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0))
+		p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (p != MAP_FAILED)
+	{
+		f->data = p;
+		f->size = (size_t)st.st_size;
+		f->mapped = 1;
+	}
+	else
+#endif
+	if (col_read_all(f, path) != 0)
+	{
+		return -1;
+	}
+
+	f->hdr = (const col_header_t *)f->data;
+	f->cols = (const col_desc_t *)(f->data + sizeof(col_header_t));
+	if (!col_check(f))
+	{
+		col_close(f);
+		return -2;
+	}
+	return 0;
+}
+
+
+const void *col_column(const col_file_t *f, const char *name, col_type_t type)
+{
+	for (uint32_t i = 0; i < f->hdr->n_cols; i++)
+	{
+		if ((f->cols[i].type == (uint32_t)type) && (strcmp(f->cols[i].name, name) == 0))
+			return f->data + f->cols[i].offset;
+	}
+	return NULL;
+}
+
+
+void col_close(col_file_t *f)
+{
+#ifndef _WIN32
+	if (f->mapped)
+		munmap((void *)f->data, f->size);
+	else
+#endif
+		free((void *)f->data);
+	memset(f, 0, sizeof(*f));
+}
+
+
+int col_write(const char *path, const char *const *names, const col_type_t *types,
+			  const void *const *columns, size_t n_cols, size_t n_rows)
+{
+	static const uint8_t zero[COL_ALIGN] = {0};
+	col_header_t hdr;
+	col_desc_t desc;
+	uint64_t pos, offset;
+	FILE *fp;
+	int ok = 1;
+
+	if ((fp = fopen(path, "wb")) == NULL)
+		return -1;
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, COL_MAGIC, sizeof(hdr.magic));
+	hdr.endian = COL_ENDIAN;
+	hdr.n_cols = (uint32_t)n_cols;
+	hdr.n_rows = n_rows;
+	ok &= (fwrite(&hdr, sizeof(hdr), 1, fp) == 1);
+
+	/* descriptors, columns are placed one after another */
+	offset = col_align(sizeof(hdr) + n_cols * sizeof(desc));
+	for (size_t i = 0; i < n_cols; i++)
+	{
+		memset(&desc, 0, sizeof(desc));
+		strncpy(desc.name, names[i], COL_NAME_MAX - 1);
+		desc.type = types[i];
+		desc.offset = offset;
+		ok &= (fwrite(&desc, sizeof(desc), 1, fp) == 1);
+		offset = col_align(offset + n_rows * col_size(types[i]));
+	}
+
+	/* data */
+	pos = sizeof(hdr) + n_cols * sizeof(desc);
+	for (size_t i = 0; i < n_cols; i++)
+	{
+		ok &= (fwrite(zero, 1, col_align(pos) - pos, fp) == col_align(pos) - pos);
+		pos = col_align(pos);
+		if (n_rows)
+			ok &= (fwrite(columns[i], col_size(types[i]), n_rows, fp) == n_rows);
+		pos += n_rows * col_size(types[i]);
+	}
+
+	ok &= (fclose(fp) == 0);
+	return ok ? 0 : -1;
+}
@@ -0,0 +1,160 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		col_file.h
+ *
+ * \brief		Columnar binary cache of the logs for the host tools, written once by
+ * \brief		tools/csv_to_col.c and mapped read-only by the replay.
+ * \brief		Layout, native byte order:
+ * \brief		col_header_t, col_desc_t[n_cols], then every column as one array of n_rows
+ * \brief		values, each array starting on a COL_ALIGN boundary.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _COL_FILE_H_   	        				// Re-include guard
+#define _COL_FILE_H_	    		        		// Re-include guard
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define COL_MAGIC		"VSCOL01"		// 8 bytes with the NUL
+#define COL_ENDIAN		(0x01020304u)	// reads differently on a machine of the other byte order
+#define COL_NAME_MAX	(32)
+#define COL_ALIGN		(64)
+#define COL_TIME_NAME	"time"			// name of the timestamp column, ms since 1970-01-01
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		col_type_t
+ * \brief		Type of a column.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	COL_F32 = 1,		// float
+	COL_I64 = 2,		// int64_t
+} col_type_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		col_header_t
+ * \brief		Start of the file.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	char magic[8];		// COL_MAGIC
+	uint32_t endian;	// COL_ENDIAN
+	uint32_t n_cols;
+	uint64_t n_rows;
+} col_header_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		col_desc_t
+ * \brief		Descriptor of one column, follows the header.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	char name[COL_NAME_MAX];	// NUL terminated
+	uint32_t type;				// col_type_t
+	uint32_t reserved;
+	uint64_t offset;			// of the first value from the start of the file
+} col_desc_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		col_file_t
+ * \brief		One open file. The column pointers stay valid until col_close().
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	const uint8_t *data;
+	size_t size;
+	int mapped;					// 1 if data is mmap-ed, 0 if it was read into the heap
+	const col_header_t *hdr;
+	const col_desc_t *cols;
+} col_file_t;
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			col_open()
+ *
+ * \brief		Open, map and validate a file.
+ *
+ * \param[out]	f = file.
+ * \param[in]	path = file name.
+ *
+ * \return		0 if ok, -1 if the file can not be opened, -2 if it is not a valid column file.
+*/
+//-------------------------------------------------------------------------------------------------
+int col_open(col_file_t *f, const char *path);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			col_column()
+ *
+ * \brief		Find a column by name.
+ *
+ * \param[in]	f = file.
+ * \param[in]	name = column name.
+ * \param[in]	type = expected type.
+ *
+ * \return		the n_rows values of the column, NULL if there is no such column of this type.
+*/
+//-------------------------------------------------------------------------------------------------
+const void *col_column(const col_file_t *f, const char *name, col_type_t type);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			col_close()
+ *
+ * \brief		Unmap the file.
+ *
+ * \param[in]	f = file.
+*/
+//-------------------------------------------------------------------------------------------------
+void col_close(col_file_t *f);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			col_write()
+ *
+ * \brief		Write a column file.
+ *
+ * \param[in]	path = file name.
+ * \param[in]	names = column names, shorter than COL_NAME_MAX.
+ * \param[in]	types = column types.
+ * \param[in]	columns = the n_rows values of every column.
+ * \param[in]	n_cols = number of columns.
+ * \param[in]	n_rows = number of rows.
+ *
+ * \return		0 if ok, -1 on a write error.
+*/
+//-------------------------------------------------------------------------------------------------
+int col_write(const char *path, const char *const *names, const col_type_t *types,
+			  const void *const *columns, size_t n_cols, size_t n_rows);
+
+#endif                                      // re-include guard
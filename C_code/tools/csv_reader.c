@@ -0,0 +1,659 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		csv_reader.c
+ *
+ * \brief		Memory-mapped CSV reader for the host tools.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "csv_reader.h"
+#include "float_io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <zlib.h>
+#ifdef CSV_ZSTD
+#include <zstd.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief		Decoded data is handed from the decoder thread to the parser in blocks.
+ */
+//-------------------------------------------------------------------------------------------------
+#define CSV_BLOCK_SIZE		(1 << 20)	// bytes of one decoded block
+#define CSV_BLOCKS			(4)			// blocks decoded ahead of the parser
+#define CSV_GZ_CHUNK		(1 << 16)	// bytes of one gzread()
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		csv_stream
+ * \brief		Decoder of a compressed file. The decoder thread fills block[head % CSV_BLOCKS],
+ *				the parser appends block[tail % CSV_BLOCKS] to its window.
+ */
+//-------------------------------------------------------------------------------------------------
+struct csv_stream
+{
+	gzFile gz;				// gzip, or NULL
+#ifdef CSV_ZSTD
+	FILE *fp;				// zstd
+	ZSTD_DStream *zd;
+	ZSTD_inBuffer zin;
+	void *zbuf;
+	size_t zbuf_cap;
+	size_t zret;			// last return of ZSTD_decompressStream() with progress, 0 at a frame end
+#endif
+	char *block[CSV_BLOCKS];
+	size_t len[CSV_BLOCKS];
+	char *win;				// unparsed rest of the last block and the next block, r->data
+	size_t win_cap;
+	pthread_t thread;
+	int started;			// 1 if the decoder thread runs
+	/* shared under lock */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	unsigned long head;		// blocks decoded
+	unsigned long tail;		// blocks taken by the parser
+	int done;				// decoder finished
+	int error;				// decoder failed, the file is damaged or truncated
+	int stop;				// csv_close() before the end
+};
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_decode()
+ *
+ * \brief		Decode up to cap bytes. A damaged or truncated file still yields the data
+ *				decoded before the fault.
+ *
+ * \param[out]	damaged = set to 1 if the file is damaged or truncated, the end of the data.
+ *
+ * \return		bytes decoded, less than cap only at the end.
+*/
+//-------------------------------------------------------------------------------------------------
+static long csv_decode(struct csv_stream *s, char *dst, size_t cap, int *damaged)
+{
+	size_t pos = 0;
+	unsigned int want;
+	int n, err;
+
+	*damaged = 0;
+	if (s->gz != NULL)
+	{
+		while (pos < cap)
+		{
+			want = (cap - pos < CSV_GZ_CHUNK) ? (unsigned int)(cap - pos) : CSV_GZ_CHUNK;
+			n = gzread(s->gz, dst + pos, want);
+			if (n > 0)
+				pos += (size_t)n;
+			if ((n < 0) || ((unsigned int)n < want))
+			{
+				/* short read: the end of the file, or truncated (Z_BUF_ERROR) or damaged; zlib may
+				   report the error while it still holds data, so it is checked here only */
+				gzerror(s->gz, &err);
+				*damaged = (n < 0) || ((err != Z_OK) && (err != Z_STREAM_END));
+				break;
+			}
+		}
+		return (long)pos;
+	}
+
+#ifdef CSV_ZSTD
+	ZSTD_outBuffer out = {dst, cap, 0};
+	size_t ret, prev;
+	int eof = 0;
+
+	while (out.pos < out.size)
+	{
+		if ((s->zin.pos == s->zin.size) && !eof)
+		{
+			s->zin.size = fread(s->zbuf, 1, s->zbuf_cap, s->fp);
+			s->zin.pos = 0;
+			eof = (s->zin.size == 0);
+		}
+		prev = out.pos;
+		ret = ZSTD_decompressStream(s->zd, &out, &s->zin);
+		if (ZSTD_isError(ret))
+		{
+			*damaged = 1;
+			break;
+		}
+		/* end of input and nothing left inside the decoder, complete if the last frame ended */
+		if (eof && (out.pos == prev))
+		{
+			*damaged = (s->zret != 0);
+			break;
+		}
+		s->zret = ret;
+	}
+	return (long)out.pos;
+#else
+	*damaged = 1;
+	return 0;
+#endif
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_decoder()
+ *
+ * \brief		Decoder thread of a compressed file, started by csv_stream_open(). It waits
+ *				under the lock while all CSV_BLOCKS blocks hold data not yet taken, decodes the
+ *				next block outside the lock, then publishes it by its len[] and head++ and
+ *				wakes the reader. csv_stream_more() takes the block at tail and frees it by
+ *				tail++. A short block ends the file: done is set, with error if the file is
+ *				damaged or truncated. csv_close() ends the thread early by stop.
+ *
+ * \param[in]	arg = the struct csv_stream.
+ *
+ * \return		NULL.
+*/
+//-------------------------------------------------------------------------------------------------
+static void *csv_decoder(void *arg)
+{
+	struct csv_stream *s = arg;
+	unsigned long i;
+	long n;
+	int stop, damaged;
+
+	for (;;)
+	{
+		pthread_mutex_lock(&s->lock);
+		while ((s->head - s->tail == CSV_BLOCKS) && !s->stop)
+			pthread_cond_wait(&s->cond, &s->lock);
+		i = s->head % CSV_BLOCKS;
+		stop = s->stop;
+		pthread_mutex_unlock(&s->lock);
+		if (stop)
+			break;
+
+		n = csv_decode(s, s->block[i], CSV_BLOCK_SIZE, &damaged);
+
+		pthread_mutex_lock(&s->lock);
+		if (n > 0)
+		{
+			s->len[i] = (size_t)n;
+			s->head++;
+		}
+		if ((n < CSV_BLOCK_SIZE) || damaged)
+		{
+			s->error = damaged;
+			s->done = 1;
+		}
+		pthread_cond_broadcast(&s->cond);
+		pthread_mutex_unlock(&s->lock);
+		if ((n < CSV_BLOCK_SIZE) || damaged)
+			break;
+	}
+	return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_stream_more()
+ *
+ * \brief		Move the unparsed rest of the window to its start and append the next block.
+ *
+ * \return		1 if a block was appended, 0 at the end of the file.
+*/
+//-------------------------------------------------------------------------------------------------
+static int csv_stream_more(csv_reader_t *r)
+{
+	struct csv_stream *s = r->stream;
+	size_t rest = r->size - r->pos;
+	size_t i, need;
+	char *win;
+
+	pthread_mutex_lock(&s->lock);
+	while ((s->head == s->tail) && !s->done)
+		pthread_cond_wait(&s->cond, &s->lock);
+	if (s->head == s->tail)
+	{
+		r->error = s->error;
+		pthread_mutex_unlock(&s->lock);
+		return 0;
+	}
+	pthread_mutex_unlock(&s->lock);
+
+	i = s->tail % CSV_BLOCKS;
+	need = rest + s->len[i] + 1;
+	if (need > s->win_cap)
+	{
+		if ((win = realloc(s->win, need * 2)) == NULL)
+		{
+			r->error = 1;
+			return 0;
+		}
+		s->win = win;
+		s->win_cap = need * 2;
+	}
+	memmove(s->win, s->win + r->pos, rest);
+	memcpy(s->win + rest, s->block[i], s->len[i]);
+	r->data = s->win;
+	r->size = rest + s->len[i];
+	r->pos = 0;
+	s->win[r->size] = '\0';	// a stop for the number parser after the last field
+
+	pthread_mutex_lock(&s->lock);
+	s->tail++;
+	pthread_cond_broadcast(&s->cond);
+	pthread_mutex_unlock(&s->lock);
+	return 1;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_stream_open()
+ *
+ * \brief		Start the decoder of a gzip (magic 1f 8b) or zstd (28 b5 2f fd) file.
+ *
+ * \return		0 if ok, 1 if the file is not compressed, -1 on error.
+*/
+//-------------------------------------------------------------------------------------------------
+static int csv_stream_open(csv_reader_t *r, const char *path)
+{
+	static const unsigned char gz_magic[2] = {0x1f, 0x8b};
+	static const unsigned char zst_magic[4] = {0x28, 0xb5, 0x2f, 0xfd};
+	unsigned char magic[4] = {0};
+	struct csv_stream *s;
+	FILE *fp;
+	int gz, zst;
+
+	if ((fp = fopen(path, "rb")) == NULL)
+		return -1;
+	gz = (fread(magic, 1, sizeof(magic), fp) >= 2) && (memcmp(magic, gz_magic, 2) == 0);
+	zst = (memcmp(magic, zst_magic, 4) == 0);
+	if (!gz && !zst)
+	{
+		fclose(fp);
+		return 1;
+	}
+	if ((s = calloc(1, sizeof(*s))) == NULL)
+	{
+		fclose(fp);
+		return -1;
+	}
+	r->stream = s;
+
+	if (gz)
+	{
+		fclose(fp);
+		if ((s->gz = gzopen(path, "rb")) == NULL)
+			goto fail;
+		gzbuffer(s->gz, 1 << 18);
+	}
+	else
+	{
+#ifdef CSV_ZSTD
+		rewind(fp);
+		s->fp = fp;
+		s->zbuf_cap = ZSTD_DStreamInSize();
+		if (((s->zd = ZSTD_createDStream()) == NULL) || ((s->zbuf = malloc(s->zbuf_cap)) == NULL))
+			goto fail;
+		ZSTD_initDStream(s->zd);
+		s->zin.src = s->zbuf;
+		s->zret = 1;
+#else
+		/* built without CSV_ZSTD */
+		fclose(fp);
+		goto fail;
+#endif
+	}
+
+	for (int i = 0; i < CSV_BLOCKS; i++)
+		if ((s->block[i] = malloc(CSV_BLOCK_SIZE)) == NULL)
+			goto fail;
+	pthread_mutex_init(&s->lock, NULL);
+	pthread_cond_init(&s->cond, NULL);
+	if (pthread_create(&s->thread, NULL, csv_decoder, s) != 0)
+	{
+		pthread_cond_destroy(&s->cond);
+		pthread_mutex_destroy(&s->lock);
+		goto fail;
+	}
+	s->started = 1;
+	return 0;
+
+fail:
+	csv_close(r);
+	return -1;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_read_all()
+ *
+ * \brief		Read the whole file into the heap, used where mmap is not available.
+*/
+//-------------------------------------------------------------------------------------------------
+static int csv_read_all(csv_reader_t *r, const char *path)
+{
+	FILE *fp;
+	char *buf = NULL;
+	size_t n = 0, cap = 0, got;
+
+	if ((fp = fopen(path, "rb")) == NULL)
+		return -1;
+	do
+	{
+		if (n == cap)
+		{
+			cap = cap ? cap * 2 : 1 << 16;
+			buf = realloc(buf, cap);
+			if (buf == NULL)
+			{
+				fclose(fp);
+				return -1;
+			}
+		}
+		got = fread(buf + n, 1, cap - n, fp);
+		n += got;
+	} while (got != 0);
+	fclose(fp);
+
+	r->data = buf;
+	r->size = n;
+	r->mapped = 0;
+	return 0;
+}
+
+
+int csv_open(csv_reader_t *r, const char *path)
+{
+	int ret;
+
+	memset(r, 0, sizeof(*r));
+	if ((ret = csv_stream_open(r, path)) <= 0)
+		return ret;
+
+#ifndef _WIN32
+	int fd;
+	struct stat st;
+	void *p;
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return -1;
+	if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0))
+	{
+		p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED)
+		{
+			madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+			close(fd);
+			r->data = p;
+			r->size = (size_t)st.st_size;
+			r->mapped = 1;
+			return 0;
+		}
+	}
+	close(fd);
+#endif
+
+	return csv_read_all(r, path);
+}
+
+
+int csv_next_row(csv_reader_t *r)
+{
+	const char *p, *end, *eol, *comma;
+	size_t len;
+
+	if ((r->pos >= r->size) && ((r->stream == NULL) || !csv_stream_more(r)))
+		return -1;
+
+	p = r->data + r->pos;
+	end = r->data + r->size;
+	eol = memchr(p, '\n', end - p);
+	while ((eol == NULL) && (r->stream != NULL) && csv_stream_more(r))
+	{
+		/* the row goes on in the next block */
+		p = r->data + r->pos;
+		end = r->data + r->size;
+		eol = memchr(p, '\n', end - p);
+	}
+	if ((eol == NULL) && r->error)
+	{
+		/* the last row of a damaged or truncated file is cut */
+		r->pos = r->size;
+		return -1;
+	}
+	if (eol == NULL)
+		eol = end;
+	r->pos = (eol - r->data) + 1;
+	r->line++;
+
+	/* CRLF */
+	len = eol - p;
+	if ((len > 0) && (p[len - 1] == '\r'))
+		len--;
+	end = p + len;
+
+	r->n_fields = 0;
+	for (;;)
+	{
+		if (r->n_fields == r->cap_fields)
+		{
+			r->cap_fields = r->cap_fields ? r->cap_fields * 2 : 32;
+			r->fields = realloc(r->fields, r->cap_fields * sizeof(csv_field_t));
+			if (r->fields == NULL)
+			{
+				r->cap_fields = 0;
+				return -1;
+			}
+		}
+		comma = memchr(p, ',', end - p);
+		if (comma == NULL)
+			comma = end;
+		r->fields[r->n_fields].ptr = p;
+		r->fields[r->n_fields].len = comma - p;
+		r->n_fields++;
+		if (comma == end)
+			break;
+		p = comma + 1;
+	}
+
+	return (int)r->n_fields;
+}
+
+
+float csv_field_float(const csv_field_t *f)
+{
+	/* the field is not NUL terminated in the mapping */
+	return float_parse(f->ptr, f->len);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_digits()
+ *
+ * \brief		Value of n decimal digits, -1 if one is not a digit.
+*/
+//-------------------------------------------------------------------------------------------------
+static int csv_digits(const char *s, int n)
+{
+	int v = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		if ((s[i] < '0') || (s[i] > '9'))
+			return -1;
+		v = v * 10 + (s[i] - '0');
+	}
+	return v;
+}
+
+
+int64_t csv_field_time_ms(const csv_field_t *f)
+{
+	const char *s = f->ptr;
+	int y, mo, d, h, mi, sec, ms = 0, era;
+	unsigned int yoe, doy, doe;
+	int64_t days;
+
+	/* YYYY-MM-DD hh:mm:ss */
+	if ((f->len < 19) || (s[4] != '-') || (s[7] != '-') || ((s[10] != ' ') && (s[10] != 'T')) ||
+		(s[13] != ':') || (s[16] != ':'))
+		return CSV_TIME_NONE;
+	y = csv_digits(s, 4);
+	mo = csv_digits(s + 5, 2);
+	d = csv_digits(s + 8, 2);
+	h = csv_digits(s + 11, 2);
+	mi = csv_digits(s + 14, 2);
+	sec = csv_digits(s + 17, 2);
+	if ((y < 0) || (mo < 1) || (mo > 12) || (d < 1) || (d > 31) || (h < 0) || (mi < 0) || (sec < 0))
+		return CSV_TIME_NONE;
+
+	/* .fff, digits after the third are dropped */
+	if ((f->len > 19) && (s[19] == '.'))
+	{
+		int scale = 100;
+
+		for (size_t i = 20; (i < f->len) && (i < 23) && (s[i] >= '0') && (s[i] <= '9'); i++, scale /= 10)
+			ms += (s[i] - '0') * scale;
+	}
+
+	/* days from civil, proleptic Gregorian */
+	y -= (mo <= 2);
+	era = y / 400;
+	yoe = (unsigned int)(y - era * 400);
+	doy = (153 * (mo + (mo > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+	doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	days = (int64_t)era * 146097 + (int64_t)doe - 719468;
+
+	return ((days * 24 + h) * 60 + mi) * 60000 + (int64_t)sec * 1000 + ms;
+}
+
+
+int csv_row_floats(const csv_reader_t *r, size_t first, float *data, size_t max)
+{
+	size_t n = 0;
+
+	for (size_t i = first; (i < r->n_fields) && (n < max); i++)
+	{
+		data[n++] = csv_field_float(&r->fields[i]);
+	}
+	return (int)n;
+}
+
+
+int csv_bind(const csv_reader_t *r, const char *const *names, size_t n, int *index)
+{
+	int missing = 0;
+	size_t len;
+
+	for (size_t i = 0; i < n; i++)
+	{
+		index[i] = -1;
+		if (names[i] == NULL)
+			continue;
+		len = strlen(names[i]);
+		for (size_t j = 0; j < r->n_fields; j++)
+		{
+			if ((r->fields[j].len == len) && (memcmp(r->fields[j].ptr, names[i], len) == 0))
+			{
+				index[i] = (int)j;
+				break;
+			}
+		}
+		if (index[i] < 0)
+			missing++;
+	}
+
+	return missing;
+}
+
+
+int csv_row_project(const csv_reader_t *r, const int *index, size_t n, float *data)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		if (index[i] < 0)
+			data[i] = 0;
+		else if ((size_t)index[i] < r->n_fields)
+			data[i] = csv_field_float(&r->fields[index[i]]);
+		else
+			return 0;
+	}
+
+	return 1;
+}
+
+
+size_t csv_base_len(const char *path)
+{
+	size_t len = strlen(path);
+
+	if ((len >= 3) && (strcmp(path + len - 3, ".gz") == 0))
+		return len - 3;
+	if ((len >= 4) && (strcmp(path + len - 4, ".zst") == 0))
+		return len - 4;
+	return len;
+}
+
+
+void csv_close(csv_reader_t *r)
+{
+	struct csv_stream *s = r->stream;
+
+	if (s != NULL)
+	{
+		if (s->started)
+		{
+			/* the decoder may wait for a free block */
+			pthread_mutex_lock(&s->lock);
+			s->stop = 1;
+			pthread_cond_broadcast(&s->cond);
+			pthread_mutex_unlock(&s->lock);
+			pthread_join(s->thread, NULL);
+			pthread_cond_destroy(&s->cond);
+			pthread_mutex_destroy(&s->lock);
+		}
+		if (s->gz != NULL)
+			gzclose(s->gz);
+#ifdef CSV_ZSTD
+		if (s->fp != NULL)
+			fclose(s->fp);
+		ZSTD_freeDStream(s->zd);
+		free(s->zbuf);
+#endif
+		for (int i = 0; i < CSV_BLOCKS; i++)
+			free(s->block[i]);
+		free(s->win);
+		free(s);
+	}
+#ifndef _WIN32
+	else if (r->mapped)
+		munmap((void *)r->data, r->size);
+#endif
+	else
+		free((void *)r->data);
+	free(r->fields);
+	memset(r, 0, sizeof(*r));
+}
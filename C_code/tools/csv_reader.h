@@ -0,0 +1,208 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		csv_reader.h
+ *
+ * \brief		Memory-mapped CSV reader for the host tools. The file is mapped read-only and
+ * \brief		every row is split in place into field views, nothing is copied and there is
+ * \brief		no limit on the row length or the number of columns.
+ * \brief		Fields are separated by ',', rows by LF or CRLF, quotes are not supported.
+ * \brief		A gzip file, or a zstd file if built with CSV_ZSTD, is found by its magic bytes
+ * \brief		and decoded by a thread of its own into blocks, while the rows of the blocks
+ * \brief		before are split; the field views then stay valid only until the next row.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _CSV_READER_H_   	        				// Re-include guard
+#define _CSV_READER_H_	    		        		// Re-include guard
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define CSV_TIME_NONE		INT64_MIN	// csv_field_time_ms() of a field which is not a timestamp
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		csv_field_t
+ * \brief		View of one field inside the mapped file, not NUL terminated.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	const char *ptr;
+	size_t len;
+} csv_field_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		csv_reader_t
+ * \brief		State of one open file. The field views stay valid until csv_close(), for a
+ *				compressed file until the next csv_next_row().
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	const char *data;		// mapped file, or the decoded window of a compressed file
+	size_t size;
+	size_t pos;				// start of the next row
+	int mapped;				// 1 if data is mmap-ed, 0 if it was read into the heap
+	struct csv_stream *stream;	// decoder of a compressed file, NULL if not compressed
+	int error;				// 1 if a compressed file is damaged or truncated, set at the end
+	long line;				// line number of the current row, 1 for the first
+	csv_field_t *fields;	// fields of the current row
+	size_t n_fields;
+	size_t cap_fields;
+} csv_reader_t;
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_open()
+ *
+ * \brief		Open and map a CSV file, or start decoding a compressed one.
+ *
+ * \param[out]	r = reader.
+ * \param[in]	path = file name.
+ *
+ * \return		0 if ok, -1 if the file can not be opened or decoded.
+*/
+//-------------------------------------------------------------------------------------------------
+int csv_open(csv_reader_t *r, const char *path);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_next_row()
+ *
+ * \brief		Split the next row into r->fields.
+ *
+ * \param[in]	r = reader.
+ *
+ * \return		number of fields, -1 at the end of the file.
+*/
+//-------------------------------------------------------------------------------------------------
+int csv_next_row(csv_reader_t *r);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_field_float()
+ *
+ * \brief		Convert a field like atof() does.
+ *
+ * \param[in]	f = field.
+ *
+ * \return		value of the field, 0 if it is not a number.
+*/
+//-------------------------------------------------------------------------------------------------
+float csv_field_float(const csv_field_t *f);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_field_time_ms()
+ *
+ * \brief		Convert a "YYYY-MM-DD hh:mm:ss[.fff]" field to ms since 1970-01-01, the zone is
+ * \brief		kept as logged. The format is fixed, the digits are read at their positions.
+ *
+ * \param[in]	f = field.
+ *
+ * \return		the time, CSV_TIME_NONE if the field is not a timestamp.
+*/
+//-------------------------------------------------------------------------------------------------
+int64_t csv_field_time_ms(const csv_field_t *f);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_row_floats()
+ *
+ * \brief		Convert the fields first, first+1, ... of the current row.
+ *
+ * \param[in]	r = reader.
+ * \param[in]	first = index of the first field to convert.
+ * \param[out]	data = values.
+ * \param[in]	max = size of data[].
+ *
+ * \return		number of values written to data[].
+*/
+//-------------------------------------------------------------------------------------------------
+int csv_row_floats(const csv_reader_t *r, size_t first, float *data, size_t max);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_bind()
+ *
+ * \brief		Bind columns by name in the current row, normally the header.
+ *
+ * \param[in]	r = reader.
+ * \param[in]	names = column names, NULL for a column which is not used.
+ * \param[in]	n = number of names.
+ * \param[out]	index = field index of each name, -1 if not found or not used.
+ *
+ * \return		number of names which were not found.
+*/
+//-------------------------------------------------------------------------------------------------
+int csv_bind(const csv_reader_t *r, const char *const *names, size_t n, int *index);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_row_project()
+ *
+ * \brief		Convert only the bound fields of the current row.
+ *
+ * \param[in]	r = reader.
+ * \param[in]	index = field indices from csv_bind(), -1 gives 0.
+ * \param[in]	n = number of indices.
+ * \param[out]	data = values, data[i] from field index[i].
+ *
+ * \return		1, or 0 if the row is too short for a bound field.
+*/
+//-------------------------------------------------------------------------------------------------
+int csv_row_project(const csv_reader_t *r, const int *index, size_t n, float *data);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_base_len()
+ *
+ * \brief		Length of a file name without a ".gz" or ".zst" ending, so "x.csv.gz" is
+ * \brief		matched like "x.csv".
+ *
+ * \param[in]	path = file name.
+ *
+ * \return		length of the name before the ending.
+*/
+//-------------------------------------------------------------------------------------------------
+size_t csv_base_len(const char *path);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			csv_close()
+ *
+ * \brief		Unmap the file, stop the decoder and free the reader.
+ *
+ * \param[in]	r = reader.
+*/
+//-------------------------------------------------------------------------------------------------
+void csv_close(csv_reader_t *r);
+
+#endif                                      // re-include guard
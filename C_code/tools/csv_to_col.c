@@ -0,0 +1,226 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		csv_to_col.c
+ *
+ * \brief		Convert logs to the columnar binary cache, see col_file.h.
+ * \brief		The first column (the timestamp) becomes the int64 column "time" in ms, every
+ * \brief		other column a float column of the same name, parsed like the replay does.
+ * \brief		Usage: csv_to_col [-o out_dir] dir|file...
+ * \brief		*tdis.csv -> *tdis.col, *current.csv -> *current.col, also from *.csv.gz and *.csv.zst
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "csv_reader.h"
+#include "col_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			convert()
+ *
+ * \brief		Convert one log.
+ *
+ * \return		number of rows, -1 on error.
+*/
+//-------------------------------------------------------------------------------------------------
+static long convert(const char *src, const char *dest)
+{
+	csv_reader_t csv;
+	size_t n_cols, n_rows = 0, cap = 0;
+	char (*names)[COL_NAME_MAX];
+	const char **name_ptr;
+	col_type_t *types;
+	void **cols, *col;
+	long ret = -1;
+
+	if (csv_open(&csv, src) != 0)
+		return -1;
+	if (csv_next_row(&csv) < 1)
+	{
+		csv_close(&csv);
+		return -1;
+	}
+
+	/* header */
+	n_cols = csv.n_fields;
+	names = calloc(n_cols, COL_NAME_MAX);
+	name_ptr = calloc(n_cols, sizeof(char *));
+	types = calloc(n_cols, sizeof(col_type_t));
+	cols = calloc(n_cols, sizeof(void *));
+	if ((names == NULL) || (name_ptr == NULL) || (types == NULL) || (cols == NULL))
+		goto out;
+	for (size_t i = 0; i < n_cols; i++)
+	{
+		if (i == 0)
+			snprintf(names[i], COL_NAME_MAX, "%s", COL_TIME_NAME);
+		else if ((csv.fields[i].len == 0) || (csv.fields[i].len >= COL_NAME_MAX))
+			snprintf(names[i], COL_NAME_MAX, "col%zu", i);
+		else
+			memcpy(names[i], csv.fields[i].ptr, csv.fields[i].len);
+		name_ptr[i] = names[i];
+		types[i] = (i == 0) ? COL_I64 : COL_F32;
+	}
+
+	/* rows, short rows are dropped like the replay does */
+	while (csv_next_row(&csv) >= 0)
+	{
+		if (csv.n_fields < n_cols)
+			continue;
+		if (n_rows == cap)
+		{
+			cap = cap ? cap * 2 : 4096;
+			for (size_t i = 0; i < n_cols; i++)
+			{
+				if ((col = realloc(cols[i], cap * ((i == 0) ? sizeof(int64_t) : sizeof(float)))) == NULL)
+					goto out;
+				cols[i] = col;
+			}
+		}
+		((int64_t *)cols[0])[n_rows] = csv_field_time_ms(&csv.fields[0]);
+		for (size_t i = 1; i < n_cols; i++)
+			((float *)cols[i])[n_rows] = csv_field_float(&csv.fields[i]);
+		n_rows++;
+	}
+
+	/* a truncated compressed log is not cached */
+	if (!csv.error && (col_write(dest, name_ptr, types, (const void *const *)cols, n_cols, n_rows) == 0))
+		ret = (long)n_rows;
+
+out:
+	for (size_t i = 0; (cols != NULL) && (i < n_cols); i++)
+		free(cols[i]);
+	free(cols);
+	free(types);
+	free(name_ptr);
+	free(names);
+	csv_close(&csv);
+	return ret;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			is_log()
+ *
+ * \brief		Check if a file is a log to convert, *tdis.csv or *current.csv, plain or
+ *				compressed.
+ *
+ * \return		1 if it is, 0 if not.
+*/
+//-------------------------------------------------------------------------------------------------
+static int is_log(const char *name)
+{
+	size_t len = csv_base_len(name);
+
+	return ((len >= 8) && (memcmp(name + len - 8, "tdis.csv", 8) == 0)) ||
+		   ((len >= 11) && (memcmp(name + len - 11, "current.csv", 11) == 0));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			convert_path()
+ *
+ * \brief		Convert one log, <name>.csv[.gz|.zst] -> <name>.col in out_dir or next to the log.
+*/
+//-------------------------------------------------------------------------------------------------
+static int convert_path(const char *path, const char *out_dir)
+{
+	char dest[1024];
+	const char *base;
+	long rows;
+	int len;
+
+	base = strrchr(path, '/');
+	base = (base != NULL) ? base + 1 : path;
+	if (out_dir != NULL)
+		len = snprintf(dest, sizeof(dest), "%s/%s", out_dir, base);
+	else
+		len = snprintf(dest, sizeof(dest), "%s", path);
+	if (len >= (int)sizeof(dest))
+		return 1;
+	len -= (int)(strlen(path) - csv_base_len(path));
+	if (len < 4)
+		return 1;
+	strcpy(dest + len - 4, ".col");
+
+	rows = convert(path, dest);
+	if (rows < 0)
+	{
+		printf("Error converting %s\n", path);
+		return 1;
+	}
+	printf("%s: %ld rows -> %s\n", path, rows, dest);
+	return 0;
+}
+
+
+
+
+int main(int argc, char *argv[])
+{
+	const char *out_dir = NULL;
+	struct stat st;
+	DIR *dp;
+	struct dirent *dirp;
+	char path[1024];
+	int errors = 0;
+	int a = 1;
+
+	if ((argc > 2) && (strcmp(argv[1], "-o") == 0))
+	{
+		out_dir = argv[2];
+		a = 3;
+	}
+	if (a >= argc)
+	{
+		printf("usage: %s [-o out_dir] dir|file...\n", argv[0]);
+		return 1;
+	}
+	if ((out_dir != NULL) && (stat(out_dir, &st) != 0) && (mkdir(out_dir, 0777) != 0))
+	{
+		printf("Error creating directory %s\n", out_dir);
+		return 1;
+	}
+
+	for (; a < argc; a++)
+	{
+		if ((stat(argv[a], &st) == 0) && S_ISDIR(st.st_mode))
+		{
+			if ((dp = opendir(argv[a])) == NULL)
+			{
+				printf("Error opening directory %s\n", argv[a]);
+				errors++;
+				continue;
+			}
+			while ((dirp = readdir(dp)) != NULL)
+			{
+				if (!is_log(dirp->d_name))
+					continue;
+				snprintf(path, sizeof(path), "%s/%s", argv[a], dirp->d_name);
+				errors += convert_path(path, out_dir);
+			}
+			closedir(dp);
+		}
+		else
+		{
+			errors += convert_path(argv[a], out_dir);
+		}
+	}
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,112 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		err_stats.c
+ *
+ * \brief		Streaming error statistics for the host tools.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "err_stats.h"
+#include <string.h>
+#include <math.h>
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			stats_bucket()
+ *
+ * \brief		Bucket of an absolute error.
+*/
+//-------------------------------------------------------------------------------------------------
+static int stats_bucket(double e)
+{
+	double i;
+
+	if (!(e > STATS_MIN))
+		return 0;		// NaN as well, stats_add() does not pass one
+	i = ceil(log(e / STATS_MIN) / log(STATS_GAMMA));
+	return (i >= STATS_BUCKETS - 1) ? STATS_BUCKETS - 1 : (int)i;
+}
+
+
+void stats_init(err_stats_t *s)
+{
+	memset(s, 0, sizeof(*s));
+}
+
+
+void stats_add(err_stats_t *s, double err)
+{
+	double e = fabs(err);
+
+	if (!isfinite(err))
+	{
+		/* a NaN or infinite value in the log, left out as the caller's exclusions */
+		s->excluded++;
+		return;
+	}
+	s->n++;
+	s->sum += err;
+	s->sum_abs += e;
+	s->sum_sq += err * err;
+	s->max_abs = (e > s->max_abs) ? e : s->max_abs;
+	s->sketch[stats_bucket(e)]++;
+}
+
+
+void stats_merge(err_stats_t *dst, const err_stats_t *src)
+{
+	dst->n += src->n;
+	dst->excluded += src->excluded;
+	dst->sum += src->sum;
+	dst->sum_abs += src->sum_abs;
+	dst->sum_sq += src->sum_sq;
+	dst->max_abs = (src->max_abs > dst->max_abs) ? src->max_abs : dst->max_abs;
+	for (int i = 0; i < STATS_BUCKETS; i++)
+		dst->sketch[i] += src->sketch[i];
+}
+
+
+double stats_percentile(const err_stats_t *s, double q)
+{
+	double rank, v;
+	long seen = 0;
+	int i;
+
+	if (s->n == 0)
+		return 0;
+	rank = q * (s->n - 1);
+	for (i = 0; i < STATS_BUCKETS - 1; i++)
+	{
+		seen += s->sketch[i];
+		if (seen > rank)
+			break;
+	}
+
+	/* middle of the bucket in relative terms, never above the largest error */
+	if (i == 0)
+		return 0;
+	v = 2 * STATS_MIN * pow(STATS_GAMMA, i) / (STATS_GAMMA + 1);
+	return (v > s->max_abs) ? s->max_abs : v;
+}
+
+
+void stats_json(FILE *fp, const err_stats_t *s)
+{
+	double n = s->n ? (double)s->n : 1;
+
+	fprintf(fp, "{\"n\": %ld, \"excluded\": %ld, \"bias\": %.6g, \"mae\": %.6g, \"rmse\": %.6g, \"max\": %.6g, "
+			"\"p50\": %.6g, \"p90\": %.6g, \"p95\": %.6g, \"p99\": %.6g}",
+			s->n, s->excluded, s->sum / n, s->sum_abs / n, sqrt(s->sum_sq / n), s->max_abs,
+			stats_percentile(s, 0.50), stats_percentile(s, 0.90), stats_percentile(s, 0.95),
+			stats_percentile(s, 0.99));
+}
@@ -0,0 +1,125 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		err_stats.h
+ *
+ * \brief		Streaming error statistics for the host tools, constant memory per statistic:
+ * \brief		bias, MAE, RMSE, largest error and percentiles of the absolute error.
+ * \brief		The percentiles come from a sketch of log-spaced buckets, each bucket is
+ * \brief		STATS_GAMMA times wider than the one before, so a percentile is within about
+ * \brief		1% of the exact one. Statistics of several files merge without loss.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _ERR_STATS_H_   	        				// Re-include guard
+#define _ERR_STATS_H_	    		        		// Re-include guard
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief		Sketch of the absolute error. Bucket 0 holds errors up to STATS_MIN, bucket i
+ *				errors up to STATS_MIN*STATS_GAMMA^i, the last bucket everything above.
+ */
+//-------------------------------------------------------------------------------------------------
+#define STATS_MIN			(1e-4)		// smallest error told apart from zero
+#define STATS_GAMMA			(1.02)		// ratio of the bucket bounds
+#define STATS_BUCKETS		(1024)		// up to 1e-4*1.02^1023, about 6e4
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		err_stats_t
+ * \brief		Statistic of error = prediction - measurement.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	long n;
+	long excluded;			// samples left out by the caller, e.g. without solution
+	double sum;
+	double sum_abs;
+	double sum_sq;
+	double max_abs;
+	uint32_t sketch[STATS_BUCKETS];
+} err_stats_t;
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			stats_init()
+ *
+ * \brief		Clear a statistic.
+ *
+ * \param[out]	s = statistic.
+*/
+//-------------------------------------------------------------------------------------------------
+void stats_init(err_stats_t *s);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			stats_add()
+ *
+ * \brief		Add one error. A NaN or infinite error, e.g. from a nan in the log, is counted
+ *				as excluded.
+ *
+ * \param[in]	s = statistic.
+ * \param[in]	err = prediction - measurement.
+*/
+//-------------------------------------------------------------------------------------------------
+void stats_add(err_stats_t *s, double err);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			stats_merge()
+ *
+ * \brief		Add the samples of src to dst.
+ *
+ * \param[in]	dst = statistic.
+ * \param[in]	src = statistic to add.
+*/
+//-------------------------------------------------------------------------------------------------
+void stats_merge(err_stats_t *dst, const err_stats_t *src);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			stats_percentile()
+ *
+ * \brief		Percentile of the absolute error from the sketch.
+ *
+ * \param[in]	s = statistic.
+ * \param[in]	q = 0...1, e.g. 0.95.
+ *
+ * \return		the percentile, 0 without samples.
+*/
+//-------------------------------------------------------------------------------------------------
+double stats_percentile(const err_stats_t *s, double q);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			stats_json()
+ *
+ * \brief		Write a statistic as a JSON object:
+ *				{"n","excluded","bias","mae","rmse","max","p50","p90","p95","p99"}.
+ *
+ * \param[in]	fp = file.
+ * \param[in]	s = statistic.
+*/
+//-------------------------------------------------------------------------------------------------
+void stats_json(FILE *fp, const err_stats_t *s);
+
+#endif                                      // re-include guard
@@ -0,0 +1,197 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		fixed_point_check.c
+ *
+ * \brief		Host harness: error of the fixed-point prediction against the floating
+ * \brief		point prediction over logged data. Rows where either t_dis has no root
+ * \brief		(TDIS_NO_ROOT) are counted apart, not compared.
+ * \brief		Usage: fixed_point_check temp_data/ *_tdis.csv temp_data1/ *_pd_current.csv
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "sensor_predict.h"
+#include "sensor_predict_q.h"
+#include "csv_reader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		err_stat_t
+ * \brief		Absolute error statistic of one output.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	double sum;
+	double max;
+	long n;
+	long no_root;		// rows without root in the float or the fixed-point t_dis, not in n
+	long no_root_q;		// of those, rows without root in the fixed-point t_dis only
+} err_stat_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			err_add()
+ *
+ * \brief		Add the absolute error of a fixed-point output against the float reference.
+ *
+ * \param[in]	e = statistic.
+ * \param[in]	ref = float output.
+ * \param[in]	q = fixed-point output, Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+static void err_add(err_stat_t *e, float ref, q16_t q)
+{
+	double d = fabs(ref - Q16_TO_FLOAT(q));
+
+	e->sum += d;
+	e->max = (d > e->max) ? d : e->max;
+	e->n++;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			err_add_tdis()
+ *
+ * \brief		Add the t_dis error of a row. A row without root in the float or the
+ *				fixed-point model is only counted in no_root, see pred_Tdis_q_status().
+ *
+ * \param[in]	e = statistic.
+ * \param[in]	st = status of the float t_dis.
+ * \param[in]	ref = float t_dis.
+ * \param[in]	st_q = status of the fixed-point t_dis.
+ * \param[in]	q = fixed-point t_dis, Q16.16.
+*/
+//-------------------------------------------------------------------------------------------------
+static void err_add_tdis(err_stat_t *e, tdis_status_t st, float ref, tdis_status_t st_q, q16_t q)
+{
+	if ((st != TDIS_OK) || (st_q != TDIS_OK))
+	{
+		e->no_root++;
+		e->no_root_q += (st == TDIS_OK);
+		return;
+	}
+	err_add(e, ref, q);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			err_merge()
+ *
+ * \brief		Add the rows of the statistic of one file to the total.
+*/
+//-------------------------------------------------------------------------------------------------
+static void err_merge(err_stat_t *dst, const err_stat_t *src)
+{
+	dst->sum += src->sum;
+	dst->max = (src->max > dst->max) ? src->max : dst->max;
+	dst->n += src->n;
+	dst->no_root += src->no_root;
+	dst->no_root_q += src->no_root_q;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			err_print()
+ *
+ * \brief		Print the largest and the mean error of one output, and the no-root rows.
+*/
+//-------------------------------------------------------------------------------------------------
+static void err_print(const char *name, const err_stat_t *e)
+{
+	printf("  %-10s max %10.4f  mean %10.4f", name, e->max, e->n ? e->sum / e->n : 0);
+	if (e->no_root)
+		printf("  no root %ld (fixed-point only %ld)", e->no_root, e->no_root_q);
+	printf("\n");
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \var     log_cols[]
+ * \brief   Columns read from the logs, bound by name from the header.
+ */
+//-------------------------------------------------------------------------------------------------
+enum {COL_PD = 0, COL_PS, COL_SPEED, COL_ST, COL_T_DIS, COL_COMP_CU, COL_N};
+static const char *const log_cols[COL_N] = {"Pd", "Ps", "CompSpeed", "ST", "T_dis", "Comp_cu"};
+
+
+
+
+int main(int argc, char const *argv[])
+{
+	csv_reader_t csv;
+	int col[COL_N];
+	float data[COL_N], t_dis;
+	q16_t t_dis_q;
+	tdis_status_t st, st_q;
+	err_stat_t all[3] = {{0}}, file[3];
+
+	if (argc < 2)
+	{
+		printf("usage: %s file.csv...\n", argv[0]);
+		return 1;
+	}
+
+	for (int a = 1; a < argc; a++)
+	{
+		if (csv_open(&csv, argv[a]) != 0)
+		{
+			printf("Error opening %s\n", argv[a]);
+			continue;
+		}
+		memset(file, 0, sizeof(file));
+
+		/* bind the columns by the header */
+		if ((csv_next_row(&csv) < 0) || (csv_bind(&csv, log_cols, COL_N, col) != 0))
+		{
+			printf("Missing column in %s\n", argv[a]);
+			csv_close(&csv);
+			continue;
+		}
+		while (csv_next_row(&csv) >= 0)
+		{
+			if (!csv_row_project(&csv, col, COL_N, data))
+				continue;
+
+			st = pred_Tdis_status(data[COL_PS], data[COL_ST], data[COL_PD], data[COL_SPEED], &t_dis);
+			st_q = pred_Tdis_q_status(Q16(data[COL_PS]), Q16(data[COL_ST]), Q16(data[COL_PD]), Q16(data[COL_SPEED]),
+									  &t_dis_q);
+			err_add_tdis(&file[0], st, t_dis, st_q, t_dis_q);
+			err_add(&file[1], pred_Pdis_temp(data[COL_PS], data[COL_ST], data[COL_T_DIS], data[COL_SPEED]),
+					pred_Pdis_temp_q(Q16(data[COL_PS]), Q16(data[COL_ST]), Q16(data[COL_T_DIS]), Q16(data[COL_SPEED])));
+			err_add(&file[2], pred_Pdis_curr(data[COL_PS], data[COL_COMP_CU], data[COL_SPEED], 220),
+					pred_Pdis_curr_q(Q16(data[COL_PS]), Q16(data[COL_COMP_CU]), Q16(data[COL_SPEED]), Q16(220)));
+		}
+		csv_close(&csv);
+
+		printf("%s: %ld rows\n", argv[a], file[0].n + file[0].no_root);
+		err_print("t_dis", &file[0]);
+		err_print("p_dis_t", &file[1]);
+		err_print("p_dis_c", &file[2]);
+		for (int i = 0; i < 3; i++)
+			err_merge(&all[i], &file[i]);
+	}
+
+	printf("ALL: %ld rows\n", all[0].n + all[0].no_root);
+	err_print("t_dis", &all[0]);
+	err_print("p_dis_t", &all[1]);
+	err_print("p_dis_c", &all[2]);
+
+	return 0;
+}
@@ -0,0 +1,305 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		float_io.c
+ *
+ * \brief		Locale-free conversion between text and float.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "float_io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \var     pow10_exact[]
+ * \brief   Powers of ten which are exact in double.
+ */
+//-------------------------------------------------------------------------------------------------
+static const double pow10_exact[23] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			float_parse_slow()
+ *
+ * \brief		Conversion by the C library.
+*/
+//-------------------------------------------------------------------------------------------------
+static double float_parse_slow(const char *s, size_t len)
+{
+	char num[FLOAT_FMT_MAX];
+
+	if (len >= sizeof(num))
+	{
+		char *tmp = malloc(len + 1);
+		double x;
+
+		if (tmp == NULL)
+			return 0;
+		memcpy(tmp, s, len);
+		tmp[len] = '\0';
+		x = atof(tmp);
+		free(tmp);
+		return x;
+	}
+	memcpy(num, s, len);
+	num[len] = '\0';
+
+	return atof(num);
+}
+
+
+double float_parse(const char *s, size_t len)
+{
+	const char *p = s, *end = s + len;
+	uint64_t m = 0;
+	int digits = 0, e10 = 0, neg = 0, exp_neg = 0, e = 0, any = 0;
+	double x;
+
+	/* [-+]ddd[.ddd][(e|E)[-+]ddd], the digits are exact in m if there are at most 19 */
+	if ((p < end) && ((*p == '-') || (*p == '+')))
+		neg = (*p++ == '-');
+	for (; (p < end) && (*p >= '0') && (*p <= '9'); p++, any = 1)
+	{
+		if ((m == 0) && (*p == '0'))
+			continue;
+		if (++digits > 19)
+			return float_parse_slow(s, len);
+		m = m * 10 + (*p - '0');
+	}
+	if ((p < end) && (*p == '.'))
+	{
+		for (p++; (p < end) && (*p >= '0') && (*p <= '9'); p++, any = 1)
+		{
+			e10--;
+			if ((m == 0) && (*p == '0'))
+				continue;
+			if (++digits > 19)
+				return float_parse_slow(s, len);
+			m = m * 10 + (*p - '0');
+		}
+	}
+	if (!any)
+		return float_parse_slow(s, len);	// empty, blanks, nan, inf...
+	if ((p < end) && ((*p == 'e') || (*p == 'E')))
+	{
+		const char *q = p + 1;
+
+		if ((q < end) && ((*q == '-') || (*q == '+')))
+			exp_neg = (*q++ == '-');
+		if ((q < end) && (*q >= '0') && (*q <= '9'))
+		{
+			for (; (q < end) && (*q >= '0') && (*q <= '9'); q++)
+			{
+				if (e > 9999)
+					return float_parse_slow(s, len);
+				e = e * 10 + (*q - '0');
+			}
+			e10 += exp_neg ? -e : e;
+			p = q;
+		}
+	}
+	if (p != end)
+		return float_parse_slow(s, len);	// trailing text, let the library decide
+
+	/* exact if m and 10^|e10| are both exact doubles */
+	if (m == 0)
+		return neg ? -0.0 : 0.0;
+	if ((m > ((uint64_t)1 << 53)) || (e10 < -22) || (e10 > 22))
+		return float_parse_slow(s, len);
+	x = (double)m;
+	x = (e10 < 0) ? x / pow10_exact[-e10] : x * pow10_exact[e10];
+
+	return neg ? -x : x;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			format_u64()
+ *
+ * \brief		Decimal digits of v, at least min_digits with leading zeros.
+*/
+//-------------------------------------------------------------------------------------------------
+static int format_u64(char *buf, uint64_t v, int min_digits)
+{
+	char tmp[24];
+	int n = 0;
+
+	do
+	{
+		tmp[n++] = '0' + (char)(v % 10);
+		v /= 10;
+	} while ((v != 0) || (n < min_digits));
+	for (int i = 0; i < n; i++)
+		buf[i] = tmp[n - 1 - i];
+
+	return n;
+}
+
+
+int float_format_f(char *buf, float x)
+{
+	uint32_t bits;
+	uint64_t mant, q, rem, half;
+	int exp2, shift, n = 0;
+
+	memcpy(&bits, &x, sizeof(bits));
+	exp2 = (int)((bits >> 23) & 0xff);
+	mant = bits & 0x7fffff;
+	if ((exp2 == 0xff) || (fabsf(x) >= 1e12f))
+		return snprintf(buf, FLOAT_FMT_MAX, "%f", x);	// inf, nan, huge
+	if (exp2 == 0)
+		exp2 = 1;			// subnormal
+	else
+		mant |= 0x800000;
+	exp2 -= 150;			// x = mant * 2^exp2
+
+	/* q = round_half_even(|x| * 10^6), exactly */
+	mant *= 1000000;		// < 2^44
+	if (exp2 >= 0)
+	{
+		q = mant << exp2;	// |x| < 1e12, no overflow
+	}
+	else
+	{
+		shift = -exp2;
+		if (shift >= 64)
+		{
+			q = 0;
+		}
+		else
+		{
+			q = mant >> shift;
+			rem = mant - (q << shift);
+			half = (uint64_t)1 << (shift - 1);
+			if ((rem > half) || ((rem == half) && (q & 1)))
+				q++;
+		}
+	}
+
+	if (bits >> 31)
+		buf[n++] = '-';
+	n += format_u64(buf + n, q / 1000000, 1);
+	buf[n++] = '.';
+	n += format_u64(buf + n, q % 1000000, 6);
+	buf[n] = '\0';
+
+	return n;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			float_format_short_slow()
+ *
+ * \brief		Shortest "%.<p>g" which reads back to x, by the C library.
+*/
+//-------------------------------------------------------------------------------------------------
+static int float_format_short_slow(char *buf, float x)
+{
+	int n = 0;
+
+	for (int p = 1; p <= 9; p++)
+	{
+		n = snprintf(buf, FLOAT_FMT_MAX, "%.*g", p, x);
+		if (isnan(x) || (strtof(buf, NULL) == x))
+			break;
+	}
+	return n;
+}
+
+
+int float_format_short(char *buf, float x)
+{
+	double ax = fabs((double)x), scale, t;
+	uint64_t d;
+	int k, p, n, point, len, frac;
+	char digits[24];
+
+	if (!isfinite(x) || (x == 0) || (ax < 1e-15) || (ax >= 1e15))
+		return float_format_short_slow(buf, x);	// inf, nan, zero, far from the logged range
+
+	/* k = exponent of the first significant digit */
+	k = (int)floor(log10(ax));
+	if (pow(10, k) > ax)
+		k--;
+	else if (pow(10, k + 1) <= ax)
+		k++;
+
+	for (p = 1; p <= 9; p++)
+	{
+		/* d = |x| rounded to p significant digits */
+		if (p - 1 - k >= 0)
+		{
+			scale = (p - 1 - k <= 22) ? pow10_exact[p - 1 - k] : pow(10, p - 1 - k);
+			t = ax * scale;
+		}
+		else
+		{
+			scale = (k - p + 1 <= 22) ? pow10_exact[k - p + 1] : pow(10, k - p + 1);
+			t = ax / scale;
+		}
+		d = (uint64_t)nearbyint(t);
+		frac = p - 1 - k;				// digits after the point
+		if (d >= (uint64_t)pow10_exact[p])
+		{
+			d /= 10;					// 9.96 -> 10, one digit less after the point
+			frac--;
+		}
+
+		/* digits and decimal point: value = d * 10^-frac */
+		n = 0;
+		if (x < 0)
+			buf[n++] = '-';
+		len = format_u64(digits, d, 1);
+		point = len - frac;				// digits before the point
+		if (point <= 0)
+		{
+			buf[n++] = '0';
+			buf[n++] = '.';
+			for (int i = 0; i < -point; i++)
+				buf[n++] = '0';
+			memcpy(buf + n, digits, len);
+			n += len;
+		}
+		else if (point >= len)
+		{
+			memcpy(buf + n, digits, len);
+			n += len;
+			for (int i = len; i < point; i++)
+				buf[n++] = '0';
+		}
+		else
+		{
+			memcpy(buf + n, digits, point);
+			n += point;
+			buf[n++] = '.';
+			memcpy(buf + n, digits + point, len - point);
+			n += len - point;
+		}
+		buf[n] = '\0';
+
+		if ((float)float_parse(buf, n) == x)
+			return n;
+	}
+
+	return float_format_short_slow(buf, x);
+}
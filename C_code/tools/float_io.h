@@ -0,0 +1,81 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		float_io.h
+ *
+ * \brief		Locale-free conversion between text and float for the CSV logs and result
+ * \brief		files of the host tools. The results equal the C library, checked by
+ * \brief		tools/float_io_check.c, only faster for the short decimals of the logs.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _FLOAT_IO_H_   	        				// Re-include guard
+#define _FLOAT_IO_H_	    		        		// Re-include guard
+
+#include <stddef.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief		Buffer size which holds any output of float_format_f() and float_format_short().
+ */
+//-------------------------------------------------------------------------------------------------
+#define FLOAT_FMT_MAX		(64)
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			float_parse()
+ *
+ * \brief		Convert text to double like atof(), but the text needs no NUL terminator.
+ *				Decimals of up to 19 digits with a small exponent are converted exactly by
+ *				integer arithmetic, anything else by strtod().
+ *
+ * \param[in]	s = text.
+ * \param[in]	len = length of the text.
+ *
+ * \return		value of the text, 0 if it is not a number.
+*/
+//-------------------------------------------------------------------------------------------------
+double float_parse(const char *s, size_t len);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			float_format_f()
+ *
+ * \brief		Format a float like printf("%f"): six decimals, correctly rounded.
+ *
+ * \param[out]	buf = text, NUL terminated, at least FLOAT_FMT_MAX bytes.
+ * \param[in]	x = value.
+ *
+ * \return		length of the text.
+*/
+//-------------------------------------------------------------------------------------------------
+int float_format_f(char *buf, float x);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			float_format_short()
+ *
+ * \brief		Format a float with the fewest significant digits which read back to the same
+ *				float, e.g. 26.001724 instead of 26.001724243164062.
+ *
+ * \param[out]	buf = text, NUL terminated, at least FLOAT_FMT_MAX bytes.
+ * \param[in]	x = value.
+ *
+ * \return		length of the text.
+*/
+//-------------------------------------------------------------------------------------------------
+int float_format_short(char *buf, float x);
+
+#endif                                      // re-include guard
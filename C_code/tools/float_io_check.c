@@ -0,0 +1,190 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		float_io_check.c
+ *
+ * \brief		Host harness: round trip of float_io.c against the C library.
+ * \brief		- float_parse() equals atof() bit for bit,
+ * \brief		- float_format_f() equals printf("%f") byte for byte,
+ * \brief		- float_format_short() reads back to the same float and is not longer than the
+ * \brief		  shortest "%.<p>g" which does.
+ * \brief		Checked on every numeric field of the given logs and on random floats.
+ * \brief		Usage: float_io_check [-n random_count] file.csv...
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "float_io.h"
+#include "csv_reader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+
+static long n_checked, n_failed;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			fail()
+ *
+ * \brief		Count a failed check, the first 20 are printed.
+ *
+ * \param[in]	what = check.
+ * \param[in]	text = text formatted or parsed.
+ * \param[in]	x = value.
+*/
+//-------------------------------------------------------------------------------------------------
+static void fail(const char *what, const char *text, float x)
+{
+	if (n_failed++ < 20)
+		printf("FAIL %s: \"%s\" %.9g\n", what, text, x);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			check_format()
+ *
+ * \brief		Check both formatters on one float.
+*/
+//-------------------------------------------------------------------------------------------------
+static void check_format(float x)
+{
+	char ref[512], buf[FLOAT_FMT_MAX];
+	int p;
+
+	n_checked++;
+
+	/* %f, byte for byte */
+	snprintf(ref, sizeof(ref), "%f", x);
+	float_format_f(buf, x);
+	if (strcmp(ref, buf) != 0)
+		fail("format_f", buf, x);
+
+	/* shortest round trip */
+	if (isnan(x))
+		return;
+	float_format_short(buf, x);
+	if (strtof(buf, NULL) != x)
+	{
+		fail("format_short round trip", buf, x);
+		return;
+	}
+	for (p = 1; p < 9; p++)
+	{
+		snprintf(ref, sizeof(ref), "%.*g", p, x);
+		if (strtof(ref, NULL) == x)
+			break;
+	}
+	snprintf(ref, sizeof(ref), "%.*e", p - 1, x);	// p significant digits
+	{
+		/* count significant digits of buf */
+		int sig = 0, started = 0;
+
+		for (const char *c = buf; *c && (*c != 'e'); c++)
+		{
+			if ((*c >= '1') && (*c <= '9'))
+				started = 1;
+			if (started && (*c >= '0') && (*c <= '9'))
+				sig++;
+		}
+		/* trailing zeros of an integer part are not significant */
+		if (strchr(buf, '.') == NULL)
+		{
+			for (const char *c = buf + strlen(buf) - 1; (c > buf) && (*c == '0'); c--)
+				sig--;
+		}
+		if (sig > p)
+			fail("format_short not shortest", buf, x);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			check_parse()
+ *
+ * \brief		Check the parser on one text.
+*/
+//-------------------------------------------------------------------------------------------------
+static void check_parse(const char *s, size_t len)
+{
+	char tmp[512];
+	double ref, x;
+
+	if (len >= sizeof(tmp))
+		return;
+	memcpy(tmp, s, len);
+	tmp[len] = '\0';
+
+	n_checked++;
+	ref = atof(tmp);
+	x = float_parse(s, len);
+	if (memcmp(&ref, &x, sizeof(x)) != 0)
+		fail("parse", tmp, (float)ref);
+	check_format((float)ref);
+}
+
+
+
+
+int main(int argc, char const *argv[])
+{
+	csv_reader_t csv;
+	long n_random = 1000000;
+	uint64_t seed = 88172645463325252ull;
+	uint32_t bits;
+	float x;
+	char text[64];
+	int a = 1;
+
+	if ((argc > 2) && (strcmp(argv[1], "-n") == 0))
+	{
+		n_random = atol(argv[2]);
+		a = 3;
+	}
+
+	/* every field of the logs, the timestamp and the header are checked too */
+	for (; a < argc; a++)
+	{
+		if (csv_open(&csv, argv[a]) != 0)
+		{
+			printf("Error opening %s\n", argv[a]);
+			continue;
+		}
+		while (csv_next_row(&csv) >= 0)
+		{
+			for (size_t i = 0; i < csv.n_fields; i++)
+				check_parse(csv.fields[i].ptr, csv.fields[i].len);
+		}
+		csv_close(&csv);
+	}
+
+	/* random bit patterns, and random short decimals */
+	for (long i = 0; i < n_random; i++)
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		bits = (uint32_t)seed;
+		memcpy(&x, &bits, sizeof(x));
+		check_format(x);
+
+		snprintf(text, sizeof(text), "%.*f", (int)(seed >> 60) % 17, (double)((int64_t)(seed >> 32) - (1ll << 31)) / (double)(1 + ((seed >> 40) & 0xffff)));
+		check_parse(text, strlen(text));
+		snprintf(text, sizeof(text), "%.*e", (int)(seed >> 56) % 20, (double)x);
+		check_parse(text, strlen(text));
+	}
+
+	printf("%ld checks, %ld failed\n", n_checked, n_failed);
+
+	return n_failed ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		gen_property_table_q.c
+ *
+ * \brief		Generate src/property_table_q.c from the floating point property model.
+ * \brief		Usage: gen_property_table_q > src/property_table_q.c
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "refrigerant_property.h"
+#include "property_table_q.h"
+#include <stdio.h>
+#include <math.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			to_q16()
+ *
+ * \brief		Convert to Q16.16 with rounding.
+*/
+//-------------------------------------------------------------------------------------------------
+static long to_q16(double x)
+{
+	return (long)floor(x * Q16_ONE + 0.5);
+}
+
+
+
+
+int main(int argc, char const *argv[])
+{
+	float ts, ssh;
+	double dens_sat, dens;
+
+	printf("//*************************************************************************\r\n");
+	printf("//*************************************************************************\r\n");
+	printf("/**\r\n");
+	printf(" * \\file\t\tproperty_table_q.c\r\n");
+	printf(" *\r\n");
+	printf(" * \\brief\t\tLookup tables of R410A gas density for the fixed-point prediction.\r\n");
+	printf(" * \\brief\t\tGENERATED by tools/gen_property_table_q.c, do not edit.\r\n");
+	printf(" *\r\n");
+	printf(" * \\copyright\tCARRIER CONFIDENTIAL & PROPRIETARY\r\n");
+	printf(" *\t\t\t\tCOPYRIGHT, CARRIER CORPORATION, 2020\r\n");
+	printf(" *\t\t\t\tUNPUBLISHED WORK, ALL RIGHTS RESERVED\r\n");
+	printf(" *\r\n");
+	printf(" * \\author\t\tJulien Wang\r\n");
+	printf("*/\r\n");
+	printf("//*************************************************************************\r\n");
+	printf("//*************************************************************************\r\n");
+	printf("#include \"property_table_q.h\"\r\n\r\n\r\n");
+
+	/* saturated gas */
+	printf("const q16_t dens_sat_q[DENS_SAT_N] = {\r\n");
+	for (int i = 0; i < DENS_SAT_N; i++)
+	{
+		ts = DENS_SAT_TS_MIN + (i << DENS_SAT_TS_SHIFT);
+		printf("%s%ld,%s", (i % 8) ? " " : "\t", to_q16(1/cal_vol_sat_gas_ts(ts)), (i % 8 == 7) ? "\r\n" : "");
+	}
+	printf("};\r\n\r\n\r\n");
+
+	/* superheated gas, the saturated density is used where the model has no real solution */
+	printf("const q16_t dens_sh_q[DENS_SH_TS_N][DENS_SH_SSH_N] = {\r\n");
+	for (int i = 0; i < DENS_SH_TS_N; i++)
+	{
+		ts = DENS_SH_TS_MIN + (i << DENS_SH_TS_SHIFT);
+		dens_sat = 1/cal_vol_sat_gas_ts(ts);
+		printf("\t{");
+		for (int j = 0; j < DENS_SH_SSH_N; j++)
+		{
+			ssh = j << DENS_SH_SSH_SHIFT;
+			dens = cal_dens_sh_gas_ts(ts, ts + ssh);
+			if (!isfinite(dens))
+			{
+				dens = dens_sat;
+			}
+			printf("%s%ld", (j == 0) ? "" : (j % 8) ? ", " : ",\r\n\t ", to_q16(dens));
+		}
+		printf("},\r\n");
+	}
+	printf("};\r\n");
+
+	return 0;
+}
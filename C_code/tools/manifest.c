@@ -0,0 +1,364 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		manifest.c
+ *
+ * \brief		Manifest of an incremental batch for the host tools.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "manifest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define MANIFEST_MAGIC		"# manifest 3"
+#define MANIFEST_LINE_MAX	(2 * MANIFEST_PATH_MAX + 256)
+#define MANIFEST_DATA_EXT	".dat"
+
+
+
+
+uint64_t manifest_hash(uint64_t h, const void *data, size_t n)
+{
+	const unsigned char *p = data;
+
+	for (size_t i = 0; i < n; i++)
+	{
+		h ^= p[i];
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_cmp()
+ *
+ * \brief		qsort() and bsearch() order of the entries: by src, the key of manifest_find().
+*/
+//-------------------------------------------------------------------------------------------------
+static int manifest_cmp(const void *a, const void *b)
+{
+	return strcmp(((const manifest_entry_t *)a)->src, ((const manifest_entry_t *)b)->src);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_field()
+ *
+ * \brief		Copy the next TAB or line end terminated field of a line.
+ *
+ * \return		the rest of the line after the field, NULL if the field is too long or missing.
+*/
+//-------------------------------------------------------------------------------------------------
+static char *manifest_field(char *p, char *dst, size_t size)
+{
+	size_t len = strcspn(p, "\t\r\n");
+
+	if ((len == 0) || (len >= size))
+		return NULL;
+	memcpy(dst, p, len);
+	dst[len] = '\0';
+	return p + len + (p[len] == '\t');
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_data_load()
+ *
+ * \brief		Read the data file of a manifest, it must have the size and hash recorded in
+ *				the manifest, else it is from another save and the data is dropped.
+ *
+ * \return		the bytes, NULL if there are none or they do not belong to the manifest.
+*/
+//-------------------------------------------------------------------------------------------------
+static unsigned char *manifest_data_load(const char *path, int64_t size, uint64_t hash)
+{
+	char name[MANIFEST_PATH_MAX + 8];
+	unsigned char *buf;
+	FILE *fp;
+	size_t got;
+
+	if (size <= 0)
+		return NULL;
+	snprintf(name, sizeof(name), "%s" MANIFEST_DATA_EXT, path);
+	if ((fp = fopen(name, "rb")) == NULL)
+		return NULL;
+	if ((buf = malloc((size_t)size + 1)) == NULL)
+	{
+		fclose(fp);
+		return NULL;
+	}
+	got = fread(buf, 1, (size_t)size + 1, fp);
+	fclose(fp);
+	if ((got != (size_t)size) || (manifest_hash(MANIFEST_HASH_INIT, buf, got) != hash))
+	{
+		free(buf);
+		return NULL;
+	}
+	return buf;
+}
+
+
+long manifest_load(manifest_t *m, const char *path, uint64_t config)
+{
+	FILE *fp;
+	char line[MANIFEST_LINE_MAX];
+	manifest_entry_t e;
+	uint64_t file_config, data_hash;
+	int64_t data_size, pos = 0;
+	unsigned char *data = NULL;
+	size_t len;
+	char *p;
+	int n;
+
+	memset(m, 0, sizeof(*m));
+	m->config = config;
+	m->sorted = 1;
+	if ((fp = fopen(path, "r")) == NULL)
+		return 0;
+
+	/* magic, then the configuration and the data file, else an empty manifest */
+	if ((fgets(line, sizeof(line), fp) == NULL) || (strncmp(line, MANIFEST_MAGIC, strlen(MANIFEST_MAGIC)) != 0) ||
+		(fgets(line, sizeof(line), fp) == NULL) || (sscanf(line, "config %" SCNx64, &file_config) != 1) ||
+		(file_config != config) ||
+		(fgets(line, sizeof(line), fp) == NULL) ||
+		(sscanf(line, "data %" SCNd64 " %" SCNx64, &data_size, &data_hash) != 2))
+	{
+		fclose(fp);
+		return 0;
+	}
+	data = manifest_data_load(path, data_size, data_hash);
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		memset(&e, 0, sizeof(e));
+		if ((sscanf(line, "%" SCNd64 "\t%" SCNd64 "\t%" SCNx64 "\t%" SCNd64 "\t%" SCNd64 "\t%" SCNx64 "\t%ld\t%ld\t%zu\t%n",
+					&e.size, &e.mtime_ns, &e.hash, &e.out_size, &e.out_mtime_ns, &e.out_hash, &e.rows, &e.gaps,
+					&len, &n) != 9))
+		{
+			/* the data of the lines after it can not be found */
+			free(data);
+			data = NULL;
+			continue;
+		}
+		p = manifest_field(line + n, e.src, sizeof(e.src));
+		if ((p == NULL) || (manifest_field(p, e.dest, sizeof(e.dest)) == NULL))
+		{
+			pos += (int64_t)len;
+			continue;
+		}
+
+		/* the data of the entries in line order */
+		if ((data != NULL) && (pos + (int64_t)len <= data_size))
+		{
+			e.data = data + pos;
+			e.data_size = len;
+		}
+		pos += (int64_t)len;
+		if (manifest_put(m, &e) != 0)
+		{
+			free(data);
+			fclose(fp);
+			return -1;
+		}
+	}
+	free(data);
+	fclose(fp);
+
+	return (long)m->n;
+}
+
+
+int manifest_stat(const char *path, int64_t *size, int64_t *mtime_ns)
+{
+	struct stat st;
+
+	if (stat(path, &st) != 0)
+		return -1;
+	*size = (int64_t)st.st_size;
+	*mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+	return 0;
+}
+
+
+int manifest_file_hash(const char *path, uint64_t *hash)
+{
+	FILE *fp;
+	char *buf;
+	size_t got;
+	uint64_t h = MANIFEST_HASH_INIT;
+	int ret = 0;
+
+	if ((fp = fopen(path, "rb")) == NULL)
+		return -1;
+	if ((buf = malloc(1 << 16)) == NULL)
+	{
+		fclose(fp);
+		return -1;
+	}
+	while ((got = fread(buf, 1, 1 << 16, fp)) > 0)
+		h = manifest_hash(h, buf, got);
+	if (ferror(fp))
+		ret = -1;
+	free(buf);
+	fclose(fp);
+
+	*hash = h;
+	return ret;
+}
+
+
+manifest_entry_t *manifest_find(manifest_t *m, const char *src)
+{
+	manifest_entry_t key;
+
+	if (!m->sorted)
+	{
+		qsort(m->e, m->n, sizeof(manifest_entry_t), manifest_cmp);
+		m->sorted = 1;
+	}
+	snprintf(key.src, sizeof(key.src), "%s", src);
+	return (m->n != 0) ? bsearch(&key, m->e, m->n, sizeof(manifest_entry_t), manifest_cmp) : NULL;
+}
+
+
+int manifest_fresh(manifest_entry_t *e, const char *dest)
+{
+	int64_t size, mtime_ns;
+	uint64_t hash;
+
+	if ((strcmp(e->dest, dest) != 0) || (manifest_stat(dest, &size, &mtime_ns) != 0) || (size != e->out_size))
+		return 0;
+	if (mtime_ns != e->out_mtime_ns)
+	{
+		/* rewritten with the same size, or copied */
+		if ((manifest_file_hash(dest, &hash) != 0) || (hash != e->out_hash))
+			return 0;
+		e->out_mtime_ns = mtime_ns;
+	}
+	if (manifest_stat(e->src, &size, &mtime_ns) != 0)
+		return 0;
+	if ((size == e->size) && (mtime_ns == e->mtime_ns))
+		return 1;
+
+	/* touched or copied, compare the content */
+	if ((size != e->size) || (manifest_file_hash(e->src, &hash) != 0) || (hash != e->hash))
+		return 0;
+	e->mtime_ns = mtime_ns;
+	return 1;
+}
+
+
+int manifest_put(manifest_t *m, const manifest_entry_t *e)
+{
+	manifest_entry_t *old = manifest_find(m, e->src);
+	manifest_entry_t *p;
+
+	void *data = NULL;
+
+	if (e->data_size != 0)
+	{
+		if ((data = malloc(e->data_size)) == NULL)
+			return -1;
+		memcpy(data, e->data, e->data_size);
+	}
+	if (old != NULL)
+	{
+		free(old->data);
+		*old = *e;
+		old->data = data;
+		return 0;
+	}
+	if (m->n == m->cap)
+	{
+		m->cap = m->cap ? m->cap * 2 : 64;
+		if ((p = realloc(m->e, m->cap * sizeof(manifest_entry_t))) == NULL)
+		{
+			free(data);
+			return -1;
+		}
+		m->e = p;
+	}
+	m->e[m->n] = *e;
+	m->e[m->n++].data = data;
+	m->sorted = (m->n == 1) || (m->sorted && (manifest_cmp(&m->e[m->n - 2], &m->e[m->n - 1]) < 0));
+	return 0;
+}
+
+
+int manifest_save(manifest_t *m, const char *path)
+{
+	char tmp[MANIFEST_PATH_MAX + 16];
+	char name[MANIFEST_PATH_MAX + 8];
+	FILE *fp;
+	const manifest_entry_t *e;
+	int64_t data_size = 0;
+	uint64_t data_hash = MANIFEST_HASH_INIT;
+
+	manifest_find(m, "");	// sort
+
+	/* data file first, the manifest records its size and hash */
+	snprintf(name, sizeof(name), "%s" MANIFEST_DATA_EXT, path);
+	snprintf(tmp, sizeof(tmp), "%s.tmp", name);
+	if ((fp = fopen(tmp, "wb")) == NULL)
+		return -1;
+	for (size_t i = 0; i < m->n; i++)
+	{
+		e = &m->e[i];
+		fwrite(e->data, 1, e->data_size, fp);
+		data_size += (int64_t)e->data_size;
+		data_hash = manifest_hash(data_hash, e->data, e->data_size);
+	}
+	if ((fclose(fp) != 0) || (rename(tmp, name) != 0))
+	{
+		remove(tmp);
+		return -1;
+	}
+
+	snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+	if ((fp = fopen(tmp, "w")) == NULL)
+		return -1;
+	fprintf(fp, "%s\nconfig %016" PRIx64 "\ndata %" PRId64 " %016" PRIx64 "\n", MANIFEST_MAGIC, m->config,
+			data_size, data_hash);
+	for (size_t i = 0; i < m->n; i++)
+	{
+		e = &m->e[i];
+		fprintf(fp, "%" PRId64 "\t%" PRId64 "\t%016" PRIx64 "\t%" PRId64 "\t%" PRId64 "\t%016" PRIx64 "\t%ld\t%ld\t%zu\t%s\t%s\n",
+				e->size, e->mtime_ns, e->hash, e->out_size, e->out_mtime_ns, e->out_hash, e->rows, e->gaps,
+				e->data_size, e->src, e->dest);
+	}
+	if (fclose(fp) != 0)
+	{
+		remove(tmp);
+		return -1;
+	}
+	return rename(tmp, path);
+}
+
+
+void manifest_free(manifest_t *m)
+{
+	for (size_t i = 0; i < m->n; i++)
+		free(m->e[i].data);
+	free(m->e);
+	memset(m, 0, sizeof(*m));
+}
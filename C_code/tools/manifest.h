@@ -0,0 +1,221 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		manifest.h
+ *
+ * \brief		Manifest of an incremental batch for the host tools: for every input and its
+ * \brief		output the size, modification time and content hash they had when the output
+ * \brief		was made, together with one hash of the configuration. An output is up to date
+ * \brief		if the configuration is the same and both files are unchanged; a content hash
+ * \brief		is only read again if the size is the same but the time changed.
+ * \brief		Text file, one input per line:
+ * \brief		size <TAB> mtime_ns <TAB> hash <TAB> out_size <TAB> out_mtime_ns <TAB> out_hash <TAB>
+ * \brief		rows <TAB> gaps <TAB> data_size <TAB> src <TAB> dest
+ * \brief		Every entry can carry data of the tool, e.g. statistics of the output, which is
+ * \brief		kept in the binary file <manifest>.dat, the data of the entries in line order.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _MANIFEST_H_   	        				// Re-include guard
+#define _MANIFEST_H_	    		        		// Re-include guard
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define MANIFEST_PATH_MAX	(1024)
+#define MANIFEST_HASH_INIT	(0xcbf29ce484222325ULL)	// FNV-1a 64 offset basis
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		manifest_entry_t
+ * \brief		One input and its output.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	char src[MANIFEST_PATH_MAX];
+	char dest[MANIFEST_PATH_MAX];
+	int64_t size;			// input
+	int64_t mtime_ns;
+	uint64_t hash;
+	int64_t out_size;		// output
+	int64_t out_mtime_ns;
+	uint64_t out_hash;
+	long rows;				// counts reported by the tool for the output
+	long gaps;
+	void *data;				// data of the tool, NULL if none or lost, owned by the manifest
+	size_t data_size;
+} manifest_entry_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		manifest_t
+ * \brief		Entries sorted by src for manifest_find().
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	uint64_t config;		// hash of the configuration the entries were made with
+	manifest_entry_t *e;
+	size_t n;
+	size_t cap;
+	int sorted;
+} manifest_t;
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_hash()
+ *
+ * \brief		FNV-1a 64 over n bytes, start with MANIFEST_HASH_INIT.
+ *
+ * \param[in]	h = hash so far.
+ * \param[in]	data = bytes.
+ * \param[in]	n = number of bytes.
+ *
+ * \return		the hash.
+*/
+//-------------------------------------------------------------------------------------------------
+uint64_t manifest_hash(uint64_t h, const void *data, size_t n);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_load()
+ *
+ * \brief		Read a manifest and its data file. The entries are dropped if they were made
+ *				with another configuration, a missing file gives an empty manifest. Data which
+ *				does not match the manifest is dropped, the entries are kept without it.
+ *
+ * \param[out]	m = manifest.
+ * \param[in]	path = file name.
+ * \param[in]	config = hash of the current configuration.
+ *
+ * \return		number of entries kept, -1 if the file can not be read.
+*/
+//-------------------------------------------------------------------------------------------------
+long manifest_load(manifest_t *m, const char *path, uint64_t config);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_stat()
+ *
+ * \brief		Size and modification time of a file.
+ *
+ * \param[in]	path = file name.
+ * \param[out]	size = size in bytes.
+ * \param[out]	mtime_ns = modification time in ns.
+ *
+ * \return		0 if ok, -1 if the file does not exist.
+*/
+//-------------------------------------------------------------------------------------------------
+int manifest_stat(const char *path, int64_t *size, int64_t *mtime_ns);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_file_hash()
+ *
+ * \brief		Content hash of a file.
+ *
+ * \param[in]	path = file name.
+ * \param[out]	hash = FNV-1a 64 of the bytes.
+ *
+ * \return		0 if ok, -1 if the file can not be read.
+*/
+//-------------------------------------------------------------------------------------------------
+int manifest_file_hash(const char *path, uint64_t *hash);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_find()
+ *
+ * \brief		Entry of an input.
+ *
+ * \param[in]	m = manifest.
+ * \param[in]	src = input file name as recorded.
+ *
+ * \return		the entry, NULL if there is none.
+*/
+//-------------------------------------------------------------------------------------------------
+manifest_entry_t *manifest_find(manifest_t *m, const char *src);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_fresh()
+ *
+ * \brief		Check if the output of an entry is up to date: the output and the input each
+ *				have the recorded size and time, or else the recorded content. The time of a
+ *				file found unchanged by its content is updated.
+ *
+ * \param[in]	e = entry.
+ * \param[in]	dest = output file name of the current run.
+ *
+ * \return		1 if up to date, 0 if the output must be made again.
+*/
+//-------------------------------------------------------------------------------------------------
+int manifest_fresh(manifest_entry_t *e, const char *dest);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_put()
+ *
+ * \brief		Add or replace the entry of an input.
+ *
+ * \param[in]	m = manifest.
+ * \param[in]	e = entry, src is the key; its data is copied.
+ *
+ * \return		0 if ok, -1 if out of memory.
+*/
+//-------------------------------------------------------------------------------------------------
+int manifest_put(manifest_t *m, const manifest_entry_t *e);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_save()
+ *
+ * \brief		Write the manifest and its data file to temporary files and rename them, so an
+ *				interrupted batch leaves the old manifest.
+ *
+ * \param[in]	m = manifest.
+ * \param[in]	path = file name.
+ *
+ * \return		0 if ok, -1 if the file can not be written.
+*/
+//-------------------------------------------------------------------------------------------------
+int manifest_save(manifest_t *m, const char *path);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			manifest_free()
+ *
+ * \brief		Free the entries.
+ *
+ * \param[in]	m = manifest.
+*/
+//-------------------------------------------------------------------------------------------------
+void manifest_free(manifest_t *m);
+
+#endif                                      // re-include guard
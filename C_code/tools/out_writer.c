@@ -0,0 +1,205 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		out_writer.c
+ *
+ * \brief		Buffered output for the host tools.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "out_writer.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			out_thread()
+ *
+ * \brief		Writer thread, writes buf[!cur] whenever pending is set.
+*/
+//-------------------------------------------------------------------------------------------------
+static void *out_thread(void *arg)
+{
+	out_writer_t *w = arg;
+	const char *buf;
+	size_t n;
+
+	pthread_mutex_lock(&w->lock);
+	for (;;)
+	{
+		while ((w->pending == 0) && !w->stop)
+			pthread_cond_wait(&w->cond, &w->lock);
+		if (w->pending == 0)
+			break;
+
+		/* the caller does not touch buf[!cur] until pending is cleared */
+		buf = w->buf[!w->cur];
+		n = w->pending;
+		pthread_mutex_unlock(&w->lock);
+		if (fwrite(buf, 1, n, w->fp) != n)
+			w->error = 1;
+		pthread_mutex_lock(&w->lock);
+		w->pending = 0;
+		pthread_cond_broadcast(&w->cond);
+	}
+	pthread_mutex_unlock(&w->lock);
+	return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			out_flush()
+ *
+ * \brief		Write buf[cur], or hand it to the writer thread and switch buffers.
+*/
+//-------------------------------------------------------------------------------------------------
+static void out_flush(out_writer_t *w)
+{
+	if ((w->len == 0) || (w->fp == NULL))
+		return;
+	if (!w->background)
+	{
+		if (fwrite(w->buf[0], 1, w->len, w->fp) != w->len)
+			w->error = 1;
+		w->len = 0;
+		return;
+	}
+
+	pthread_mutex_lock(&w->lock);
+	while (w->pending != 0)
+		pthread_cond_wait(&w->cond, &w->lock);
+	w->pending = w->len;
+	w->cur = !w->cur;
+	pthread_cond_broadcast(&w->cond);
+	pthread_mutex_unlock(&w->lock);
+	w->len = 0;
+}
+
+
+int out_open(out_writer_t *w, const char *path, size_t cap, int background)
+{
+	memset(w, 0, sizeof(*w));
+	w->cap = cap ? cap : OUT_BUF_SIZE;
+	if (path == NULL)
+	{
+		/* memory, the buffer grows */
+		return ((w->buf[0] = malloc(w->cap)) != NULL) ? 0 : -1;
+	}
+	w->background = background;
+	if ((w->fp = fopen(path, "wb")) == NULL)
+		return -1;
+	/* the buffers here are the only buffering */
+	setvbuf(w->fp, NULL, _IONBF, 0);
+
+	w->buf[0] = malloc(w->cap);
+	w->buf[1] = background ? malloc(w->cap) : NULL;
+	if ((w->buf[0] == NULL) || (background && (w->buf[1] == NULL)))
+		goto fail;
+	if (background)
+	{
+		pthread_mutex_init(&w->lock, NULL);
+		pthread_cond_init(&w->cond, NULL);
+		if (pthread_create(&w->thread, NULL, out_thread, w) != 0)
+		{
+			pthread_cond_destroy(&w->cond);
+			pthread_mutex_destroy(&w->lock);
+			goto fail;
+		}
+	}
+	return 0;
+
+fail:
+	free(w->buf[0]);
+	free(w->buf[1]);
+	fclose(w->fp);
+	return -1;
+}
+
+
+char *out_reserve(out_writer_t *w, size_t n)
+{
+	char *buf;
+
+	if (w->len + n <= w->cap)
+		return w->buf[w->cur] + w->len;
+	if (w->fp != NULL)
+	{
+		out_flush(w);
+		return w->buf[w->cur];
+	}
+
+	/* memory: double the buffer, on failure keep it and drop the bytes */
+	if ((buf = realloc(w->buf[0], (w->cap + n) * 2)) == NULL)
+	{
+		w->error = 1;
+		w->len = 0;
+		return w->buf[0];
+	}
+	w->buf[0] = buf;
+	w->cap = (w->cap + n) * 2;
+	return w->buf[0] + w->len;
+}
+
+
+void out_commit(out_writer_t *w, size_t n)
+{
+	w->len += n;
+}
+
+
+void out_puts(out_writer_t *w, const char *s)
+{
+	size_t n = strlen(s);
+
+	memcpy(out_reserve(w, n), s, n);
+	out_commit(w, n);
+}
+
+
+void out_write(out_writer_t *w, const void *data, size_t n)
+{
+	const char *p = data;
+	size_t k;
+
+	/* in pieces of at most one buffer */
+	while (n > 0)
+	{
+		k = (n < w->cap) ? n : w->cap;
+		memcpy(out_reserve(w, k), p, k);
+		out_commit(w, k);
+		p += k;
+		n -= k;
+	}
+}
+
+
+int out_close(out_writer_t *w)
+{
+	out_flush(w);
+	if (w->background)
+	{
+		pthread_mutex_lock(&w->lock);
+		w->stop = 1;
+		pthread_cond_broadcast(&w->cond);
+		pthread_mutex_unlock(&w->lock);
+		pthread_join(w->thread, NULL);
+		pthread_cond_destroy(&w->cond);
+		pthread_mutex_destroy(&w->lock);
+	}
+	if ((w->fp != NULL) && (fclose(w->fp) != 0))
+		w->error = 1;
+	free(w->buf[0]);
+	free(w->buf[1]);
+
+	return w->error ? -1 : 0;
+}
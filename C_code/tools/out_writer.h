@@ -0,0 +1,150 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		out_writer.h
+ *
+ * \brief		Buffered output for the host tools. Rows are formatted straight into a large
+ * \brief		buffer which is written to the file in one chunk when it is full.
+ * \brief		In background mode there are two buffers: a full buffer is handed to a writer
+ * \brief		thread and the caller goes on filling the other one, so it only waits when
+ * \brief		the disk is slower than the formatting.
+ * \brief		Without a file the writer keeps everything in memory, the buffer grows as needed;
+ * \brief		the bytes are buf[0][0...len-1] until out_close().
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _OUT_WRITER_H_   	        				// Re-include guard
+#define _OUT_WRITER_H_	    		        		// Re-include guard
+
+#include <stdio.h>
+#include <stddef.h>
+#include <pthread.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define OUT_BUF_SIZE		(1 << 20)	// default size of one buffer in bytes
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		out_writer_t
+ * \brief		State of one output file.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	FILE *fp;
+	char *buf[2];
+	size_t cap;				// size of one buffer
+	int cur;				// buffer being filled
+	size_t len;				// bytes in buf[cur]
+	int error;				// 1 after a failed write
+	int background;			// 1 if a writer thread owns the file
+	/* background mode, the fields below are shared under lock */
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	size_t pending;			// bytes of buf[!cur] waiting for the thread, 0 if none
+	int stop;
+} out_writer_t;
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			out_open()
+ *
+ * \brief		Create an output file.
+ *
+ * \param[out]	w = writer.
+ * \param[in]	path = file name, NULL to write to memory.
+ * \param[in]	cap = size of one buffer, 0 for OUT_BUF_SIZE.
+ * \param[in]	background = 1 to write from a writer thread, not used for memory.
+ *
+ * \return		0 if ok, -1 if the file can not be created.
+*/
+//-------------------------------------------------------------------------------------------------
+int out_open(out_writer_t *w, const char *path, size_t cap, int background);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			out_reserve()
+ *
+ * \brief		Room for n more bytes at the end of the buffer, the buffer is flushed first if
+ * \brief		needed. The bytes count after out_commit().
+ *
+ * \param[in]	w = writer.
+ * \param[in]	n = bytes needed, at most the size of one buffer if writing to a file.
+ *
+ * \return		where to write the bytes.
+*/
+//-------------------------------------------------------------------------------------------------
+char *out_reserve(out_writer_t *w, size_t n);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			out_commit()
+ *
+ * \brief		Add n bytes written after out_reserve().
+ *
+ * \param[in]	w = writer.
+ * \param[in]	n = bytes written, not more than reserved.
+*/
+//-------------------------------------------------------------------------------------------------
+void out_commit(out_writer_t *w, size_t n);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			out_puts()
+ *
+ * \brief		Add a string.
+ *
+ * \param[in]	w = writer.
+ * \param[in]	s = string, at most the size of one buffer.
+*/
+//-------------------------------------------------------------------------------------------------
+void out_puts(out_writer_t *w, const char *s);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			out_write()
+ *
+ * \brief		Add n bytes of any length, e.g. the contents of a memory writer.
+ *
+ * \param[in]	w = writer.
+ * \param[in]	data = bytes.
+ * \param[in]	n = number of bytes.
+*/
+//-------------------------------------------------------------------------------------------------
+void out_write(out_writer_t *w, const void *data, size_t n);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			out_close()
+ *
+ * \brief		Write what is left, stop the writer thread and close the file, or free the memory.
+ *
+ * \param[in]	w = writer.
+ *
+ * \return		0 if ok, -1 if a write failed.
+*/
+//-------------------------------------------------------------------------------------------------
+int out_close(out_writer_t *w);
+
+#endif                                      // re-include guard
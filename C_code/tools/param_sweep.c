@@ -0,0 +1,616 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		param_sweep.c
+ *
+ * \brief		Host harness: evaluate sets of model constants (FW, the tau schedule, the
+ * \brief		compressor coefficients) against logged data and rank them by the error.
+ * \brief		The logs are loaded into memory once, then the parameter sets are replayed
+ * \brief		in parallel, one set per thread at a time, each with its own estimator context.
+ * \brief		Usage: param_sweep [-j threads] [-y t_dis|t_dis_delay|p_dis_curr] [-m rmse|mae|p95|max|bias]
+ * \brief		                   [-fw list] [-tau-off list] [-tau-start list] [-tau-run list]
+ * \brief		                   [-coe file] [-n top] [-o all.csv] file.csv...
+ * \brief		A list is "v1,v2,..." or "first:last:step". The grid is every combination of the
+ * \brief		lists; a list which is not given holds the default of estimator_default_params().
+ * \brief		The -coe file holds one set of COMP_COE_N coefficients per line, '#' starts a comment.
+ * \brief		-y t_dis and t_dis_delay use the *tdis.csv logs, p_dis_curr the *current.csv logs.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "sensor_predict.h"
+#include "compressor_model.h"
+#include "csv_reader.h"
+#include "err_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define SWEEP_LIST_MAX		(256)		// values of one list
+#define SWEEP_INTERVAL		(2.0f)		// sample interval in s without a timestamp, as sensor_replay
+#define SWEEP_GAP_MAX		(300.0f)	// interval in s which seeds the delay again, as sensor_replay
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		sweep_output_t
+ * \brief		Output which is compared with the measurement.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	OUT_T_DIS = 0,		// t_dis against T_dis
+	OUT_T_DIS_DELAY,	// t_dis_delay against T_dis
+	OUT_P_DIS_CURR,		// P_dis against Pd
+	OUT_N
+} sweep_output_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		sweep_metric_t
+ * \brief		Rank of the parameter sets, smaller is better.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	MET_RMSE = 0,
+	MET_MAE,
+	MET_P95,
+	MET_MAX,
+	MET_BIAS,			// |bias|
+	MET_N
+} sweep_metric_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		sweep_row_t
+ * \brief		One logged sample, only the signals used by the estimator and the measurement.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	float p_suc_g;
+	float t_suc;
+	float p_dis_g;
+	float compSpeed;
+	float I_test;
+	float meas;			// T_dis or Pd
+	float T_interval;	// from the timestamps
+	est_phase_t phase;
+} sweep_row_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		sweep_log_t
+ * \brief		One log in memory.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	sweep_row_t *rows;
+	size_t n;
+} sweep_log_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		sweep_set_t
+ * \brief		One parameter set and its error.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	estimator_params_t params;
+	int coe_index;		// line of the -coe file, -1 for COE_32[]
+	size_t index;		// position in the grid
+	err_stats_t stats;
+	double score;
+} sweep_set_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		sweep_pool_t
+ * \brief		Work shared by the threads. The next set is taken under the lock.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	const sweep_log_t *logs;
+	size_t n_logs;
+	sweep_set_t *sets;
+	size_t n_sets;
+	size_t next;
+	sweep_output_t output;
+	pthread_mutex_t lock;
+} sweep_pool_t;
+
+
+
+
+static const char *const sweep_output_names[OUT_N] = {"t_dis", "t_dis_delay", "p_dis_curr"};
+static const char *const sweep_metric_names[MET_N] = {"rmse", "mae", "p95", "max", "bias"};
+static sweep_metric_t sweep_metric;		// -m, set before sorting
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sweep_list()
+ *
+ * \brief		Parse "v1,v2,..." or "first:last:step".
+ *
+ * \return		number of values, 0 if the list is not valid.
+*/
+//-------------------------------------------------------------------------------------------------
+static int sweep_list(const char *arg, double *v, int max)
+{
+	double first, last, step;
+	char *end;
+	int n = 0;
+
+	if ((sscanf(arg, "%lf:%lf:%lf", &first, &last, &step) == 3) && (strchr(arg, ':') != NULL))
+	{
+		if ((step <= 0) || (last < first))
+			return 0;
+		/* last is included, allow for the rounding of step */
+		for (; (n < max) && (first + n * step <= last + step * 1e-6); n++)
+			v[n] = first + n * step;
+		return n;
+	}
+
+	while ((n < max) && (*arg != '\0'))
+	{
+		v[n++] = strtod(arg, &end);
+		if ((end == arg) || ((*end != ',') && (*end != '\0')))
+			return 0;
+		arg = (*end == ',') ? end + 1 : end;
+	}
+	return n;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sweep_read_coe()
+ *
+ * \brief		Read the coefficient sets of a -coe file.
+ *
+ * \return		number of sets in *coe, -1 on error.
+*/
+//-------------------------------------------------------------------------------------------------
+static int sweep_read_coe(const char *path, float **coe)
+{
+	FILE *fp;
+	char line[4096], *p, *end;
+	int n = 0, k;
+
+	if ((fp = fopen(path, "r")) == NULL)
+		return -1;
+	*coe = NULL;
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		if ((p = strchr(line, '#')) != NULL)
+			*p = '\0';
+		for (p = line; (*p == ' ') || (*p == '\t'); p++);
+		if ((*p == '\0') || (*p == '\n') || (*p == '\r'))
+			continue;
+
+		if ((*coe = realloc(*coe, (n + 1) * COMP_COE_N * sizeof(float))) == NULL)
+			break;
+		for (k = 0; k < COMP_COE_N; k++)
+		{
+			(*coe)[n * COMP_COE_N + k] = strtof(p, &end);
+			if (end == p)
+				break;
+			for (p = end; (*p == ',') || (*p == ' ') || (*p == '\t'); p++);
+		}
+		if (k != COMP_COE_N)
+		{
+			printf("%s: line %d has %d coefficients, %d needed\n", path, n + 1, k, COMP_COE_N);
+			break;
+		}
+		n++;
+	}
+	fclose(fp);
+	if ((*coe == NULL) || (k != COMP_COE_N))
+	{
+		free(*coe);
+		return -1;
+	}
+	return n;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sweep_load()
+ *
+ * \brief		Load one log into memory.
+ *
+ * \return		0 if ok, -1 if the file can not be opened, -2 if a column is missing.
+*/
+//-------------------------------------------------------------------------------------------------
+static int sweep_load(const char *path, sweep_output_t output, sweep_log_t *log)
+{
+	enum {COL_PD = 0, COL_PS, COL_SPEED, COL_ST, COL_WORK_MINUTES, COL_COMP_CU, COL_T_DIS, COL_N};
+	static const char *const tdis_cols[COL_N] = {"Pd", "Ps", "CompSpeed", "ST", "WORK_MINUTES", NULL, "T_dis"};
+	static const char *const curr_cols[COL_N] = {"Pd", "Ps", "CompSpeed", NULL, "WORK_MINUTES", "Comp_cu", NULL};
+	csv_reader_t csv;
+	int col[COL_N];
+	float data[COL_N];
+	int64_t time, pre_time = CSV_TIME_NONE;
+	size_t cap = 0;
+	sweep_row_t *r;
+
+	if (csv_open(&csv, path) != 0)
+		return -1;
+	if ((csv_next_row(&csv) < 0) ||
+		(csv_bind(&csv, (output == OUT_P_DIS_CURR) ? curr_cols : tdis_cols, COL_N, col) != 0))
+	{
+		csv_close(&csv);
+		return -2;
+	}
+
+	log->rows = NULL;
+	log->n = 0;
+	while (csv_next_row(&csv) >= 0)
+	{
+		if (!csv_row_project(&csv, col, COL_N, data))
+			continue;
+		if (log->n == cap)
+		{
+			cap = cap ? cap * 2 : 4096;
+			if ((r = realloc(log->rows, cap * sizeof(sweep_row_t))) == NULL)
+				break;
+			log->rows = r;
+		}
+		r = &log->rows[log->n++];
+		r->p_suc_g = data[COL_PS];
+		r->t_suc = data[COL_ST];
+		r->p_dis_g = data[COL_PD];
+		r->compSpeed = data[COL_SPEED];
+		r->I_test = data[COL_COMP_CU];
+		r->meas = (output == OUT_P_DIS_CURR) ? data[COL_PD] : data[COL_T_DIS];
+		r->phase = estimator_phase(data[COL_WORK_MINUTES]);
+
+		/* interval like sensor_replay */
+		time = csv_field_time_ms(&csv.fields[0]);
+		if ((time == CSV_TIME_NONE) || (pre_time == CSV_TIME_NONE))
+			r->T_interval = SWEEP_INTERVAL;
+		else
+			r->T_interval = (time > pre_time) ? (time - pre_time) * 0.001f : 0;
+		if (time != CSV_TIME_NONE)
+			pre_time = time;
+	}
+	csv_close(&csv);
+
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sweep_eval()
+ *
+ * \brief		Replay every log with one parameter set.
+*/
+//-------------------------------------------------------------------------------------------------
+static void sweep_eval(const sweep_pool_t *pool, sweep_set_t *set)
+{
+	static const unsigned int masks[OUT_N] = {EST_OUT_TDIS, EST_OUT_TDIS | EST_OUT_TDIS_DELAY, EST_OUT_PDIS_CURR};
+	estimator_ctx_t ctx;
+	estimator_sample_t sample = {0};
+	estimator_outputs_t out;
+	const sweep_row_t *r;
+	float pred;
+	unsigned int bit;
+
+	stats_init(&set->stats);
+	bit = (pool->output == OUT_T_DIS) ? EST_OUT_TDIS :
+		  (pool->output == OUT_T_DIS_DELAY) ? EST_OUT_TDIS_DELAY : EST_OUT_PDIS_CURR;
+	sample.U = 220;
+
+	for (size_t l = 0; l < pool->n_logs; l++)
+	{
+		/* every log starts with a new delay */
+		estimator_init(&ctx);
+		estimator_set_params(&ctx, &set->params);
+		ctx.gap_max = SWEEP_GAP_MAX;
+		for (size_t i = 0; i < pool->logs[l].n; i++)
+		{
+			r = &pool->logs[l].rows[i];
+			sample.p_suc_g = r->p_suc_g;
+			sample.t_suc = r->t_suc;
+			sample.p_dis_g = r->p_dis_g;
+			sample.compSpeed = r->compSpeed;
+			sample.I_test = r->I_test;
+			sample.tau = set->params.tau[r->phase];
+			sample.T_interval = r->T_interval;
+			estimator_step(&ctx, &sample, masks[pool->output], &out);
+
+			pred = (bit == EST_OUT_TDIS) ? out.t_dis : (bit == EST_OUT_TDIS_DELAY) ? out.t_dis_delay : out.p_dis_curr;
+			if ((out.valid & bit) && !(out.not_converged & bit))
+				stats_add(&set->stats, (double)pred - r->meas);
+			else
+				set->stats.excluded++;
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sweep_score()
+ *
+ * \brief		Value of the ranking metric of a parameter set, lower is better.
+ *
+ * \return		the metric, HUGE_VAL without samples so the set ranks last.
+*/
+//-------------------------------------------------------------------------------------------------
+static double sweep_score(const err_stats_t *s, sweep_metric_t m)
+{
+	if (s->n == 0)
+		return HUGE_VAL;
+	switch (m)
+	{
+	case MET_MAE:	return s->sum_abs / s->n;
+	case MET_P95:	return stats_percentile(s, 0.95);
+	case MET_MAX:	return s->max_abs;
+	case MET_BIAS:	return fabs(s->sum / s->n);
+	default:		return sqrt(s->sum_sq / s->n);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sweep_cmp()
+ *
+ * \brief		qsort() order of the parameter sets: by score, equal scores in sweep order.
+*/
+//-------------------------------------------------------------------------------------------------
+static int sweep_cmp(const void *a, const void *b)
+{
+	const sweep_set_t *x = a, *y = b;
+
+	if (x->score != y->score)
+		return (x->score < y->score) ? -1 : 1;
+	return (x->index < y->index) ? -1 : (x->index > y->index) ? 1 : 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sweep_worker()
+ *
+ * \brief		Thread of the pool: evaluates the next parameter set until none is left.
+*/
+//-------------------------------------------------------------------------------------------------
+static void *sweep_worker(void *arg)
+{
+	sweep_pool_t *pool = arg;
+	size_t i;
+
+	for (;;)
+	{
+		pthread_mutex_lock(&pool->lock);
+		i = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+		if (i >= pool->n_sets)
+			break;
+		sweep_eval(pool, &pool->sets[i]);
+	}
+	return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sweep_print()
+ *
+ * \brief		One ranked parameter set with its statistics, as a text line or a CSV row.
+ *
+ * \param[in]	fp = output.
+ * \param[in]	s = parameter set.
+ * \param[in]	rank = 1 for the best.
+ * \param[in]	csv = 1 for a CSV row, see the -o header.
+*/
+//-------------------------------------------------------------------------------------------------
+static void sweep_print(FILE *fp, const sweep_set_t *s, long rank, int csv)
+{
+	const err_stats_t *e = &s->stats;
+	double n = e->n ? (double)e->n : 1;
+
+	fprintf(fp, csv ? "%ld,%g,%d,%d,%d,%d,%ld,%ld,%.6g,%.6g,%.6g,%.6g,%.6g\n"
+					: "%4ld  fw %-6g tau %3d/%3d/%3d  coe %3d  n %7ld (%ld excl.)  bias %9.4f  mae %9.4f  rmse %9.4f  p95 %9.4f  max %9.4f\n",
+			rank, s->params.fw, s->params.tau[EST_PHASE_OFF], s->params.tau[EST_PHASE_STARTUP],
+			s->params.tau[EST_PHASE_RUNNING], s->coe_index, e->n, e->excluded, e->sum / n, e->sum_abs / n,
+			sqrt(e->sum_sq / n), stats_percentile(e, 0.95), e->max_abs);
+}
+
+
+
+
+int main(int argc, char *argv[])
+{
+	sweep_pool_t pool = {0};
+	estimator_params_t def;
+	double fw[SWEEP_LIST_MAX], tau[EST_PHASE_N][SWEEP_LIST_MAX];
+	int n_fw = 1, n_tau[EST_PHASE_N] = {1, 1, 1}, n_coe = 1;
+	float *coe = NULL;
+	const char *all_csv = NULL;
+	const char *suffix;
+	sweep_log_t *logs;
+	pthread_t *threads;
+	long n_threads = 0, top = 10;
+	size_t rows = 0, len;
+	FILE *fp;
+	int a, i;
+
+	estimator_default_params(&def);
+	fw[0] = def.fw;
+	for (i = 0; i < EST_PHASE_N; i++)
+		tau[i][0] = def.tau[i];
+	pool.output = OUT_T_DIS_DELAY;
+
+	for (a = 1; a < argc; a++)
+	{
+		if ((strcmp(argv[a], "-j") == 0) && (a + 1 < argc))
+			n_threads = atol(argv[++a]);
+		else if ((strcmp(argv[a], "-n") == 0) && (a + 1 < argc))
+			top = atol(argv[++a]);
+		else if ((strcmp(argv[a], "-o") == 0) && (a + 1 < argc))
+			all_csv = argv[++a];
+		else if ((strcmp(argv[a], "-y") == 0) && (a + 1 < argc))
+		{
+			for (a++, i = 0; (i < OUT_N) && (strcmp(argv[a], sweep_output_names[i]) != 0); i++);
+			if (i == OUT_N)
+				break;
+			pool.output = (sweep_output_t)i;
+		}
+		else if ((strcmp(argv[a], "-m") == 0) && (a + 1 < argc))
+		{
+			for (a++, i = 0; (i < MET_N) && (strcmp(argv[a], sweep_metric_names[i]) != 0); i++);
+			if (i == MET_N)
+				break;
+			sweep_metric = (sweep_metric_t)i;
+		}
+		else if ((strcmp(argv[a], "-fw") == 0) && (a + 1 < argc))
+		{
+			if ((n_fw = sweep_list(argv[++a], fw, SWEEP_LIST_MAX)) == 0)
+				break;
+		}
+		else if ((strncmp(argv[a], "-tau-", 5) == 0) && (a + 1 < argc))
+		{
+			i = (strcmp(argv[a] + 5, "off") == 0) ? EST_PHASE_OFF :
+				(strcmp(argv[a] + 5, "start") == 0) ? EST_PHASE_STARTUP :
+				(strcmp(argv[a] + 5, "run") == 0) ? EST_PHASE_RUNNING : -1;
+			if ((i < 0) || ((n_tau[i] = sweep_list(argv[++a], tau[i], SWEEP_LIST_MAX)) == 0))
+				break;
+		}
+		else if ((strcmp(argv[a], "-coe") == 0) && (a + 1 < argc))
+		{
+			if ((n_coe = sweep_read_coe(argv[++a], &coe)) <= 0)
+			{
+				printf("Error reading %s\n", argv[a]);
+				return 1;
+			}
+		}
+		else
+			break;
+	}
+	if ((a >= argc) || (argv[a][0] == '-'))
+	{
+		printf("usage: %s [-j threads] [-y t_dis|t_dis_delay|p_dis_curr] [-m rmse|mae|p95|max|bias]\n"
+			   "       [-fw list] [-tau-off list] [-tau-start list] [-tau-run list] [-coe file]\n"
+			   "       [-n top] [-o all.csv] file.csv...\n", argv[0]);
+		return 1;
+	}
+
+	/* logs of the kind of the output, into memory */
+	suffix = (pool.output == OUT_P_DIS_CURR) ? "current.csv" : "tdis.csv";
+	logs = calloc(argc - a, sizeof(sweep_log_t));
+	for (; a < argc; a++)
+	{
+		len = strlen(argv[a]);
+		if ((len < strlen(suffix)) || (strcmp(argv[a] + len - strlen(suffix), suffix) != 0))
+			continue;
+		if ((i = sweep_load(argv[a], pool.output, &logs[pool.n_logs])) != 0)
+		{
+			printf("Error loading %s: %s\n", argv[a], (i == -2) ? "missing column" : "can not open");
+			continue;
+		}
+		rows += logs[pool.n_logs++].n;
+	}
+	if (pool.n_logs == 0)
+	{
+		printf("No *%s log\n", suffix);
+		return 1;
+	}
+
+	/* grid */
+	pool.n_sets = (size_t)n_fw * n_tau[0] * n_tau[1] * n_tau[2] * n_coe;
+	pool.sets = calloc(pool.n_sets, sizeof(sweep_set_t));
+	for (size_t s = 0; s < pool.n_sets; s++)
+	{
+		size_t k = s;
+		sweep_set_t *set = &pool.sets[s];
+
+		set->index = s;
+		set->params.fw = fw[k % n_fw];
+		k /= n_fw;
+		for (i = 0; i < EST_PHASE_N; i++)
+		{
+			set->params.tau[i] = (int)lround(tau[i][k % n_tau[i]]);
+			k /= n_tau[i];
+		}
+		set->coe_index = (coe != NULL) ? (int)k : -1;
+		set->params.coe = (coe != NULL) ? &coe[k * COMP_COE_N] : COE_32;
+	}
+	printf("%zu logs, %zu rows, %zu parameter sets\n", pool.n_logs, rows, pool.n_sets);
+
+	/* thread pool sized to the cores */
+	if (n_threads <= 0)
+		n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (n_threads <= 0)
+		n_threads = 1;
+	if ((size_t)n_threads > pool.n_sets)
+		n_threads = (long)pool.n_sets;
+	pool.logs = logs;
+	pthread_mutex_init(&pool.lock, NULL);
+	threads = malloc(n_threads * sizeof(pthread_t));
+	for (long t = 0; t < n_threads; t++)
+		pthread_create(&threads[t], NULL, sweep_worker, &pool);
+	for (long t = 0; t < n_threads; t++)
+		pthread_join(threads[t], NULL);
+	pthread_mutex_destroy(&pool.lock);
+	free(threads);
+
+	/* ranking, the grid order decides between equal scores */
+	for (size_t s = 0; s < pool.n_sets; s++)
+		pool.sets[s].score = sweep_score(&pool.sets[s].stats, sweep_metric);
+	qsort(pool.sets, pool.n_sets, sizeof(sweep_set_t), sweep_cmp);
+
+	printf("%s by %s:\n", sweep_output_names[pool.output], sweep_metric_names[sweep_metric]);
+	for (size_t s = 0; (s < pool.n_sets) && ((long)s < top); s++)
+		sweep_print(stdout, &pool.sets[s], (long)s + 1, 0);
+
+	if (all_csv != NULL)
+	{
+		if ((fp = fopen(all_csv, "w")) == NULL)
+		{
+			printf("Error writing %s\n", all_csv);
+			return 1;
+		}
+		fprintf(fp, "rank,fw,tau_off,tau_startup,tau_running,coe,n,excluded,bias,mae,rmse,p95,max\n");
+		for (size_t s = 0; s < pool.n_sets; s++)
+			sweep_print(fp, &pool.sets[s], (long)s + 1, 1);
+		fclose(fp);
+	}
+
+	for (size_t l = 0; l < pool.n_logs; l++)
+		free(logs[l].rows);
+	free(logs);
+	free(pool.sets);
+	free(coe);
+
+	return 0;
+}
@@ -0,0 +1,543 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		replay_bench.c
+ *
+ * \brief		Host harness: throughput of the replay, by estimator path and by stage.
+ * \brief		Every stage is timed on its own over all rows in memory, the best of -n runs:
+ * \brief		parse       CSV rows to floats and timestamps, like sensor_replay
+ * \brief		properties  refrigerant properties of the suction (and discharge) gas
+ * \brief		compressor  intermediate coefficients of the compressor model
+ * \brief		solver      estimator_step() less properties, compressor and filter
+ * \brief		filter      first order delay, estimator_step() with and without it
+ * \brief		write       result rows formatted and written, to /dev/null
+ * \brief		replay      the whole single-thread pipeline per file, gives rows/s
+ * \brief		Usage: replay_bench [-n runs] [-t tag] [-o bench.json] dir|file...
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "sensor_predict.h"
+#include "refrigerant_property.h"
+#include "compressor_model.h"
+#include "csv_reader.h"
+#include "float_io.h"
+#include "out_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define BENCH_PATH_MAX		(1024)
+#define BENCH_NULL			"/dev/null"
+#define BENCH_GAP_MAX		(300.0f)	// gap_max as sensor_replay by default, its -g
+#define BENCH_ROWS_MIN		(4096)		// first size of the row buffer of a log
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		bench_path_t
+ * \brief		Estimator paths and the logs they run on.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	PATH_TDIS = 0,		// EST_OUT_TDIS, *tdis.csv
+	PATH_TDIS_DELAY,	// EST_OUT_TDIS | EST_OUT_TDIS_DELAY, *tdis.csv
+	PATH_PDIS_TEMP,		// EST_OUT_PDIS_TEMP, *tdis.csv with the measured T_dis
+	PATH_PDIS_CURR,		// EST_OUT_PDIS_CURR, *current.csv
+	PATH_N
+} bench_path_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		bench_stage_t
+ * \brief		Stages timed per path, see the file header.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	STAGE_PARSE = 0,
+	STAGE_PROPERTIES,
+	STAGE_COMPRESSOR,
+	STAGE_SOLVER,
+	STAGE_FILTER,
+	STAGE_WRITE,
+	STAGE_REPLAY,
+	STAGE_N
+} bench_stage_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		bench_log_t
+ * \brief		One log in memory.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	char path[BENCH_PATH_MAX];
+	int current;				// *current.csv, otherwise *tdis.csv
+	estimator_sample_t *rows;	// tau and T_interval as sensor_replay
+	size_t n;
+} bench_log_t;
+
+
+
+
+static const char *const bench_path_names[PATH_N] = {"t_dis", "t_dis_delay", "p_dis_temp", "p_dis_curr"};
+static const char *const bench_stage_names[STAGE_N] = {"parse", "properties", "compressor", "solver",
+													   "filter", "write", "replay"};
+static const unsigned int bench_masks[PATH_N] = {EST_OUT_TDIS, EST_OUT_TDIS | EST_OUT_TDIS_DELAY,
+												 EST_OUT_PDIS_TEMP, EST_OUT_PDIS_CURR};
+static volatile float bench_sink;	// keeps the timed results alive
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			bench_now()
+ *
+ * \brief		Monotonic time for the stage timings.
+ *
+ * \return		seconds.
+*/
+//-------------------------------------------------------------------------------------------------
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			bench_parse()
+ *
+ * \brief		Parse one log like sensor_replay. With rows != NULL the samples are kept in a
+ *				buffer grown while parsing, *rows is NULL if none is returned.
+ *
+ * \return		number of rows, -1 if the file can not be read or on out of memory.
+*/
+//-------------------------------------------------------------------------------------------------
+static long bench_parse(const char *path, int current, estimator_sample_t **rows)
+{
+	enum {COL_PD = 0, COL_PS, COL_SPEED, COL_ST, COL_WORK_MINUTES, COL_COMP_CU, COL_T_DIS, COL_N};
+	static const char *const names[COL_N] = {"Pd", "Ps", "CompSpeed", "ST", "WORK_MINUTES", "Comp_cu", "T_dis"};
+	estimator_params_t params;
+	csv_reader_t csv;
+	int col[COL_N];
+	float data[COL_N];
+	int64_t time, pre_time = CSV_TIME_NONE;
+	estimator_sample_t s = {0};
+	estimator_sample_t *buf = NULL, *p;
+	long n = 0, cap = 0;
+
+	if (rows != NULL)
+		*rows = NULL;
+	if (csv_open(&csv, path) != 0)
+		return -1;
+	if ((csv_next_row(&csv) < 0) || (csv_bind(&csv, names, COL_N, col) != 0))
+	{
+		csv_close(&csv);
+		return -1;
+	}
+	estimator_default_params(&params);
+	while (csv_next_row(&csv) >= 0)
+	{
+		if (!csv_row_project(&csv, col, COL_N, data))
+			continue;
+		s.p_suc_g = data[COL_PS];
+		s.t_suc = data[COL_ST];
+		s.p_dis_g = data[COL_PD];
+		s.compSpeed = data[COL_SPEED];
+		s.t_dis = data[COL_T_DIS];
+		s.I_test = data[COL_COMP_CU];
+		s.U = 220;
+		s.tau = params.tau[estimator_phase(data[COL_WORK_MINUTES])];
+		time = csv_field_time_ms(&csv.fields[0]);
+		s.T_interval = ((time == CSV_TIME_NONE) || (pre_time == CSV_TIME_NONE)) ? 2.0f :
+					   (time > pre_time) ? (time - pre_time) * 0.001f : 0;
+		if (time != CSV_TIME_NONE)
+			pre_time = time;
+		if (rows != NULL)
+		{
+			if (n == cap)
+			{
+				cap = cap ? cap * 2 : BENCH_ROWS_MIN;
+				if ((p = realloc(buf, cap * sizeof(estimator_sample_t))) == NULL)
+				{
+					free(buf);
+					csv_close(&csv);
+					return -1;
+				}
+				buf = p;
+			}
+			buf[n] = s;
+		}
+		n++;
+	}
+	csv_close(&csv);
+
+	if (rows != NULL)
+		*rows = buf;
+	return n;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			bench_properties()
+ *
+ * \brief		Property calls of one sample: suction state, and the discharge saturation for
+ *				the temperature path.
+*/
+//-------------------------------------------------------------------------------------------------
+static float bench_properties(const estimator_sample_t *s, bench_path_t path)
+{
+	float p_suc, ts, hs, r;
+
+	if (path == PATH_PDIS_CURR)
+		return s->p_suc_g + 101.35;
+	p_suc = s->p_suc_g + 101.35;
+	ts = cal_t_sat(p_suc);
+	hs = cal_h_sat_gas_ts(ts);
+	if (s->t_suc - ts > 1)
+		r = cal_dens_sh_gas_ts(ts, s->t_suc) + cal_h_sh_gas_ts(ts, hs, s->t_suc);
+	else
+		r = cal_vol_sat_gas_ts(ts) + hs;
+	if (path != PATH_PDIS_TEMP)
+		r += cal_h_sat_gas_ts(cal_t_sat(s->p_dis_g + 101.35));
+	return r;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			bench_stage()
+ *
+ * \brief		Time one stage of one path over every log.
+ *
+ * \return		seconds.
+*/
+//-------------------------------------------------------------------------------------------------
+static double bench_stage(const bench_log_t *logs, size_t n_logs, bench_path_t path, bench_stage_t stage)
+{
+	estimator_ctx_t ctx;
+	estimator_outputs_t out;
+	comp_coe_t coe;
+	out_writer_t w;
+	char *line;
+	int len;
+	float acc = 0;
+	double t0 = bench_now();
+
+	for (size_t l = 0; l < n_logs; l++)
+	{
+		const bench_log_t *log = &logs[l];
+
+		if (log->current != (path == PATH_PDIS_CURR))
+			continue;
+		switch (stage)
+		{
+		case STAGE_PARSE:
+			acc += bench_parse(log->path, log->current, NULL);
+			break;
+		case STAGE_PROPERTIES:
+			for (size_t i = 0; i < log->n; i++)
+				acc += bench_properties(&log->rows[i], path);
+			break;
+		case STAGE_COMPRESSOR:
+			for (size_t i = 0; i < log->n; i++)
+			{
+				cal_comp_coe(log->rows[i].compSpeed, &coe);
+				acc += coe.a + coe.g;
+			}
+			break;
+		case STAGE_SOLVER:
+		case STAGE_FILTER:
+			/* full step, the parts are taken off by the caller */
+			estimator_init(&ctx);
+			ctx.gap_max = BENCH_GAP_MAX;
+			for (size_t i = 0; i < log->n; i++)
+			{
+				estimator_step(&ctx, &log->rows[i], bench_masks[path], &out);
+				acc += out.t_dis + out.t_dis_delay + out.p_dis_temp + out.p_dis_curr;
+			}
+			break;
+		case STAGE_WRITE:
+			/* the values do not change the cost much, the inputs stand in for the outputs */
+			if (out_open(&w, BENCH_NULL, 0, 0) != 0)
+				break;
+			for (size_t i = 0; i < log->n; i++)
+			{
+				const estimator_sample_t *r = &log->rows[i];
+				const float v[7] = {r->p_suc_g, r->t_suc, r->p_dis_g, r->compSpeed, r->t_dis, r->I_test, r->U};
+				int cols = log->current ? 5 : 9;
+
+				line = out_reserve(&w, 9 * FLOAT_FMT_MAX);
+				len = 0;
+				for (int c = 0; c < cols; c++)
+				{
+					len += float_format_f(line + len, v[c % 7]);
+					line[len++] = (c == cols - 1) ? '\n' : ',';
+				}
+				out_commit(&w, len);
+			}
+			out_close(&w);
+			break;
+		case STAGE_REPLAY:
+		{
+			estimator_sample_t *rows;
+			long n = bench_parse(log->path, log->current, &rows);
+
+			if (n < 0)
+				break;
+			estimator_init(&ctx);
+			ctx.gap_max = BENCH_GAP_MAX;
+			if (out_open(&w, BENCH_NULL, 0, 0) == 0)
+			{
+				for (long i = 0; i < n; i++)
+				{
+					estimator_step(&ctx, &rows[i], bench_masks[path], &out);
+					line = out_reserve(&w, 2 * FLOAT_FMT_MAX);
+					len = float_format_f(line, out.t_dis);
+					line[len++] = ',';
+					len += float_format_f(line + len, out.t_dis_delay + out.p_dis_temp + out.p_dis_curr);
+					line[len++] = '\n';
+					out_commit(&w, len);
+				}
+				out_close(&w);
+			}
+			free(rows);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	bench_sink = acc;
+
+	return bench_now() - t0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			bench_add()
+ *
+ * \brief		Load a log, *tdis.csv and *current.csv only.
+*/
+//-------------------------------------------------------------------------------------------------
+static void bench_add(bench_log_t **logs, size_t *n, const char *path)
+{
+	size_t len = strlen(path);
+	bench_log_t *log;
+	estimator_sample_t *rows;
+	long n_rows;
+	int current;
+
+	if ((len >= 11) && (strcmp(path + len - 11, "current.csv") == 0))
+		current = 1;
+	else if ((len >= 8) && (strcmp(path + len - 8, "tdis.csv") == 0))
+		current = 0;
+	else
+		return;
+	if ((n_rows = bench_parse(path, current, &rows)) <= 0)
+	{
+		printf("Error reading %s\n", path);
+		free(rows);
+		return;
+	}
+	if ((log = realloc(*logs, (*n + 1) * sizeof(bench_log_t))) == NULL)
+	{
+		printf("Out of memory\n");
+		exit(1);
+	}
+	*logs = log;
+	log = &(*logs)[(*n)++];
+	snprintf(log->path, sizeof(log->path), "%s", path);
+	log->current = current;
+	log->rows = rows;
+	log->n = (size_t)n_rows;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			bench_cmp()
+ *
+ * \brief		qsort() order of the file names of a directory.
+*/
+//-------------------------------------------------------------------------------------------------
+static int bench_cmp(const void *a, const void *b)
+{
+	return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+
+
+
+int main(int argc, char *argv[])
+{
+	bench_log_t *logs = NULL;
+	size_t n_logs = 0, rows[PATH_N] = {0};
+	double best[PATH_N][STAGE_N], ns[PATH_N][STAGE_N], t;
+	const char *tag = "", *json = NULL;
+	struct rusage ru;
+	struct stat st;
+	struct dirent *ent;
+	DIR *dp;
+	char **names, **grown, path[BENCH_PATH_MAX];
+	size_t n_names;
+	int runs = 3, a;
+	FILE *fp;
+
+	for (a = 1; a < argc; a++)
+	{
+		if ((strcmp(argv[a], "-n") == 0) && (a + 1 < argc))
+			runs = atoi(argv[++a]);
+		else if ((strcmp(argv[a], "-t") == 0) && (a + 1 < argc))
+			tag = argv[++a];
+		else if ((strcmp(argv[a], "-o") == 0) && (a + 1 < argc))
+			json = argv[++a];
+		else
+			break;
+	}
+	if ((a >= argc) || (runs <= 0))
+	{
+		printf("usage: %s [-n runs] [-t tag] [-o bench.json] dir|file...\n", argv[0]);
+		return 1;
+	}
+
+	/* logs in memory, directories in name order */
+	for (; a < argc; a++)
+	{
+		if ((stat(argv[a], &st) != 0) || !S_ISDIR(st.st_mode))
+		{
+			bench_add(&logs, &n_logs, argv[a]);
+			continue;
+		}
+		if ((dp = opendir(argv[a])) == NULL)
+			continue;
+		names = NULL;
+		n_names = 0;
+		while ((ent = readdir(dp)) != NULL)
+		{
+			if (((grown = realloc(names, (n_names + 1) * sizeof(char *))) == NULL) ||
+				((grown[n_names] = strdup(ent->d_name)) == NULL))
+			{
+				printf("Out of memory\n");
+				return 1;
+			}
+			names = grown;
+			n_names++;
+		}
+		closedir(dp);
+		qsort(names, n_names, sizeof(char *), bench_cmp);
+		for (size_t i = 0; i < n_names; i++)
+		{
+			snprintf(path, sizeof(path), "%s/%s", argv[a], names[i]);
+			bench_add(&logs, &n_logs, path);
+			free(names[i]);
+		}
+		free(names);
+	}
+	for (size_t l = 0; l < n_logs; l++)
+		for (int p = 0; p < PATH_N; p++)
+			if (logs[l].current == (p == PATH_PDIS_CURR))
+				rows[p] += logs[l].n;
+
+	/* best of the runs */
+	for (int p = 0; p < PATH_N; p++)
+		for (int s = 0; s < STAGE_N; s++)
+			best[p][s] = -1;
+	for (int r = 0; r < runs; r++)
+	{
+		for (int p = 0; p < PATH_N; p++)
+		{
+			for (int s = 0; s < STAGE_N; s++)
+			{
+				if (rows[p] == 0)
+					continue;
+				t = bench_stage(logs, n_logs, (bench_path_t)p, (bench_stage_t)s);
+				best[p][s] = ((best[p][s] < 0) || (t < best[p][s])) ? t : best[p][s];
+			}
+		}
+	}
+
+	/* ns/row, the solver is the step less the other model stages, the filter the step
+	   with the delay less the step without it; t_dis goes last, its full step is needed first */
+	for (int p = 0; p < PATH_N; p++)
+		for (int s = 0; s < STAGE_N; s++)
+			ns[p][s] = rows[p] ? best[p][s] * 1e9 / rows[p] : 0;
+	for (int p = PATH_N - 1; p >= 0; p--)
+	{
+		if (rows[p] == 0)
+			continue;
+		ns[p][STAGE_FILTER] = (p == PATH_TDIS_DELAY) ? ns[p][STAGE_FILTER] - ns[PATH_TDIS][STAGE_SOLVER] : 0;
+		if (ns[p][STAGE_FILTER] < 0)
+			ns[p][STAGE_FILTER] = 0;
+		ns[p][STAGE_SOLVER] -= ns[p][STAGE_PROPERTIES] + ns[p][STAGE_COMPRESSOR] + ns[p][STAGE_FILTER];
+		if (ns[p][STAGE_SOLVER] < 0)
+			ns[p][STAGE_SOLVER] = 0;
+	}
+	getrusage(RUSAGE_SELF, &ru);
+
+	printf("%zu logs, best of %d runs, ns/row\n%-12s %8s", n_logs, runs, "path", "rows");
+	for (int s = 0; s < STAGE_N; s++)
+		printf(" %10s", bench_stage_names[s]);
+	printf(" %12s\n", "rows/s");
+	for (int p = 0; p < PATH_N; p++)
+	{
+		printf("%-12s %8zu", bench_path_names[p], rows[p]);
+		for (int s = 0; s < STAGE_N; s++)
+			printf(" %10.1f", ns[p][s]);
+		printf(" %12.0f\n", ns[p][STAGE_REPLAY] > 0 ? 1e9 / ns[p][STAGE_REPLAY] : 0);
+	}
+	printf("peak RSS %ld KiB\n", ru.ru_maxrss);
+
+	if (json != NULL)
+	{
+		if ((fp = fopen(json, "w")) == NULL)
+		{
+			printf("Error writing %s\n", json);
+			return 1;
+		}
+		fprintf(fp, "{\n  \"tag\": \"%s\",\n  \"logs\": %zu,\n  \"runs\": %d,\n  \"peak_rss_kib\": %ld,\n  \"paths\": {",
+				tag, n_logs, runs, ru.ru_maxrss);
+		for (int p = 0; p < PATH_N; p++)
+		{
+			fprintf(fp, "%s\n    \"%s\": {\"rows\": %zu, \"rows_per_s\": %.0f, \"ns_per_row\": {", p ? "," : "",
+					bench_path_names[p], rows[p], ns[p][STAGE_REPLAY] > 0 ? 1e9 / ns[p][STAGE_REPLAY] : 0);
+			for (int s = 0; s < STAGE_N; s++)
+				fprintf(fp, "%s\"%s\": %.1f", s ? ", " : "", bench_stage_names[s], ns[p][s]);
+			fprintf(fp, "}}");
+		}
+		fprintf(fp, "\n  }\n}\n");
+		fclose(fp);
+	}
+
+	for (size_t l = 0; l < n_logs; l++)
+		free(logs[l].rows);
+	free(logs);
+
+	return 0;
+}
@@ -0,0 +1,1538 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		sensor_replay.c
+ *
+ * \brief		Replay logged data through the estimator, one result file per log.
+ * \brief		The files are processed concurrently by a pool of threads, each file with its own
+ * \brief		estimator context, so the results do not depend on the number of threads.
+ * \brief		Usage: sensor_replay [-j threads] [-c] [-o out_dir] [-r] [-w] [-i s] [-g s] [-s summary.json]
+ * \brief		                     [-m manifest] [-p] dir|file|"glob"...
+ * \brief		With -c the logs are replayed one after another, each split into chunks over the
+ * \brief		threads, so a single long log uses all cores; see replay_file_chunked().
+ * \brief		The values are written like printf("%f"), or with -r in the shortest form which
+ * \brief		reads back to the same float. The rows are formatted into a large buffer which is
+ * \brief		written in one chunk, with -w by a writer thread per file while replay goes on.
+ * \brief		The interval of the first order delay is taken from the timestamps of the first
+ * \brief		column, or fixed with -i; a gap longer than -g seconds seeds the delay again.
+ * \brief		The error against the measured T_dis and Pd is accumulated in the same pass, per
+ * \brief		file and in total, split by phase (off, start-up, running), and written with -s.
+ * \brief		*tdis.csv        -> *tdis_result.csv        Ps,ST,Pd,CompSpeed,WORK_MINUTES,T_dis_es,t_dis_old,T_dis_delay,t_dis
+ * \brief		*current.csv     -> *current_result.csv     Ps,I_test,CompSpeed,P_dis_es,P_dis
+ * \brief		A *.col cache made by tools/csv_to_col.c is mapped instead of parsing the log; in a
+ * \brief		directory it is used in place of the log of the same name unless the log is newer.
+ * \brief		Logs may be gzip compressed, *.csv.gz, or zstd, *.csv.zst, see csv_reader.h.
+ * \brief		With -m the logs whose results are still valid by the manifest are not replayed,
+ * \brief		see manifest.h and replay_config_hash(); their statistics come from the manifest,
+ * \brief		so the totals and -s cover all logs. The manifest is updated afterwards.
+ * \brief		With -p the convergence counters of the pressure solvers (solver_stats_t) are
+ * \brief		printed in total and written with -s in total and per file.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "sensor_predict.h"
+#include "compressor_model.h"
+#include "csv_reader.h"
+#include "float_io.h"
+#include "col_file.h"
+#include "out_writer.h"
+#include "err_stats.h"
+#include "manifest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dirent.h>
+#include <glob.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define REPLAY_PATH_MAX		(1024)
+#define REPLAY_OUT_MAX		(9)			// values of one result row
+#define REPLAY_INTERVAL		(2.0f)		// nominal sample interval in s, used without a timestamp
+#define REPLAY_GAP_MAX		(300.0f)	// default -g in s, the longest time constant of the delay
+#define REPLAY_CHUNK_MIN	(4096)		// fewest rows of a chunk with -c
+#ifndef BUILD_ID
+#define BUILD_ID			""			// git describe of the build, set by the Makefile
+#endif
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		replay_kind_t
+ * \brief		Kind of log, by the end of the file name.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	REPLAY_NONE = 0,
+	REPLAY_TDIS,		// *tdis.csv, discharge gas temperature
+	REPLAY_CURRENT,		// *current.csv, discharge gas pressure by current
+} replay_kind_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		replay_col_t
+ * \brief		Columns read from the logs, bound by name from the header.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	COL_PD = 0,
+	COL_PS,
+	COL_SPEED,
+	COL_ST,
+	COL_WORK_MINUTES,
+	COL_COMP_CU,		// I_test, current of the compressor driver
+	COL_EST,			// estimate of the previous model, T_dis_es or P_dis_es
+	COL_DELAY,			// T_dis_delay
+	COL_T_DIS,			// measured discharge gas temperature
+	COL_N
+} replay_col_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		replay_metric_t
+ * \brief		Outputs compared with a measurement: t_dis and t_dis_delay with T_dis, P_dis with Pd.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	MET_T_DIS = 0,
+	MET_T_DIS_DELAY,
+	MET_P_DIS_CURR,
+	MET_N
+} replay_metric_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		replay_job_t
+ * \brief		One log file and the result of its replay.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	char src[REPLAY_PATH_MAX];
+	char dest[REPLAY_PATH_MAX];
+	replay_kind_t kind;
+	int cached;			// src is a *.col cache
+	long rows;
+	long gaps;			// intervals longer than replay_gap
+	err_stats_t (*stats)[EST_PHASE_N];	// [MET_N][EST_PHASE_N] errors of the outputs, see estimator_phase()
+	int error;			// 0, 1 if a file could not be opened or written, 2 if a column is missing,
+						// 3 if a compressed log is damaged or truncated
+	int up_to_date;		// -m, the result in the manifest is still valid, not replayed
+	int64_t size;		// -m, the log as replayed
+	int64_t mtime_ns;
+	uint64_t hash;
+	solver_stats_t solvers[EST_SOLVER_N];	// -p, convergence counters of the pressure solvers
+} replay_job_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		replay_row_t
+ * \brief		-c, one row of a loaded log and its outputs.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	float data[COL_N];
+	float T_interval;
+	est_phase_t phase;
+	estimator_outputs_t out;
+	double gain;		// gain of the delay, see estimator_delay_gain()
+} replay_row_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		replay_chunk_t
+ * \brief		-c, rows lo...hi-1 of a log replayed by one thread.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	const replay_job_t *job;
+	replay_row_t *rows;
+	size_t lo;
+	size_t hi;
+	double A;			// delay after the chunk = A*pre + B
+	double B;
+	float pre;			// delay before the chunk
+	out_writer_t w;		// result rows, in memory
+	err_stats_t stats[MET_N][EST_PHASE_N];
+	solver_stats_t solvers[EST_SOLVER_N];	// -p
+	int error;
+} replay_chunk_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		replay_record_t
+ * \brief		-m, statistics of a result kept as the data of its manifest entry, so the totals
+ *				and the summary also hold the logs which are up to date.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	err_stats_t stats[MET_N][EST_PHASE_N];
+	solver_stats_t solvers[EST_SOLVER_N];	// -p
+} replay_record_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		replay_pool_t
+ * \brief		Work list shared by the threads. The next job is taken under the lock.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	replay_job_t *jobs;
+	size_t n;
+	size_t cap;
+	size_t next;
+	pthread_mutex_t lock;
+} replay_pool_t;
+
+
+
+
+static int replay_shortest;		// -r, set before the threads start
+static int replay_background;	// -w, set before the threads start
+static float replay_interval;	// -i, fixed interval in s, 0 to use the timestamps
+static float replay_gap = REPLAY_GAP_MAX;	// -g, 0 to never seed the delay again
+static int replay_chunked;		// -c, one log at a time on all threads
+static const char *replay_manifest;	// -m, manifest of the results made before
+static int replay_solver_stats;	// -p, count the iterations of the solvers
+
+static const char *const replay_metric_names[MET_N] = {"t_dis", "t_dis_delay", "p_dis_curr"};
+static const char *const replay_phase_names[EST_PHASE_N] = {"off", "startup", "running"};
+static const char *const replay_solver_names[EST_SOLVER_N] = {"pdis_temp", "pdis_curr"};
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \var     replay_cols[][]
+ * \brief   Names of the replay_col_t columns by kind of log, NULL if not used.
+ */
+//-------------------------------------------------------------------------------------------------
+static const char *const replay_cols[][COL_N] = {
+	[REPLAY_TDIS] = {"Pd", "Ps", "CompSpeed", "ST", "WORK_MINUTES", NULL, "T_dis_es", "T_dis_delay", "T_dis"},
+	[REPLAY_CURRENT] = {"Pd", "Ps", "CompSpeed", NULL, "WORK_MINUTES", "Comp_cu", "P_dis_es", NULL, NULL},
+};
+
+
+static const char *const replay_headers[] = {
+	[REPLAY_TDIS] = "Ps,ST,Pd,CompSpeed,WORK_MINUTES,T_dis_es,t_dis_old,T_dis_delay,t_dis\n",
+	[REPLAY_CURRENT] = "Ps,I_test,CompSpeed,P_dis_es,P_dis\n",
+};
+static const unsigned int replay_masks[] = {
+	[REPLAY_TDIS] = EST_OUT_TDIS | EST_OUT_TDIS_DELAY,
+	[REPLAY_CURRENT] = EST_OUT_PDIS_CURR,
+};
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		replay_src_t
+ * \brief		Rows of the replay_col_t columns from a log or from its *.col cache.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	int cached;
+	csv_reader_t csv;
+	int idx[COL_N];				// field index in the log
+	col_file_t col;
+	const float *ptr[COL_N];	// column in the cache
+	const int64_t *time;		// timestamp column in the cache, NULL if there is none
+	size_t row;
+	size_t n_rows;
+} replay_src_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_kind()
+ *
+ * \brief		Kind of a log by its name: *tdis or *current, as .csv, .csv.gz, .csv.zst or a
+ *				.col cache.
+ *
+ * \return		REPLAY_TDIS, REPLAY_CURRENT or REPLAY_NONE for any other file.
+*/
+//-------------------------------------------------------------------------------------------------
+static replay_kind_t replay_kind(const char *name)
+{
+	size_t len = strlen(name);
+
+	/* a cache is never compressed, a log may be */
+	if ((len >= 8) && (strcmp(name + len - 8, "tdis.col") == 0))
+		return REPLAY_TDIS;
+	if ((len >= 11) && (strcmp(name + len - 11, "current.col") == 0))
+		return REPLAY_CURRENT;
+	len = csv_base_len(name);
+	if ((len >= 8) && (memcmp(name + len - 8, "tdis.csv", 8) == 0))
+		return REPLAY_TDIS;
+	if ((len >= 11) && (memcmp(name + len - 11, "current.csv", 11) == 0))
+		return REPLAY_CURRENT;
+	return REPLAY_NONE;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_add()
+ *
+ * \brief		Add a log file to the work list, result name is <name>_result.csv in out_dir or
+ *				next to the log.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_add(replay_pool_t *pool, const char *path, const char *out_dir)
+{
+	replay_job_t *job, *jobs;
+	const char *base;
+	replay_kind_t kind = replay_kind(path);
+	int len;
+
+	if (kind == REPLAY_NONE)
+		return;
+	if (pool->n == pool->cap)
+	{
+		if ((jobs = realloc(pool->jobs, (pool->cap ? pool->cap * 2 : 64) * sizeof(replay_job_t))) == NULL)
+		{
+			printf("Out of memory\n");
+			exit(1);
+		}
+		pool->jobs = jobs;
+		pool->cap = pool->cap ? pool->cap * 2 : 64;
+	}
+	job = &pool->jobs[pool->n++];
+	memset(job, 0, sizeof(*job));
+	job->kind = kind;
+	job->cached = (strcmp(path + strlen(path) - 4, ".col") == 0);
+	snprintf(job->src, sizeof(job->src), "%s", path);
+
+	/* <name>.csv, <name>.csv.gz or <name>.col -> <name>_result.csv */
+	base = strrchr(path, '/');
+	base = (base != NULL) ? base + 1 : path;
+	if (out_dir != NULL)
+		len = snprintf(job->dest, sizeof(job->dest), "%s/%s", out_dir, base);
+	else
+		len = snprintf(job->dest, sizeof(job->dest), "%s", path);
+	len -= (int)(strlen(path) - csv_base_len(path));
+	if ((len > 4) && (len + 7 < (int)sizeof(job->dest)))
+		strcpy(job->dest + len - 4, "_result.csv");
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_cmp()
+ *
+ * \brief		qsort() order of the file names of a directory.
+*/
+//-------------------------------------------------------------------------------------------------
+static int replay_cmp(const void *a, const void *b)
+{
+	return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_add_dir()
+ *
+ * \brief		Add the logs of a directory in name order. A *.col cache replaces the log of the
+ *				same name if it is not older than the log.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_add_dir(replay_pool_t *pool, const char *dir, const char *out_dir)
+{
+	DIR *dp;
+	struct dirent *dirp;
+	char **names = NULL, **p;
+	size_t n = 0, cap = 0;
+	char path[REPLAY_PATH_MAX], cache[REPLAY_PATH_MAX];
+	static const char *const log_endings[3] = {".csv", ".csv.gz", ".csv.zst"};
+	struct stat st_log, st_cache;
+	size_t len;
+	int k;
+
+	if ((dp = opendir(dir)) == NULL)
+	{
+		printf("Error opening directory %s\n", dir);
+		return;
+	}
+	while ((dirp = readdir(dp)) != NULL)
+	{
+		if (replay_kind(dirp->d_name) == REPLAY_NONE)
+			continue;
+		if (n == cap)
+		{
+			cap = cap ? cap * 2 : 64;
+			if ((p = realloc(names, cap * sizeof(char *))) == NULL)
+			{
+				printf("Out of memory\n");
+				exit(1);
+			}
+			names = p;
+		}
+		if ((names[n++] = strdup(dirp->d_name)) == NULL)
+		{
+			printf("Out of memory\n");
+			exit(1);
+		}
+	}
+	closedir(dp);
+
+	qsort(names, n, sizeof(char *), replay_cmp);
+	for (size_t i = 0; i < n; i++)
+	{
+		snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+		len = strlen(path);
+		if (strcmp(path + len - 4, ".col") == 0)
+		{
+			/* cache, used if there is no log or the log is not newer */
+			for (k = 0; k < 3; k++)
+			{
+				memcpy(cache, path, len - 4);
+				strcpy(cache + len - 4, log_endings[k]);
+				if ((stat(cache, &st_log) == 0) && (stat(path, &st_cache) == 0) &&
+					(st_log.st_mtime > st_cache.st_mtime))
+					break;
+			}
+			if (k < 3)
+			{
+				printf("%s is older than the log, not used\n", path);
+				free(names[i]);
+				continue;
+			}
+		}
+		else
+		{
+			/* log, skipped if the cache is used */
+			len = csv_base_len(path);
+			memcpy(cache, path, len - 4);
+			strcpy(cache + len - 4, ".col");
+			if ((stat(cache, &st_cache) == 0) && (stat(path, &st_log) == 0) &&
+				(st_log.st_mtime <= st_cache.st_mtime))
+			{
+				free(names[i]);
+				continue;
+			}
+		}
+		replay_add(pool, path, out_dir);
+		free(names[i]);
+	}
+	free(names);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_write()
+ *
+ * \brief		Write one row of n values.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_write(out_writer_t *w, const float *v, int n)
+{
+	char *line = out_reserve(w, REPLAY_OUT_MAX * FLOAT_FMT_MAX);
+	int len = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		if (replay_shortest)
+			len += float_format_short(line + len, v[i]);
+		else
+			len += float_format_f(line + len, v[i]);
+		line[len++] = (i == n - 1) ? '\n' : ',';
+	}
+	out_commit(w, len);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_src_open()
+ *
+ * \brief		Open the log or the cache of a job and bind the columns of replay_cols[].
+ *
+ * \return		0 if ok, 1 if the file can not be opened, 2 if a column is missing, 3 if a
+ *				compressed log ends in its header.
+*/
+//-------------------------------------------------------------------------------------------------
+static int replay_src_open(replay_src_t *src, const replay_job_t *job)
+{
+	const char *const *names = replay_cols[job->kind];
+	int err;
+
+	memset(src, 0, sizeof(*src));
+	src->cached = job->cached;
+	if (src->cached)
+	{
+		if (col_open(&src->col, job->src) != 0)
+			return 1;
+		src->n_rows = (size_t)src->col.hdr->n_rows;
+		for (int i = 0; i < COL_N; i++)
+		{
+			if (names[i] == NULL)
+				continue;
+			if ((src->ptr[i] = col_column(&src->col, names[i], COL_F32)) == NULL)
+			{
+				col_close(&src->col);
+				return 2;
+			}
+		}
+		src->time = col_column(&src->col, COL_TIME_NAME, COL_I64);
+		return 0;
+	}
+
+	if (csv_open(&src->csv, job->src) != 0)
+		return 1;
+	if ((csv_next_row(&src->csv) < 0) || (csv_bind(&src->csv, names, COL_N, src->idx) != 0))
+	{
+		/* a compressed log which ends in its header is damaged, not short of a column */
+		err = src->csv.error ? 3 : 2;
+		csv_close(&src->csv);
+		return err;
+	}
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_src_next()
+ *
+ * \brief		Next row, rows too short for a bound column are skipped.
+ *
+ * \param[out]	data = values of the replay_col_t columns.
+ * \param[out]	time = timestamp in ms or CSV_TIME_NONE, NULL if not needed.
+ *
+ * \return		1 if data[] holds a row, 0 at the end.
+*/
+//-------------------------------------------------------------------------------------------------
+static int replay_src_next(replay_src_t *src, float *data, int64_t *time)
+{
+	if (src->cached)
+	{
+		if (src->row >= src->n_rows)
+			return 0;
+		for (int i = 0; i < COL_N; i++)
+			data[i] = (src->ptr[i] != NULL) ? src->ptr[i][src->row] : 0;
+		if (time != NULL)
+			*time = (src->time != NULL) ? src->time[src->row] : CSV_TIME_NONE;
+		src->row++;
+		return 1;
+	}
+
+	while (csv_next_row(&src->csv) >= 0)
+	{
+		if (csv_row_project(&src->csv, src->idx, COL_N, data))
+		{
+			if (time != NULL)
+				*time = csv_field_time_ms(&src->csv.fields[0]);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_src_close()
+ *
+ * \brief		Close the log or the cache opened by replay_src_open().
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_src_close(replay_src_t *src)
+{
+	if (src->cached)
+		col_close(&src->col);
+	else
+		csv_close(&src->csv);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_error()
+ *
+ * \brief		Add prediction - measurement of one output, outputs without solution are only
+ *				counted as excluded.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_error(err_stats_t *stats, int solved, float pred, float meas)
+{
+	if (solved)
+		stats_add(stats, (double)pred - meas);
+	else
+		stats->excluded++;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_stats_alloc()
+ *
+ * \brief		Allocate and clear the statistics of a job.
+ *
+ * \return		0 if ok, -1 if out of memory.
+*/
+//-------------------------------------------------------------------------------------------------
+static int replay_stats_alloc(replay_job_t *job)
+{
+	if ((job->stats = malloc(MET_N * sizeof(*job->stats))) == NULL)
+		return -1;
+	for (int m = 0; m < MET_N; m++)
+		for (int p = 0; p < EST_PHASE_N; p++)
+			stats_init(&job->stats[m][p]);
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_dt()
+ *
+ * \brief		Interval of the delay before a row.
+ *
+ * \param[in]	time = timestamp of the row in ms or CSV_TIME_NONE, NULL for the fixed interval.
+ * \param[in]	pre_time = last valid timestamp, updated.
+ *
+ * \return		interval in s.
+*/
+//-------------------------------------------------------------------------------------------------
+static float replay_dt(const int64_t *time, int64_t *pre_time)
+{
+	float dt;
+
+	if (time == NULL)
+		return (replay_interval > 0) ? replay_interval : REPLAY_INTERVAL;
+
+	/* no or bad timestamp: nominal interval, time going back: no time passed */
+	if ((*time == CSV_TIME_NONE) || (*pre_time == CSV_TIME_NONE))
+		dt = REPLAY_INTERVAL;
+	else
+		dt = (*time > *pre_time) ? (*time - *pre_time) * 0.001f : 0;
+	if (*time != CSV_TIME_NONE)
+		*pre_time = *time;
+	return dt;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_sample()
+ *
+ * \brief		Estimator inputs of one row. Fields not used by the kind of log are left as
+ *				they are, so the skip of unchanged samples still works.
+ *
+ * \return		phase of the row, see estimator_phase().
+*/
+//-------------------------------------------------------------------------------------------------
+static est_phase_t replay_sample(const replay_job_t *job, const estimator_ctx_t *ctx, const float *data,
+								 float T_interval, estimator_sample_t *sample)
+{
+	est_phase_t phase = estimator_phase(data[COL_WORK_MINUTES]);
+
+	sample->p_suc_g = data[COL_PS];
+	sample->compSpeed = data[COL_SPEED];
+	if (job->kind == REPLAY_TDIS)
+	{
+		/* tau is 200 while the compressor is off, 300 in the first 5 minutes, then 100 */
+		sample->t_suc = data[COL_ST];
+		sample->p_dis_g = data[COL_PD];
+		sample->tau = ctx->params.tau[phase];
+		sample->T_interval = T_interval;
+	}
+	else
+	{
+		sample->I_test = data[COL_COMP_CU];
+		sample->U = 220;
+	}
+	return phase;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_emit()
+ *
+ * \brief		Write the result row and add the errors of the outputs.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_emit(const replay_job_t *job, out_writer_t *w, err_stats_t (*stats)[EST_PHASE_N],
+						const float *data, est_phase_t phase, const estimator_outputs_t *out)
+{
+	float row[REPLAY_OUT_MAX];
+
+	if (job->kind == REPLAY_TDIS)
+	{
+		row[0] = data[COL_PS];
+		row[1] = data[COL_ST];
+		row[2] = data[COL_PD];
+		row[3] = data[COL_SPEED];
+		row[4] = data[COL_WORK_MINUTES];
+		row[5] = data[COL_EST];
+		row[6] = out->t_dis;
+		row[7] = data[COL_DELAY];
+		row[8] = out->t_dis_delay;
+		replay_write(w, row, 9);
+		replay_error(&stats[MET_T_DIS][phase], !(out->not_converged & EST_OUT_TDIS),
+					 out->t_dis, data[COL_T_DIS]);
+		replay_error(&stats[MET_T_DIS_DELAY][phase], !(out->not_converged & EST_OUT_TDIS_DELAY),
+					 out->t_dis_delay, data[COL_T_DIS]);
+	}
+	else
+	{
+		row[0] = data[COL_PS];
+		row[1] = data[COL_COMP_CU];
+		row[2] = data[COL_SPEED];
+		row[3] = data[COL_EST];
+		row[4] = out->p_dis_curr;
+		replay_write(w, row, 5);
+		replay_error(&stats[MET_P_DIS_CURR][phase], !(out->not_converged & EST_OUT_PDIS_CURR),
+					 out->p_dis_curr, data[COL_PD]);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_file()
+ *
+ * \brief		Replay one log. Only the columns of replay_cols[] are parsed.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_file(replay_job_t *job)
+{
+	replay_src_t src;
+	float data[COL_N];
+	float T_interval;
+	estimator_ctx_t ctx;
+	estimator_sample_t sample = {0};
+	estimator_outputs_t out;
+	out_writer_t w;
+	int64_t time, pre_time = CSV_TIME_NONE;
+	int64_t *ptime = ((job->kind == REPLAY_TDIS) && (replay_interval <= 0)) ? &time : NULL;
+	est_phase_t phase;
+
+	if (replay_stats_alloc(job) != 0)
+	{
+		job->error = 1;
+		return;
+	}
+	if ((job->error = replay_src_open(&src, job)) != 0)
+		return;
+	if (out_open(&w, job->dest, 0, replay_background) != 0)
+	{
+		replay_src_close(&src);
+		job->error = 1;
+		return;
+	}
+	estimator_init(&ctx);
+	ctx.gap_max = replay_gap;
+	estimator_set_stats(&ctx, replay_solver_stats);
+
+	/* write first row */
+	out_puts(&w, replay_headers[job->kind]);
+
+	while (replay_src_next(&src, data, ptime))
+	{
+		T_interval = replay_dt(ptime, &pre_time);
+		phase = replay_sample(job, &ctx, data, T_interval, &sample);
+		if ((job->kind == REPLAY_TDIS) && (replay_gap > 0) && (T_interval > replay_gap))
+			job->gaps++;
+		estimator_step(&ctx, &sample, replay_masks[job->kind], &out);
+		replay_emit(job, &w, job->stats, data, phase, &out);
+		job->rows++;
+	}
+	memcpy(job->solvers, ctx.stats, sizeof(job->solvers));
+
+	if (out_close(&w) != 0)
+		job->error = 1;
+	else if (!src.cached && src.csv.error)
+		job->error = 3;
+	replay_src_close(&src);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_chunk_solve()
+ *
+ * \brief		-c, first pass over a chunk: the steady outputs of every row, the gain of the
+ *				delay and the delay of the whole chunk as t_dis_delay[hi-1] = A*pre + B, where
+ *				pre is the delay before the chunk. A chunk starts with an empty skip cache, so
+ *				it solves its first row, which gives the same outputs as the sequential replay.
+*/
+//-------------------------------------------------------------------------------------------------
+static void *replay_chunk_solve(void *arg)
+{
+	replay_chunk_t *c = arg;
+	estimator_ctx_t ctx;
+	estimator_sample_t sample = {0};
+	replay_row_t *r;
+	int seeded = (c->lo > 0);	// the delay holds a value before every chunk but the first
+
+	estimator_init(&ctx);
+	ctx.gap_max = replay_gap;
+	estimator_set_stats(&ctx, replay_solver_stats);
+	c->A = 1;
+	c->B = 0;
+	for (size_t i = c->lo; i < c->hi; i++)
+	{
+		r = &c->rows[i];
+		r->phase = replay_sample(c->job, &ctx, r->data, r->T_interval, &sample);
+		estimator_step(&ctx, &sample, replay_masks[c->job->kind] & ~EST_OUT_TDIS_DELAY, &r->out);
+		r->gain = 0;
+		if ((c->job->kind != REPLAY_TDIS) || !(r->out.valid & EST_OUT_TDIS))
+			continue;
+
+		/* y = y + (t_dis - y)*gain = (1 - gain)*y + gain*t_dis */
+		r->gain = estimator_delay_gain(&ctx, &sample, seeded);
+		if (r->gain > 0)
+		{
+			c->A = (1 - r->gain) * c->A;
+			c->B = (1 - r->gain) * c->B + r->gain * r->out.t_dis;
+			seeded = 1;
+		}
+	}
+	memcpy(c->solvers, ctx.stats, sizeof(c->solvers));
+	return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_chunk_emit()
+ *
+ * \brief		-c, second pass over a chunk: run the delay from the value before the chunk, as
+ *				estimator_step() does, and write the rows to memory.
+*/
+//-------------------------------------------------------------------------------------------------
+static void *replay_chunk_emit(void *arg)
+{
+	replay_chunk_t *c = arg;
+	replay_row_t *r;
+	float y = c->pre;
+
+	if (out_open(&c->w, NULL, 0, 0) != 0)
+	{
+		c->error = 1;
+		return NULL;
+	}
+	for (size_t i = c->lo; i < c->hi; i++)
+	{
+		r = &c->rows[i];
+		if ((c->job->kind == REPLAY_TDIS) && (r->out.valid & EST_OUT_TDIS))
+		{
+			if (r->out.not_converged & EST_OUT_TDIS)
+				r->out.not_converged |= EST_OUT_TDIS_DELAY;
+			if (r->gain > 0)
+			{
+				y = (r->gain >= 1) ? r->out.t_dis : y + (r->out.t_dis - y) * r->gain;
+				r->out.t_dis_delay = y;
+				r->out.valid |= EST_OUT_TDIS_DELAY;
+			}
+		}
+		replay_emit(c->job, &c->w, c->stats, r->data, r->phase, &r->out);
+	}
+	c->error = c->w.error;
+	return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_chunk_run()
+ *
+ * \brief		Run fn on every chunk, one thread per chunk, the first one on this thread.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_chunk_run(replay_chunk_t *chunks, long n, void *(*fn)(void *))
+{
+	pthread_t *threads = malloc(n * sizeof(pthread_t));
+	long started = 0;
+
+	/* without threads the chunks run here one after another */
+	if (threads != NULL)
+	{
+		while ((started + 1 < n) && (pthread_create(&threads[started], NULL, fn, &chunks[started + 1]) == 0))
+			started++;
+	}
+	fn(&chunks[0]);
+	for (long k = started + 1; k < n; k++)
+		fn(&chunks[k]);
+	for (long k = 0; k < started; k++)
+		pthread_join(threads[k], NULL);
+	free(threads);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_file_chunked()
+ *
+ * \brief		-c, replay one log on n_threads threads. The rows are loaded, split into chunks
+ *				and solved in parallel. The delay is the only state carried from row to row and
+ *				it is linear, so each chunk reduces to t_dis_delay = A*pre + B; a scan over the
+ *				chunks gives the delay before every chunk, then the chunks run the delay from
+ *				there and format their rows in parallel. The outputs are the ones of
+ *				replay_file(), t_dis_delay to float rounding at the start of a chunk.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_file_chunked(replay_job_t *job, long n_threads)
+{
+	replay_src_t src;
+	replay_row_t *rows = NULL, *r;
+	size_t n = 0, cap = 0;
+	replay_chunk_t *chunks;
+	long n_chunks;
+	out_writer_t w;
+	int64_t time, pre_time = CSV_TIME_NONE;
+	int64_t *ptime = ((job->kind == REPLAY_TDIS) && (replay_interval <= 0)) ? &time : NULL;
+	float data[COL_N];
+	double y;
+
+	if (replay_stats_alloc(job) != 0)
+	{
+		job->error = 1;
+		return;
+	}
+	if ((job->error = replay_src_open(&src, job)) != 0)
+		return;
+
+	/* load, the intervals need the rows in order */
+	while (replay_src_next(&src, data, ptime))
+	{
+		if (n == cap)
+		{
+			cap = cap ? cap * 2 : 4096;
+			if ((r = realloc(rows, cap * sizeof(replay_row_t))) == NULL)
+			{
+				free(rows);
+				replay_src_close(&src);
+				job->error = 1;
+				return;
+			}
+			rows = r;
+		}
+		r = &rows[n++];
+		memcpy(r->data, data, sizeof(data));
+		r->T_interval = replay_dt(ptime, &pre_time);
+		if ((job->kind == REPLAY_TDIS) && (replay_gap > 0) && (r->T_interval > replay_gap))
+			job->gaps++;
+	}
+	if (!src.cached && src.csv.error)
+		job->error = 3;
+	replay_src_close(&src);
+
+	n_chunks = (long)(n / REPLAY_CHUNK_MIN);
+	n_chunks = (n_chunks > n_threads) ? n_threads : (n_chunks < 1) ? 1 : n_chunks;
+	if ((chunks = calloc(n_chunks, sizeof(replay_chunk_t))) == NULL)
+	{
+		free(rows);
+		job->error = 1;
+		return;
+	}
+	for (long k = 0; k < n_chunks; k++)
+	{
+		chunks[k].job = job;
+		chunks[k].rows = rows;
+		chunks[k].lo = n * k / n_chunks;
+		chunks[k].hi = n * (k + 1) / n_chunks;
+		for (int m = 0; m < MET_N; m++)
+			for (int p = 0; p < EST_PHASE_N; p++)
+				stats_init(&chunks[k].stats[m][p]);
+	}
+
+	replay_chunk_run(chunks, n_chunks, replay_chunk_solve);
+
+	/* scan: delay before each chunk */
+	y = 0;
+	for (long k = 0; k < n_chunks; k++)
+	{
+		chunks[k].pre = (float)y;
+		y = chunks[k].A * y + chunks[k].B;
+	}
+
+	replay_chunk_run(chunks, n_chunks, replay_chunk_emit);
+
+	/* the chunks in order */
+	if (out_open(&w, job->dest, 0, replay_background) != 0)
+		job->error = 1;
+	else
+	{
+		out_puts(&w, replay_headers[job->kind]);
+		for (long k = 0; k < n_chunks; k++)
+		{
+			if (chunks[k].error)
+				job->error = 1;
+			out_write(&w, chunks[k].w.buf[0], chunks[k].w.len);
+		}
+		if (out_close(&w) != 0)
+			job->error = 1;
+	}
+	for (long k = 0; k < n_chunks; k++)
+	{
+		for (int m = 0; m < MET_N; m++)
+			for (int p = 0; p < EST_PHASE_N; p++)
+				stats_merge(&job->stats[m][p], &chunks[k].stats[m][p]);
+		for (int v = 0; v < EST_SOLVER_N; v++)
+			solver_stats_merge(&job->solvers[v], &chunks[k].solvers[v]);
+		if (chunks[k].w.buf[0] != NULL)
+			out_close(&chunks[k].w);
+	}
+	job->rows = (long)n;
+	free(chunks);
+	free(rows);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_identify()
+ *
+ * \brief		-m, size, time and content hash of the log for the manifest, taken before it
+ *				is replayed so a log changed meanwhile is replayed again next time.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_identify(replay_job_t *job)
+{
+	if ((manifest_stat(job->src, &job->size, &job->mtime_ns) != 0) ||
+		(manifest_file_hash(job->src, &job->hash) != 0))
+		job->size = -1;		// not recorded
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_worker()
+ *
+ * \brief		Thread of the pool: replays the next job of the work list until none is left.
+ *				Jobs up to date by the manifest are skipped, with -m the log is identified
+ *				before it is replayed.
+*/
+//-------------------------------------------------------------------------------------------------
+static void *replay_worker(void *arg)
+{
+	replay_pool_t *pool = arg;
+	size_t i;
+
+	for (;;)
+	{
+		pthread_mutex_lock(&pool->lock);
+		i = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+		if (i >= pool->n)
+			break;
+		if (pool->jobs[i].up_to_date)
+			continue;
+		if (replay_manifest != NULL)
+			replay_identify(&pool->jobs[i]);
+		replay_file(&pool->jobs[i]);
+	}
+	return NULL;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_config_hash()
+ *
+ * \brief		-m, hash of everything besides the log the results depend on: the build of
+ *				the tool (BUILD_ID, see the Makefile), the estimator parameters (FW, tau
+ *				schedule, COE_32), the options of the replay, -p included as the solver
+ *				counters are kept in the manifest, and the outputs of the estimator
+ *				for a fixed grid of inputs. The grid is run once with a new context per
+ *				sample and once as a sequence through one context, with changing intervals
+ *				and gaps, so the delay and its seeding are part of it. The grid stands for
+ *				the model where the build is unknown.
+*/
+//-------------------------------------------------------------------------------------------------
+static uint64_t replay_config_hash(void)
+{
+	static const float ps[] = {500, 800, 1100};
+	static const float pd[] = {1800, 2600, 3400};
+	static const float speed[] = {30, 60, 90};
+	static const float st[] = {0, 10, 20};
+	static const float dt[] = {REPLAY_INTERVAL, 1, 5, 0.5f, 40, 2.5f, 300};	// 40 s and 300 s are gaps
+	static const char version[] = "sensor_replay result 1";	// layout of the result files
+	static const size_t record = sizeof(replay_record_t);		// layout of the manifest data
+	static const char build[] = BUILD_ID;
+	estimator_ctx_t ctx, seq;
+	estimator_sample_t sample = {0};
+	estimator_outputs_t out;
+	uint64_t h = manifest_hash(MANIFEST_HASH_INIT, version, sizeof(version));
+	float v[4];
+
+	h = manifest_hash(h, build, sizeof(build));
+	h = manifest_hash(h, &record, sizeof(record));
+	estimator_init(&ctx);
+	h = manifest_hash(h, &ctx.params.fw, sizeof(ctx.params.fw));
+	h = manifest_hash(h, ctx.params.tau, sizeof(ctx.params.tau));
+	h = manifest_hash(h, ctx.params.coe, COMP_COE_N * sizeof(float));
+	h = manifest_hash(h, &replay_shortest, sizeof(replay_shortest));
+	h = manifest_hash(h, &replay_interval, sizeof(replay_interval));
+	h = manifest_hash(h, &replay_gap, sizeof(replay_gap));
+	h = manifest_hash(h, &replay_chunked, sizeof(replay_chunked));
+	h = manifest_hash(h, &replay_solver_stats, sizeof(replay_solver_stats));
+
+	estimator_init(&seq);
+	seq.gap_max = 30;
+	for (int k = 0; k < 2; k++)
+	{
+		for (int i = 0; i < 81 * 3; i++)
+		{
+			/* k = 0: a new context per sample, so the skip of unchanged samples does not matter */
+			if (k == 0)
+				estimator_init(&ctx);
+			sample.p_suc_g = ps[i % 3];
+			sample.p_dis_g = pd[i / 3 % 3];
+			sample.compSpeed = speed[i / 9 % 3];
+			sample.t_suc = st[i / 27 % 3];
+			sample.t_dis = 60 + 10 * (i / 81);
+			sample.I_test = 5 + 5 * (i / 81);
+			sample.U = 220;
+			sample.tau = ctx.params.tau[(k == 0) ? EST_PHASE_RUNNING : (i / 9 % EST_PHASE_N)];
+			sample.T_interval = (k == 0) ? REPLAY_INTERVAL : dt[i % (sizeof(dt) / sizeof(dt[0]))];
+			estimator_step((k == 0) ? &ctx : &seq, &sample, EST_OUT_ALL, &out);
+			v[0] = out.t_dis;
+			v[1] = out.t_dis_delay;
+			v[2] = out.p_dis_temp;
+			v[3] = out.p_dis_curr;
+			h = manifest_hash(h, v, sizeof(v));
+			h = manifest_hash(h, &out.valid, sizeof(out.valid));
+			h = manifest_hash(h, &out.not_converged, sizeof(out.not_converged));
+		}
+	}
+	return h;
+}
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_json_stats()
+ *
+ * \brief		Write {"<metric>": {"all": {...}, "off": {...}, ...}, ...} for the metrics with samples.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_json_stats(FILE *fp, err_stats_t (*stats)[EST_PHASE_N], const char *indent)
+{
+	err_stats_t all;
+	int first = 1;
+
+	fprintf(fp, "{");
+	for (int m = 0; m < MET_N; m++)
+	{
+		stats_init(&all);
+		for (int p = 0; p < EST_PHASE_N; p++)
+			stats_merge(&all, &stats[m][p]);
+		if (all.n + all.excluded == 0)
+			continue;
+
+		fprintf(fp, "%s\n%s  \"%s\": {\n%s    \"all\": ", first ? "" : ",", indent, replay_metric_names[m], indent);
+		stats_json(fp, &all);
+		for (int p = 0; p < EST_PHASE_N; p++)
+		{
+			fprintf(fp, ",\n%s    \"%s\": ", indent, replay_phase_names[p]);
+			stats_json(fp, &stats[m][p]);
+		}
+		fprintf(fp, "\n%s  }", indent);
+		first = 0;
+	}
+	fprintf(fp, "\n%s}", indent);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_solver_percentile()
+ *
+ * \brief		-p, iterations below which a share q of the runs of a solver stopped.
+*/
+//-------------------------------------------------------------------------------------------------
+static int replay_solver_percentile(const solver_stats_t *st, double q)
+{
+	unsigned long n = 0;
+	int i;
+
+	for (i = 0; i < SOLVER_HIST_N - 1; i++)
+	{
+		n += st->hist[i];
+		if (n >= q * st->runs)
+			break;
+	}
+	return i;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_json_solvers()
+ *
+ * \brief		-p, write {"<solver>": {...}, ...} for the solvers which ran.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_json_solvers(FILE *fp, const solver_stats_t *solvers, const char *indent)
+{
+	const solver_stats_t *st;
+	int first = 1;
+	int last;
+
+	fprintf(fp, "{");
+	for (int v = 0; v < EST_SOLVER_N; v++)
+	{
+		st = &solvers[v];
+		if (st->runs == 0)
+			continue;
+		fprintf(fp, "%s\n%s  \"%s\": {\"runs\": %lu, \"not_converged\": %lu, \"iterations\": %lu, "
+				"\"iterations_p50\": %d, \"iterations_p95\": %d, \"residual_max\": %g, \"residual_mean\": %g, "
+				"\"err_bound_max\": %g, \"err_bound_mean\": %g, \"hist\": [",
+				first ? "" : ",", indent, replay_solver_names[v], st->runs, st->not_converged, st->iterations,
+				replay_solver_percentile(st, 0.5), replay_solver_percentile(st, 0.95), st->residual_max,
+				st->residual_sum / st->runs, st->err_bound_max, st->err_bound_sum / st->runs);
+		/* up to the last bin in use */
+		for (last = SOLVER_HIST_N - 1; (last > 0) && (st->hist[last] == 0); last--)
+			;
+		for (int i = 0; i <= last; i++)
+			fprintf(fp, "%s%lu", i ? ", " : "", st->hist[i]);
+		fprintf(fp, "]}");
+		first = 0;
+	}
+	fprintf(fp, "\n%s}", indent);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_json_str()
+ *
+ * \brief		Write a string as a JSON string.
+*/
+//-------------------------------------------------------------------------------------------------
+static void replay_json_str(FILE *fp, const char *str)
+{
+	fputc('"', fp);
+	for (; *str; str++)
+	{
+		if ((*str == '"') || (*str == '\\'))
+			fputc('\\', fp);
+		if ((unsigned char)*str < 0x20)
+			fprintf(fp, "\\u%04x", *str);
+		else
+			fputc(*str, fp);
+	}
+	fputc('"', fp);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			replay_summary()
+ *
+ * \brief		Write the summary JSON: total statistics and the statistics of every file.
+ *
+ * \return		0 if ok, -1 if the file can not be written.
+*/
+//-------------------------------------------------------------------------------------------------
+static int replay_summary(const char *path, const replay_pool_t *pool, err_stats_t (*total)[EST_PHASE_N],
+						  const solver_stats_t *solvers, long rows)
+{
+	FILE *fp;
+	int first = 1;
+
+	if ((fp = fopen(path, "w")) == NULL)
+		return -1;
+	/* rows and total of all logs, those of the up to date logs from the manifest */
+	for (size_t i = 0; i < pool->n; i++)
+		if (!pool->jobs[i].error && pool->jobs[i].up_to_date)
+			rows += pool->jobs[i].rows;
+	fprintf(fp, "{\n  \"rows\": %ld,\n  \"total\": ", rows);
+	replay_json_stats(fp, total, "  ");
+	if (replay_solver_stats)
+	{
+		fprintf(fp, ",\n  \"solvers\": ");
+		replay_json_solvers(fp, solvers, "  ");
+	}
+	fprintf(fp, ",\n  \"files\": [");
+	for (size_t i = 0; i < pool->n; i++)
+	{
+		if (pool->jobs[i].error)
+			continue;
+		fprintf(fp, "%s\n    {\n      \"src\": ", first ? "" : ",");
+		replay_json_str(fp, pool->jobs[i].src);
+		fprintf(fp, ",\n      \"rows\": %ld,\n      \"gaps\": %ld", pool->jobs[i].rows, pool->jobs[i].gaps);
+		if (pool->jobs[i].up_to_date)
+			fprintf(fp, ",\n      \"up_to_date\": true");
+		fprintf(fp, ",\n      \"stats\": ");
+		replay_json_stats(fp, pool->jobs[i].stats, "      ");
+		if (replay_solver_stats)
+		{
+			fprintf(fp, ",\n      \"solvers\": ");
+			replay_json_solvers(fp, pool->jobs[i].solvers, "      ");
+		}
+		fprintf(fp, "\n    }");
+		first = 0;
+	}
+	fprintf(fp, "\n  ]\n}\n");
+
+	return (fclose(fp) == 0) ? 0 : -1;
+}
+
+
+
+
+int main(int argc, char *argv[])
+{
+	replay_pool_t pool = {0};
+	pthread_t *threads;
+	const char *out_dir = NULL;
+	const char *summary = NULL;
+	err_stats_t total[MET_N][EST_PHASE_N], all;
+	solver_stats_t solvers[EST_SOLVER_N] = {0};
+	const solver_stats_t *sv;
+	long n_threads = 0;
+	long rows = 0;
+	int errors = 0;
+	manifest_t manifest;
+	manifest_entry_t *e, entry;
+	replay_record_t *record = NULL;
+	const replay_record_t *kept;
+	size_t up_to_date = 0;
+	size_t replayed = 0;	// logs replayed without error, errors also counts failed writes
+	struct stat st;
+	glob_t gl;
+	int a;
+
+	for (a = 1; a < argc; a++)
+	{
+		if ((strcmp(argv[a], "-j") == 0) && (a + 1 < argc))
+			n_threads = atol(argv[++a]);
+		else if ((strcmp(argv[a], "-o") == 0) && (a + 1 < argc))
+			out_dir = argv[++a];
+		else if (strcmp(argv[a], "-r") == 0)
+			replay_shortest = 1;
+		else if (strcmp(argv[a], "-w") == 0)
+			replay_background = 1;
+		else if ((strcmp(argv[a], "-i") == 0) && (a + 1 < argc))
+			replay_interval = atof(argv[++a]);
+		else if ((strcmp(argv[a], "-g") == 0) && (a + 1 < argc))
+			replay_gap = atof(argv[++a]);
+		else if ((strcmp(argv[a], "-s") == 0) && (a + 1 < argc))
+			summary = argv[++a];
+		else if (strcmp(argv[a], "-c") == 0)
+			replay_chunked = 1;
+		else if ((strcmp(argv[a], "-m") == 0) && (a + 1 < argc))
+			replay_manifest = argv[++a];
+		else if (strcmp(argv[a], "-p") == 0)
+			replay_solver_stats = 1;
+		else
+			break;
+	}
+	if ((a >= argc) || (argv[a][0] == '-'))
+	{
+		/* -h or an unknown option */
+		printf("usage: %s [-j threads] [-c] [-o out_dir] [-r] [-w] [-i s] [-g s] [-s summary.json] [-m manifest] [-p]\n"
+			   "       dir|file|\"glob\"...\n", argv[0]);
+		return 1;
+	}
+	if ((out_dir != NULL) && (stat(out_dir, &st) != 0) && (mkdir(out_dir, 0777) != 0))
+	{
+		printf("Error creating directory %s\n", out_dir);
+		return 1;
+	}
+
+	/* work list, in argument order */
+	for (; a < argc; a++)
+	{
+		if (strpbrk(argv[a], "*?[") != NULL)
+		{
+			if (glob(argv[a], 0, NULL, &gl) == 0)
+			{
+				for (size_t i = 0; i < gl.gl_pathc; i++)
+					replay_add(&pool, gl.gl_pathv[i], out_dir);
+			}
+			globfree(&gl);
+		}
+		else if ((stat(argv[a], &st) == 0) && S_ISDIR(st.st_mode))
+			replay_add_dir(&pool, argv[a], out_dir);
+		else
+			replay_add(&pool, argv[a], out_dir);
+	}
+
+	/* -m: results still valid are not made again */
+	if (replay_manifest != NULL)
+	{
+		if ((manifest_load(&manifest, replay_manifest, replay_config_hash()) < 0) ||
+			((record = malloc(sizeof(replay_record_t))) == NULL))
+		{
+			printf("Error reading %s\n", replay_manifest);
+			return 1;
+		}
+		for (size_t i = 0; i < pool.n; i++)
+		{
+			/* up to date with its statistics, else replayed */
+			e = manifest_find(&manifest, pool.jobs[i].src);
+			if ((e != NULL) && (e->data_size == sizeof(replay_record_t)) && manifest_fresh(e, pool.jobs[i].dest) &&
+				(replay_stats_alloc(&pool.jobs[i]) == 0))
+			{
+				kept = e->data;
+				memcpy(pool.jobs[i].stats, kept->stats, sizeof(kept->stats));
+				memcpy(pool.jobs[i].solvers, kept->solvers, sizeof(kept->solvers));
+				pool.jobs[i].up_to_date = 1;
+				pool.jobs[i].rows = e->rows;
+				pool.jobs[i].gaps = e->gaps;
+				up_to_date++;
+			}
+		}
+	}
+
+	/* thread pool sized to the cores */
+	if (n_threads <= 0)
+		n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (n_threads <= 0)
+		n_threads = 1;
+	if (replay_chunked)
+	{
+		/* -c: the logs one after another, each split over the threads */
+		for (size_t i = 0; i < pool.n; i++)
+		{
+			if (pool.jobs[i].up_to_date)
+				continue;
+			if (replay_manifest != NULL)
+				replay_identify(&pool.jobs[i]);
+			replay_file_chunked(&pool.jobs[i], n_threads);
+		}
+	}
+	else
+	{
+		if ((size_t)n_threads > pool.n - up_to_date)
+			n_threads = (pool.n > up_to_date) ? (long)(pool.n - up_to_date) : 1;
+		pthread_mutex_init(&pool.lock, NULL);
+		threads = malloc(n_threads * sizeof(pthread_t));
+		for (long i = 0; i < n_threads; i++)
+			pthread_create(&threads[i], NULL, replay_worker, &pool);
+		for (long i = 0; i < n_threads; i++)
+			pthread_join(threads[i], NULL);
+		pthread_mutex_destroy(&pool.lock);
+		free(threads);
+	}
+
+	/* summary, in work list order */
+	for (int m = 0; m < MET_N; m++)
+		for (int p = 0; p < EST_PHASE_N; p++)
+			stats_init(&total[m][p]);
+	for (size_t i = 0; i < pool.n; i++)
+	{
+		if (pool.jobs[i].error)
+		{
+			printf("Error replaying %s: %s\n", pool.jobs[i].src,
+				   (pool.jobs[i].error == 2) ? "missing column" :
+				   (pool.jobs[i].error == 3) ? "damaged or truncated" : "can not open or write");
+			errors++;
+			continue;
+		}
+		if (pool.jobs[i].up_to_date)
+			printf("%s: up to date -> %s\n", pool.jobs[i].src, pool.jobs[i].dest);
+		else
+		{
+			printf("%s: %ld rows", pool.jobs[i].src, pool.jobs[i].rows);
+			if (pool.jobs[i].gaps)
+				printf(", %ld gaps", pool.jobs[i].gaps);
+			printf(" -> %s\n", pool.jobs[i].dest);
+			rows += pool.jobs[i].rows;
+			replayed++;
+		}
+		if ((replay_manifest != NULL) && !pool.jobs[i].up_to_date && (pool.jobs[i].size >= 0) &&
+			(manifest_stat(pool.jobs[i].dest, &entry.out_size, &entry.out_mtime_ns) == 0) &&
+			(manifest_file_hash(pool.jobs[i].dest, &entry.out_hash) == 0))
+		{
+			snprintf(entry.src, sizeof(entry.src), "%s", pool.jobs[i].src);
+			snprintf(entry.dest, sizeof(entry.dest), "%s", pool.jobs[i].dest);
+			entry.size = pool.jobs[i].size;
+			entry.mtime_ns = pool.jobs[i].mtime_ns;
+			entry.hash = pool.jobs[i].hash;
+			entry.rows = pool.jobs[i].rows;
+			entry.gaps = pool.jobs[i].gaps;
+			memcpy(record->stats, pool.jobs[i].stats, sizeof(record->stats));
+			memcpy(record->solvers, pool.jobs[i].solvers, sizeof(record->solvers));
+			entry.data = record;
+			entry.data_size = sizeof(replay_record_t);
+			if (manifest_put(&manifest, &entry) != 0)
+				errors++;
+		}
+		for (int m = 0; m < MET_N; m++)
+			for (int p = 0; p < EST_PHASE_N; p++)
+				stats_merge(&total[m][p], &pool.jobs[i].stats[m][p]);
+		for (int v = 0; v < EST_SOLVER_N; v++)
+			solver_stats_merge(&solvers[v], &pool.jobs[i].solvers[v]);
+	}
+	for (int m = 0; m < MET_N; m++)
+	{
+		stats_init(&all);
+		for (int p = 0; p < EST_PHASE_N; p++)
+			stats_merge(&all, &total[m][p]);
+		if (all.n)
+			printf("%-12s n %7ld  bias %9.4f  mae %9.4f  rmse %9.4f  p95 %9.4f  max %9.4f\n", replay_metric_names[m],
+				   all.n, all.sum / all.n, all.sum_abs / all.n, sqrt(all.sum_sq / all.n),
+				   stats_percentile(&all, 0.95), all.max_abs);
+	}
+	for (int v = 0; v < EST_SOLVER_N; v++)
+	{
+		sv = &solvers[v];
+		if (sv->runs)
+			printf("%-12s runs %7lu  not conv %5lu  iter mean %5.1f  p50 %2d  p95 %2d  residual max %9.4g  "
+				   "bound max %9.4g\n", replay_solver_names[v], sv->runs, sv->not_converged,
+				   (double)sv->iterations / sv->runs, replay_solver_percentile(sv, 0.5),
+				   replay_solver_percentile(sv, 0.95), sv->residual_max, sv->err_bound_max);
+	}
+	if ((summary != NULL) && (replay_summary(summary, &pool, total, solvers, rows) != 0))
+	{
+		printf("Error writing %s\n", summary);
+		errors++;
+	}
+	if (replay_manifest != NULL)
+	{
+		if (manifest_save(&manifest, replay_manifest) != 0)
+		{
+			printf("Error writing %s\n", replay_manifest);
+			errors++;
+		}
+		manifest_free(&manifest);
+		free(record);
+	}
+	printf("%zu files, %ld rows, %ld threads", replayed, rows, n_threads);
+	if (replay_manifest != NULL)
+		printf(", %zu up to date", up_to_date);
+	printf("\n");
+	for (size_t i = 0; i < pool.n; i++)
+		free(pool.jobs[i].stats);
+	free(pool.jobs);
+
+	return errors ? 1 : 0;
+}
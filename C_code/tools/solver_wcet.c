@@ -0,0 +1,203 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		solver_wcet.c
+ *
+ * \brief		Host harness: iteration count of the discharge pressure solvers over logged data.
+ * \brief		Reports the worst case, the distribution and, for an iteration budget, how many
+ * \brief		samples do not converge and how far the budgeted estimate is off.
+ * \brief		Usage: solver_wcet [-b budget] temp_data/ *_tdis.csv temp_data1/ *_pd_current.csv
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "sensor_predict.h"
+#include "csv_reader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		iter_stat_t
+ * \brief		Iteration statistic of one solver.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	const char *name;
+	unsigned int iter_max;
+	long hist[PDIS_TEMP_ITER_MAX + 1];	// samples by iterations, full budget
+	long n;
+	unsigned int worst;
+	char worst_at[256];					// file:row of the worst case
+	long not_converged;					// full budget
+	long budget_not_converged;			// -b budget
+	double budget_err_max;				// max |budgeted - full| in kPa
+	double budget_bound_max;			// max error bound of the not converged samples in kPa
+} iter_stat_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			iter_add()
+ *
+ * \brief		Add one sample: iterations of the run with the full limit and, with -b, the
+ *				deviation of the budgeted run from it.
+ *
+ * \param[in]	s = statistic.
+ * \param[in]	full = result with the full iteration limit.
+ * \param[in]	part = result with the -b budget, NULL without -b.
+ * \param[in]	file = log, for the worst case.
+ * \param[in]	row = row of the log.
+*/
+//-------------------------------------------------------------------------------------------------
+static void iter_add(iter_stat_t *s, const pdis_result_t *full, const pdis_result_t *part,
+					 const char *file, long row)
+{
+	double d;
+
+	s->hist[full->iterations]++;
+	s->n++;
+	if (full->iterations > s->worst)
+	{
+		s->worst = full->iterations;
+		snprintf(s->worst_at, sizeof(s->worst_at), "%s:%ld", file, row);
+	}
+	if (!full->converged)
+		s->not_converged++;
+
+	if (part != NULL)
+	{
+		if (!part->converged)
+		{
+			s->budget_not_converged++;
+			s->budget_bound_max = (part->err_bound > s->budget_bound_max) ? part->err_bound : s->budget_bound_max;
+		}
+		d = fabs(part->p_dis - full->p_dis);
+		s->budget_err_max = (d > s->budget_err_max) ? d : s->budget_err_max;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			iter_print()
+ *
+ * \brief		Print the worst case, the percentiles of the iterations and, with a budget,
+ *				its accuracy.
+ *
+ * \param[in]	s = statistic.
+ * \param[in]	budget = -b iterations, 0 without -b.
+*/
+//-------------------------------------------------------------------------------------------------
+static void iter_print(const iter_stat_t *s, unsigned int budget)
+{
+	long acc = 0;
+	unsigned int p50 = 0, p99 = 0, p999 = 0;
+
+	for (unsigned int i = 0; i <= s->iter_max; i++)
+	{
+		acc += s->hist[i];
+		if (!p50 && acc * 2 >= s->n)
+			p50 = i;
+		if (!p99 && acc * 100 >= s->n * 99)
+			p99 = i;
+		if (!p999 && acc * 1000 >= s->n * 999)
+			p999 = i;
+	}
+
+	printf("%s: %ld samples, limit %u iterations\n", s->name, s->n, s->iter_max);
+	printf("  worst case   %u iterations at %s\n", s->worst, s->worst_at);
+	printf("  p50 %u  p99 %u  p99.9 %u\n", p50, p99, p999);
+	printf("  not converged within the limit: %ld\n", s->not_converged);
+	if (budget)
+	{
+		printf("  budget %u: not converged %ld, max bound (not converged) %.4f kPa, max deviation %.4f kPa\n",
+			   budget, s->budget_not_converged, s->budget_bound_max, s->budget_err_max);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \var     log_cols[]
+ * \brief   Columns read from the logs, bound by name from the header.
+ */
+//-------------------------------------------------------------------------------------------------
+enum {COL_PD = 0, COL_PS, COL_SPEED, COL_ST, COL_T_DIS, COL_COMP_CU, COL_N};
+static const char *const log_cols[COL_N] = {"Pd", "Ps", "CompSpeed", "ST", "T_dis", "Comp_cu"};
+
+
+
+
+int main(int argc, char const *argv[])
+{
+	csv_reader_t csv;
+	int col[COL_N];
+	float data[COL_N];
+	unsigned int budget = 0;
+	pdis_result_t full, part;
+	iter_stat_t st_temp = {"pred_Pdis_temp", PDIS_TEMP_ITER_MAX};
+	iter_stat_t st_curr = {"pred_Pdis_curr", PDIS_CURR_ITER_MAX};
+	int a = 1;
+
+	if ((argc > 2) && (strcmp(argv[1], "-b") == 0))
+	{
+		budget = (unsigned int)atoi(argv[2]);
+		a = 3;
+	}
+	if (a >= argc)
+	{
+		printf("usage: %s [-b budget] file.csv...\n", argv[0]);
+		return 1;
+	}
+
+	for (; a < argc; a++)
+	{
+		if (csv_open(&csv, argv[a]) != 0)
+		{
+			printf("Error opening %s\n", argv[a]);
+			continue;
+		}
+
+		/* bind the columns by the header */
+		if ((csv_next_row(&csv) < 0) || (csv_bind(&csv, log_cols, COL_N, col) != 0))
+		{
+			printf("Missing column in %s\n", argv[a]);
+			csv_close(&csv);
+			continue;
+		}
+		while (csv_next_row(&csv) >= 0)
+		{
+			if (!csv_row_project(&csv, col, COL_N, data))
+				continue;
+
+			pred_Pdis_temp_budget(data[COL_PS], data[COL_ST], data[COL_T_DIS], data[COL_SPEED], 0, &full);
+			if (full.iterations)
+			{
+				if (budget)
+					pred_Pdis_temp_budget(data[COL_PS], data[COL_ST], data[COL_T_DIS], data[COL_SPEED], budget, &part);
+				iter_add(&st_temp, &full, budget ? &part : NULL, argv[a], csv.line);
+			}
+
+			pred_Pdis_curr_budget(data[COL_PS], data[COL_COMP_CU], data[COL_SPEED], 220, 0, &full);
+			if (budget)
+				pred_Pdis_curr_budget(data[COL_PS], data[COL_COMP_CU], data[COL_SPEED], 220, budget, &part);
+			iter_add(&st_curr, &full, budget ? &part : NULL, argv[a], csv.line);
+		}
+		csv_close(&csv);
+	}
+
+	iter_print(&st_temp, budget);
+	iter_print(&st_curr, budget);
+
+	return 0;
+}
@@ -182,6 +182,12 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* 1 to write a TRACE_TASK_IN record on every task switch, see trace_buf.h */
+#define TRACE_TASK_SWITCHES 0
+#if TRACE_TASK_SWITCHES && (defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__))
+  #include "trace_buf.h"
+  #define traceTASK_SWITCHED_IN() trace_write(TRACE_TASK_IN, pxCurrentTCB->uxTCBNumber, 0, 0)
+#endif
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
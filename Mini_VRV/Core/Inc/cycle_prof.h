@@ -0,0 +1,170 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		cycle_prof.h
+ *
+ * \brief		Execution time probes on the DWT cycle counter (CYCCNT) of the Cortex-M4.
+ * \brief		A probe reads the counter at its start and end, see SENSOR_PROF_BEGIN() and
+ * \brief		SENSOR_PROF_END() in sensor_prof.h, and records the cycles into the count,
+ * \brief		min, max, sum and a log2 histogram of the probe. Nothing is printed; the
+ * \brief		values are read on demand with cycle_prof_read(), or in the debugger from
+ * \brief		cycle_prof[]. The counter also drives the FreeRTOS run time stats, see
+ * \brief		cycle_prof_runtime().
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _CYCLE_PROF_H_   	        				// Re-include guard
+#define _CYCLE_PROF_H_	    		        		// Re-include guard
+
+#include "main.h"
+#include "sensor_prof.h"
+#include <stdint.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define CYCLE_PROF_EST_TASK			(SENSOR_PROF_N)		// work of one period of the estimator task
+#define CYCLE_PROF_N				(SENSOR_PROF_N + 1)	// probes, the model probes come first
+
+#define CYCLE_PROF_HIST_N			(16)	// buckets of the histogram
+#define CYCLE_PROF_HIST_MIN_LOG2	(6)		// bucket 0 < 64 cycles, bucket b in [2^(b+5), 2^(b+6)),
+											// the last bucket is open
+#define CYCLE_PROF_RUNTIME_SHIFT	(10)	// run time counter = cycles/1024, ~98 kHz at 100 MHz
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		cycle_prof_stats_t
+ * \brief		Execution time of one probe in CPU cycles.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum;
+	uint32_t hist[CYCLE_PROF_HIST_N];
+} cycle_prof_stats_t;
+
+
+extern cycle_prof_stats_t cycle_prof[CYCLE_PROF_N];
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_now()
+ *
+ * \brief		Read the cycle counter.
+ *
+ * \return		CPU cycles, wraps every 2^32 cycles.
+*/
+//-------------------------------------------------------------------------------------------------
+static inline uint32_t cycle_prof_now(void)
+{
+	return DWT->CYCCNT;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_init()
+ *
+ * \brief		Start the cycle counter and clear the probes, see configureTimerForRunTimeStats().
+*/
+//-------------------------------------------------------------------------------------------------
+void cycle_prof_init(void);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_record()
+ *
+ * \brief		Record one execution of a probe. Not locked: a probe is recorded from one task
+ *				at a time, readers copy it with cycle_prof_read().
+ *
+ * \param[in]	id = probe, sensor_prof_id_t or CYCLE_PROF_xxx.
+ * \param[in]	cycles = execution time in CPU cycles.
+*/
+//-------------------------------------------------------------------------------------------------
+void cycle_prof_record(unsigned int id, uint32_t cycles);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_read()
+ *
+ * \brief		Copy the values of a probe.
+ *
+ * \param[in]	id = probe.
+ * \param[out]	st = values of the probe.
+ *
+ * \return		mean execution time in cycles, 0 if the probe never ran.
+*/
+//-------------------------------------------------------------------------------------------------
+uint32_t cycle_prof_read(unsigned int id, cycle_prof_stats_t *st);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_name()
+ *
+ * \brief		Name of a probe.
+ *
+ * \param[in]	id = probe.
+ *
+ * \return		the name, "?" for an unknown probe.
+*/
+//-------------------------------------------------------------------------------------------------
+const char *cycle_prof_name(unsigned int id);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_reset()
+ *
+ * \brief		Clear all probes.
+*/
+//-------------------------------------------------------------------------------------------------
+void cycle_prof_reset(void);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_us()
+ *
+ * \brief		Convert cycles to microseconds at SystemCoreClock.
+ *
+ * \param[in]	cycles = CPU cycles.
+ *
+ * \return		microseconds.
+*/
+//-------------------------------------------------------------------------------------------------
+uint32_t cycle_prof_us(uint32_t cycles);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_runtime()
+ *
+ * \brief		Run time counter of FreeRTOS, see getRunTimeCounterValue(). The cycle counter
+ *				is extended to 64 bits on every call, so it must be called at least once per
+ *				2^32 cycles (43 s at 100 MHz); the scheduler calls it on every task switch.
+ *
+ * \return		CPU cycles since cycle_prof_init() >> CYCLE_PROF_RUNTIME_SHIFT.
+*/
+//-------------------------------------------------------------------------------------------------
+unsigned long cycle_prof_runtime(void);
+
+#endif                                      // re-include guard
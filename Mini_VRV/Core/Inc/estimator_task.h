@@ -0,0 +1,186 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		estimator_task.h
+ *
+ * \brief		Periodic estimator task. The acquisition side posts samples into a queue
+ * \brief		without blocking; every period (EST_TASK_PERIOD_MS on the target) the task,
+ * \brief		released by vTaskDelayUntil() on a fixed grid, steps the estimator over the
+ * \brief		queued samples and publishes the outputs of the newest one in a double
+ * \brief		buffer, which readers copy without a lock. The task counts its periods,
+ * \brief		release delays and busy time in run time counter units, so its CPU share can
+ * \brief		be read at any time.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _ESTIMATOR_TASK_H_   	        				// Re-include guard
+#define _ESTIMATOR_TASK_H_	    		        		// Re-include guard
+
+#include "FreeRTOS.h"
+#include "sensor_predict.h"
+#include <stdint.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define EST_TASK_PERIOD_MS		(1000)		// period of the estimator in ms, see estimator_task_init()
+#define EST_TASK_QUEUE_LEN		(8)			// samples buffered between two periods
+#define EST_TASK_SOLVER_STATS	(1)			// 1 to count the solver iterations, see estimator_set_stats()
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		est_input_t
+ * \brief		One sample posted by the acquisition side.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	estimator_sample_t sample;	// measured signals, tau and T_interval are set by the task.
+	float work_minutes;			// WORK_MINUTES, selects tau, see estimator_phase().
+	TickType_t tick;			// time of the measurement, xTaskGetTickCount().
+} est_input_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		est_result_t
+ * \brief		Outputs of the newest sample of a period.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	estimator_outputs_t out;
+	TickType_t tick;			// time of the sample the outputs belong to.
+	uint32_t seq;				// number of the result, 0 before the first one.
+} est_result_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		est_task_stats_t
+ * \brief		Timing of the estimator task.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t periods;			// releases of the task.
+	uint32_t samples;			// samples stepped.
+	uint32_t dropped;			// samples lost because the queue was full.
+	uint32_t idle;				// periods without a sample.
+	uint32_t overruns;			// periods whose work ended after the next release.
+	TickType_t late_max;		// largest delay of a release behind the grid in ticks.
+	uint32_t busy_last;			// busy time of the last period in run time counter units.
+	uint32_t busy_max;			// largest busy time of a period.
+	uint64_t busy_total;		// busy time since the start.
+	uint32_t start;				// run time counter at the first release.
+} est_task_stats_t;
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_init()
+ *
+ * \brief		Create the sample queue and the estimator context, before the scheduler starts.
+ *				The queue is allocated statically.
+ *
+ * \param[in]	mask = EST_OUT_xxx bits of the outputs to calculate.
+ * \param[in]	period = period of the task in ticks, pdMS_TO_TICKS(EST_TASK_PERIOD_MS) on the
+ *				target, shorter in an accelerated host simulation.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_task_init(unsigned int mask, TickType_t period);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task()
+ *
+ * \brief		Function of the estimator task, see osThreadNew().
+ *
+ * \param[in]	argument = not used.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_task(void *argument);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_post()
+ *
+ * \brief		Post a sample from a task, never blocks.
+ *
+ * \param[in]	in = sample.
+ *
+ * \return		0 if queued, -1 if the queue was full and the sample is dropped.
+*/
+//-------------------------------------------------------------------------------------------------
+int estimator_task_post(const est_input_t *in);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_post_isr()
+ *
+ * \brief		Post a sample from an interrupt.
+ *
+ * \param[in]	in = sample.
+ * \param[out]	woken = set to pdTRUE if a context switch is needed, see portYIELD_FROM_ISR().
+ *
+ * \return		0 if queued, -1 if the queue was full and the sample is dropped.
+*/
+//-------------------------------------------------------------------------------------------------
+int estimator_task_post_isr(const est_input_t *in, BaseType_t *woken);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_read()
+ *
+ * \brief		Copy the newest result. Lock free: the copy is repeated if the estimator
+ *				published meanwhile, the estimator never waits for a reader.
+ *
+ * \param[out]	res = result, res->seq is 0 if there is none yet.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_task_read(est_result_t *res);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_stats()
+ *
+ * \brief		Copy the timing of the estimator task.
+ *
+ * \param[out]	st = timing.
+ *
+ * \return		CPU share of the task since its first release in 0.01 %.
+*/
+//-------------------------------------------------------------------------------------------------
+uint32_t estimator_task_stats(est_task_stats_t *st);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_ctx()
+ *
+ * \brief		Estimator context of the task, e.g. for the solver counters ctx->stats[].
+ *				Read only, the values may change while they are read.
+ *
+ * \return		the context.
+*/
+//-------------------------------------------------------------------------------------------------
+const estimator_ctx_t *estimator_task_ctx(void);
+
+#endif                                      // re-include guard
@@ -0,0 +1,155 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		trace_buf.h
+ *
+ * \brief		Binary trace in a RAM ring buffer. Tasks and interrupts write fixed size
+ * \brief		records without a lock (trace_write()); a low priority task snapshots the
+ * \brief		FreeRTOS run time stats into the ring (trace_stats()) and drains it to ITM
+ * \brief		stimulus port TRACE_ITM_PORT (trace_drain()). trace_decode.py rebuilds the
+ * \brief		task table and the CPU shares on the host, from the SWO capture or from a
+ * \brief		memory dump of trace_ring[].
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef _TRACE_BUF_H_   	        				// Re-include guard
+#define _TRACE_BUF_H_	    		        		// Re-include guard
+
+#include <stdint.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define TRACE_RING_N		(256)		// records in the ring, power of 2
+#define TRACE_ITM_PORT		(1)			// ITM stimulus port of the drain, printf uses port 0
+#define TRACE_TASKS_MAX		(12)		// tasks in a snapshot of the run time stats
+#define TRACE_STATS_MS		(1000)		// period of the snapshots in ms
+#define TRACE_DRAIN_MS		(100)		// period of the drain in ms
+#define TRACE_SEQ_BUSY		(0xFFFFFFFFu)	// seq of a record being written
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		trace_type_t
+ * \brief		Record types; id, arg and value of each type.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	TRACE_CLOCK = 1,		// id: CYCLE_PROF_RUNTIME_SHIFT, value: SystemCoreClock in Hz, starts a snapshot
+	TRACE_TASK_NAME,		// id: task number, arg: offset in the name, value: 4 characters, first in the low byte
+	TRACE_TASK_INFO,		// id: task number, arg: priority << 8 | eTaskState, value: stack high water mark in words
+	TRACE_TASK_RUNTIME,		// id: task number, value: run time counter of the task
+	TRACE_TOTAL,			// id: tasks in the snapshot, arg: lost records, value: total run time, ends a snapshot
+	TRACE_TASK_IN,			// id: task number switched in, see TRACE_TASK_SWITCHES in FreeRTOSConfig.h
+	TRACE_EST_PERIOD,		// id: samples, arg: release delay in ticks, value: busy cycles of the estimator task
+	TRACE_USER = 0x80		// TRACE_USER and above are free for the application
+} trace_type_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		trace_rec_t
+ * \brief		One record, 4 words. seq is written last; the record is valid when seq is its
+ *				index in the stream.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	volatile uint32_t seq;	// index of the record, TRACE_SEQ_BUSY while it is written.
+	uint32_t time;			// DWT cycle counter, see cycle_prof_now().
+	uint32_t info;			// type | id << 8 | arg << 16.
+	uint32_t value;
+} trace_rec_t;
+
+
+extern trace_rec_t trace_ring[TRACE_RING_N];
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_init()
+ *
+ * \brief		Clear the ring, before the scheduler starts.
+*/
+//-------------------------------------------------------------------------------------------------
+void trace_init(void);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_write()
+ *
+ * \brief		Write a record. Lock free, from tasks and interrupts: the slot is reserved by an
+ *				atomic increment of the head. When the drain falls behind, the oldest records
+ *				are overwritten and counted as lost.
+ *
+ * \param[in]	type = trace_type_t.
+ * \param[in]	id = 8 bits, see trace_type_t.
+ * \param[in]	arg = 16 bits, see trace_type_t.
+ * \param[in]	value = see trace_type_t.
+*/
+//-------------------------------------------------------------------------------------------------
+void trace_write(unsigned int type, unsigned int id, unsigned int arg, uint32_t value);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_stats()
+ *
+ * \brief		Write a snapshot of the run time stats: TRACE_CLOCK, then names, info and run
+ *				time of every task, then TRACE_TOTAL. From a task only.
+*/
+//-------------------------------------------------------------------------------------------------
+void trace_stats(void);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_drain()
+ *
+ * \brief		Pass the complete records to trace_sink() and free them. Stops at a record
+ *				still being written. From one task only.
+ *
+ * \return		number of records drained.
+*/
+//-------------------------------------------------------------------------------------------------
+unsigned int trace_drain(void);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_sink()
+ *
+ * \brief		Output of trace_drain(), one complete record. Weak: sends the record to ITM port
+ *				TRACE_ITM_PORT if the debugger enabled it; a host build replaces it.
+ *
+ * \param[in]	rec = record.
+*/
+//-------------------------------------------------------------------------------------------------
+void trace_sink(const trace_rec_t *rec);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_lost()
+ *
+ * \brief		Records overwritten before they were drained.
+ *
+ * \return		number of records lost since trace_init().
+*/
+//-------------------------------------------------------------------------------------------------
+uint32_t trace_lost(void);
+
+#endif                                      // re-include guard
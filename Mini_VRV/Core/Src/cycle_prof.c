@@ -0,0 +1,217 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		cycle_prof.c
+ *
+ * \brief		Execution time probes on the DWT cycle counter, see cycle_prof.h.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "cycle_prof.h"
+#include <string.h>
+
+
+cycle_prof_stats_t cycle_prof[CYCLE_PROF_N];
+
+static const char *const cycle_prof_names[CYCLE_PROF_N] =
+{
+	"pred_Tdis", "estimator_step", "suction_state", "comp_coe",
+	"pdis_temp", "pdis_curr", "cal_t_sat", "cal_h_sh_gas",
+	"est_task",
+};
+
+static uint32_t runtime_last;		// CYCCNT at the last cycle_prof_runtime()
+static uint64_t runtime_cycles;		// cycles since cycle_prof_init()
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_init()
+ *
+ * \brief		Start the cycle counter and clear the probes.
+*/
+//-------------------------------------------------------------------------------------------------
+void cycle_prof_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	runtime_last = 0;
+	runtime_cycles = 0;
+	cycle_prof_reset();
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_record()
+ *
+ * \brief		Record one execution of a probe.
+ *
+ * \param[in]	id = probe.
+ * \param[in]	cycles = execution time in CPU cycles.
+*/
+//-------------------------------------------------------------------------------------------------
+void cycle_prof_record(unsigned int id, uint32_t cycles)
+{
+	cycle_prof_stats_t *st;
+	int b;
+
+	if (id >= CYCLE_PROF_N)
+	{
+		return;
+	}
+	st = &cycle_prof[id];
+
+	if ((st->count == 0) || (cycles < st->min))
+	{
+		st->min = cycles;
+	}
+	if (cycles > st->max)
+	{
+		st->max = cycles;
+	}
+	st->count++;
+	st->sum += cycles;
+
+	/* log2 bucket, __CLZ(0) is 32 */
+	b = 31 - (int)__CLZ(cycles) - (CYCLE_PROF_HIST_MIN_LOG2 - 1);
+	if (b < 0)
+	{
+		b = 0;
+	}
+	else if (b >= CYCLE_PROF_HIST_N)
+	{
+		b = CYCLE_PROF_HIST_N - 1;
+	}
+	st->hist[b]++;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_read()
+ *
+ * \brief		Copy the values of a probe with the interrupts masked.
+ *
+ * \param[in]	id = probe.
+ * \param[out]	st = values of the probe.
+ *
+ * \return		mean execution time in cycles, 0 if the probe never ran.
+*/
+//-------------------------------------------------------------------------------------------------
+uint32_t cycle_prof_read(unsigned int id, cycle_prof_stats_t *st)
+{
+	uint32_t primask;
+
+	if (id >= CYCLE_PROF_N)
+	{
+		memset(st, 0, sizeof(*st));
+		return 0;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	*st = cycle_prof[id];
+	__set_PRIMASK(primask);
+
+	return st->count ? (uint32_t)(st->sum / st->count) : 0;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_name()
+ *
+ * \brief		Name of a probe.
+ *
+ * \param[in]	id = probe.
+ *
+ * \return		the name, "?" for an unknown probe.
+*/
+//-------------------------------------------------------------------------------------------------
+const char *cycle_prof_name(unsigned int id)
+{
+	return (id < CYCLE_PROF_N) ? cycle_prof_names[id] : "?";
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_reset()
+ *
+ * \brief		Clear all probes.
+*/
+//-------------------------------------------------------------------------------------------------
+void cycle_prof_reset(void)
+{
+	uint32_t primask;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	memset(cycle_prof, 0, sizeof(cycle_prof));
+	__set_PRIMASK(primask);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_us()
+ *
+ * \brief		Convert cycles to microseconds at SystemCoreClock.
+ *
+ * \param[in]	cycles = CPU cycles.
+ *
+ * \return		microseconds.
+*/
+//-------------------------------------------------------------------------------------------------
+uint32_t cycle_prof_us(uint32_t cycles)
+{
+	return cycles / (SystemCoreClock / 1000000u);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cycle_prof_runtime()
+ *
+ * \brief		Run time counter of FreeRTOS, the cycle counter extended to 64 bits.
+ *
+ * \return		CPU cycles since cycle_prof_init() >> CYCLE_PROF_RUNTIME_SHIFT.
+*/
+//-------------------------------------------------------------------------------------------------
+unsigned long cycle_prof_runtime(void)
+{
+	uint32_t primask, now;
+	unsigned long value;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	now = DWT->CYCCNT;
+	runtime_cycles += now - runtime_last;
+	runtime_last = now;
+	value = (unsigned long)(runtime_cycles >> CYCLE_PROF_RUNTIME_SHIFT);
+	__set_PRIMASK(primask);
+
+	return value;
+}
@@ -0,0 +1,287 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		estimator_task.c
+ *
+ * \brief		Periodic estimator task, see estimator_task.h.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "estimator_task.h"
+#include "cycle_prof.h"
+#include "trace_buf.h"
+#include "main.h"
+#include "task.h"
+#include "queue.h"
+#include <string.h>
+
+
+static StaticQueue_t est_queue_buf;
+static uint8_t est_queue_storage[EST_TASK_QUEUE_LEN * sizeof(est_input_t)];
+static QueueHandle_t est_queue;
+
+static estimator_ctx_t est_ctx;
+static unsigned int est_mask;
+static TickType_t est_period;
+
+static est_result_t est_result[2];		// double buffer, est_result[est_seq & 1] is the newest.
+static volatile uint32_t est_seq;		// number of the newest result, 0 before the first one.
+
+static est_task_stats_t est_stats;
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_init()
+ *
+ * \brief		Create the sample queue and the estimator context.
+ *
+ * \param[in]	mask = EST_OUT_xxx bits of the outputs to calculate.
+ * \param[in]	period = period of the task in ticks.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_task_init(unsigned int mask, TickType_t period)
+{
+	est_queue = xQueueCreateStatic(EST_TASK_QUEUE_LEN, sizeof(est_input_t), est_queue_storage, &est_queue_buf);
+	vQueueAddToRegistry(est_queue, "est_queue");
+	estimator_init(&est_ctx);
+	estimator_set_stats(&est_ctx, EST_TASK_SOLVER_STATS);
+	est_mask = mask;
+	est_period = (period > 0) ? period : 1;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_publish()
+ *
+ * \brief		Publish a result: fill the buffer the readers do not use, then switch est_seq.
+ *
+ * \param[in]	out = outputs.
+ * \param[in]	tick = time of the sample.
+*/
+//-------------------------------------------------------------------------------------------------
+static void estimator_task_publish(const estimator_outputs_t *out, TickType_t tick)
+{
+	uint32_t seq = est_seq + 1;
+	est_result_t *res = &est_result[seq & 1];
+
+	res->out = *out;
+	res->tick = tick;
+	res->seq = seq;
+	__DMB();								// the result is complete before est_seq names it
+	est_seq = seq;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task()
+ *
+ * \brief		Every period: step the estimator over the queued samples and
+ *				publish the outputs of the newest one.
+ *
+ * \param[in]	argument = not used.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_task(void *argument)
+{
+	const TickType_t period = est_period;
+	TickType_t release, late, prev_tick = 0;
+	int have_prev = 0;
+	uint32_t t0, c0, busy;
+	est_input_t in;
+	estimator_outputs_t out;
+	int n;
+
+	(void)argument;
+	release = xTaskGetTickCount();
+	est_stats.start = portGET_RUN_TIME_COUNTER_VALUE();
+
+	for(;;)
+	{
+		vTaskDelayUntil(&release, period);		// release is now the time of this period on the grid
+		t0 = portGET_RUN_TIME_COUNTER_VALUE();
+		c0 = cycle_prof_now();
+		late = xTaskGetTickCount() - release;
+
+		n = 0;
+		while (xQueueReceive(est_queue, &in, 0) == pdTRUE)
+		{
+			in.sample.tau = est_ctx.params.tau[estimator_phase(in.work_minutes)];
+			in.sample.T_interval = have_prev ? (float)(in.tick - prev_tick) / configTICK_RATE_HZ
+											 : (float)period / configTICK_RATE_HZ;
+			prev_tick = in.tick;
+			have_prev = 1;
+			estimator_step(&est_ctx, &in.sample, est_mask, &out);
+			n++;
+		}
+		if (n)
+		{
+			estimator_task_publish(&out, in.tick);
+		}
+
+		cycle_prof_record(CYCLE_PROF_EST_TASK, cycle_prof_now() - c0);
+		trace_write(TRACE_EST_PERIOD, (n > 0xFF) ? 0xFF : n, (late > 0xFFFF) ? 0xFFFF : late, cycle_prof_now() - c0);
+		busy = portGET_RUN_TIME_COUNTER_VALUE() - t0;
+		taskENTER_CRITICAL();
+		est_stats.periods++;
+		est_stats.samples += n;
+		est_stats.idle += (n == 0);
+		est_stats.overruns += (xTaskGetTickCount() - release >= period);
+		if (late > est_stats.late_max)
+		{
+			est_stats.late_max = late;
+		}
+		est_stats.busy_last = busy;
+		if (busy > est_stats.busy_max)
+		{
+			est_stats.busy_max = busy;
+		}
+		est_stats.busy_total += busy;
+		taskEXIT_CRITICAL();
+	}
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_post()
+ *
+ * \brief		Post a sample from a task, never blocks.
+ *
+ * \param[in]	in = sample.
+ *
+ * \return		0 if queued, -1 if the queue was full and the sample is dropped.
+*/
+//-------------------------------------------------------------------------------------------------
+int estimator_task_post(const est_input_t *in)
+{
+	if (xQueueSend(est_queue, in, 0) == pdTRUE)
+	{
+		return 0;
+	}
+	taskENTER_CRITICAL();
+	est_stats.dropped++;
+	taskEXIT_CRITICAL();
+	return -1;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_post_isr()
+ *
+ * \brief		Post a sample from an interrupt.
+ *
+ * \param[in]	in = sample.
+ * \param[out]	woken = set to pdTRUE if a context switch is needed.
+ *
+ * \return		0 if queued, -1 if the queue was full and the sample is dropped.
+*/
+//-------------------------------------------------------------------------------------------------
+int estimator_task_post_isr(const est_input_t *in, BaseType_t *woken)
+{
+	UBaseType_t saved;
+
+	if (xQueueSendFromISR(est_queue, in, woken) == pdTRUE)
+	{
+		return 0;
+	}
+	saved = taskENTER_CRITICAL_FROM_ISR();
+	est_stats.dropped++;
+	taskEXIT_CRITICAL_FROM_ISR(saved);
+	return -1;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_read()
+ *
+ * \brief		Copy the newest result, repeated if the estimator published meanwhile.
+ *
+ * \param[out]	res = result, res->seq is 0 if there is none yet.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_task_read(est_result_t *res)
+{
+	uint32_t seq;
+
+	do
+	{
+		seq = est_seq;
+		__DMB();
+		if (seq == 0)
+		{
+			memset(res, 0, sizeof(*res));
+			return;
+		}
+		*res = est_result[seq & 1];
+		__DMB();
+	} while (seq != est_seq);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_stats()
+ *
+ * \brief		Copy the timing of the estimator task.
+ *
+ * \param[out]	st = timing.
+ *
+ * \return		CPU share of the task since its first release in 0.01 %.
+*/
+//-------------------------------------------------------------------------------------------------
+uint32_t estimator_task_stats(est_task_stats_t *st)
+{
+	uint32_t elapsed;
+
+	taskENTER_CRITICAL();
+	*st = est_stats;
+	taskEXIT_CRITICAL();
+
+	elapsed = portGET_RUN_TIME_COUNTER_VALUE() - st->start;
+	if (elapsed == 0)
+	{
+		return 0;
+	}
+	return (uint32_t)(st->busy_total * 10000u / elapsed);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_task_ctx()
+ *
+ * \brief		Estimator context of the task.
+ *
+ * \return		the context.
+*/
+//-------------------------------------------------------------------------------------------------
+const estimator_ctx_t *estimator_task_ctx(void)
+{
+	return &est_ctx;
+}
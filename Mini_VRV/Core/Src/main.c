@@ -23,6 +23,9 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "sensor_predict.h"
+#include "estimator_task.h"
+#include "cycle_prof.h"
+#include "trace_buf.h"
 #include <string.h>
 #include "task.h"
 #include <stdio.h>
@@ -46,7 +49,6 @@
 /* USER CODE END PM */
 
 /* Private variables ---------------------------------------------------------*/
-TIM_HandleTypeDef htim4;
 
 /* Definitions for defaultTask */
 osThreadId_t defaultTaskHandle;
@@ -67,21 +69,21 @@ osThreadId_t CPU_TaskHandle;
 const osThreadAttr_t CPU_Task_attributes = {
   .name = "CPU_Task",
   .stack_size = 128 * 4,
-  .priority = (osPriority_t) osPriorityHigh7,
+  .priority = (osPriority_t) osPriorityLow,
 };
 /* USER CODE BEGIN PV */
-uint32_t counter;
-uint32_t time1;
-uint32_t time2;
-uint8_t CPU_RunInfo[400];		//保存任务运行时间信息
-uint8_t CPU_RunInfo1[400];		//保存任务运行时间信息
+osThreadId_t estTaskHandle;
+const osThreadAttr_t estTask_attributes = {
+  .name = "estTask",
+  .stack_size = 512 * 4,
+  .priority = (osPriority_t) osPriorityHigh,
+};
 
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
-static void MX_TIM4_Init(void);
 void StartDefaultTask(void *argument);
 void StartTask02(void *argument);
 void startCPU_Task(void *argument);
@@ -132,7 +134,6 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
-  MX_TIM4_Init();
   /* USER CODE BEGIN 2 */
 
   /* USER CODE END 2 */
@@ -153,6 +154,8 @@ int main(void)
   /* USER CODE END RTOS_TIMERS */
 
   /* USER CODE BEGIN RTOS_QUEUES */
+  trace_init();
+  estimator_task_init(EST_OUT_TDIS | EST_OUT_TDIS_DELAY | EST_OUT_PDIS_TEMP, pdMS_TO_TICKS(EST_TASK_PERIOD_MS));
   /* add queues, ... */
   /* USER CODE END RTOS_QUEUES */
 
@@ -168,6 +171,7 @@ int main(void)
 
   /* USER CODE BEGIN RTOS_THREADS */
   /* add threads, ... */
+  estTaskHandle = osThreadNew(estimator_task, NULL, &estTask_attributes);
   /* USER CODE END RTOS_THREADS */
 
   /* USER CODE BEGIN RTOS_EVENTS */
@@ -235,58 +239,6 @@ void SystemClock_Config(void)
   }
 }
 
-/**
-  * @brief TIM4 Initialization Function
-  * @param None
-  * @retval None
-  */
-static void MX_TIM4_Init(void)
-{
-
-  /* USER CODE BEGIN TIM4_Init 0 */
-
-  /* USER CODE END TIM4_Init 0 */
-
-  TIM_ClockConfigTypeDef sClockSourceConfig = {0};
-  TIM_SlaveConfigTypeDef sSlaveConfig = {0};
-  TIM_MasterConfigTypeDef sMasterConfig = {0};
-
-  /* USER CODE BEGIN TIM4_Init 1 */
-
-  /* USER CODE END TIM4_Init 1 */
-  htim4.Instance = TIM4;
-  htim4.Init.Prescaler = 25-1;
-  htim4.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim4.Init.Period = 1000-1;
-  htim4.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-  htim4.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
-  if (HAL_TIM_Base_Init(&htim4) != HAL_OK)
-  {
-    Error_Handler();
-  }
-  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
-  if (HAL_TIM_ConfigClockSource(&htim4, &sClockSourceConfig) != HAL_OK)
-  {
-    Error_Handler();
-  }
-  sSlaveConfig.SlaveMode = TIM_SLAVEMODE_RESET;
-  sSlaveConfig.InputTrigger = TIM_TS_ITR0;
-  if (HAL_TIM_SlaveConfigSynchro(&htim4, &sSlaveConfig) != HAL_OK)
-  {
-    Error_Handler();
-  }
-  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
-  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
-  if (HAL_TIMEx_MasterConfigSynchronization(&htim4, &sMasterConfig) != HAL_OK)
-  {
-    Error_Handler();
-  }
-  /* USER CODE BEGIN TIM4_Init 2 */
-  HAL_TIM_Base_Start_IT(&htim4);
-  /* USER CODE END TIM4_Init 2 */
-
-}
-
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -307,6 +259,16 @@ static void MX_GPIO_Init(void)
 }
 
 /* USER CODE BEGIN 4 */
+/* FreeRTOS run time stats on the DWT cycle counter, see cycle_prof_runtime() */
+void configureTimerForRunTimeStats(void)
+{
+	cycle_prof_init();
+}
+
+unsigned long getRunTimeCounterValue(void)
+{
+	return cycle_prof_runtime();
+}
 
 /* USER CODE END 4 */
 
@@ -335,38 +297,27 @@ void StartDefaultTask(void *argument)
 * @retval None
 */
 /* USER CODE END Header_StartTask02 */
-float te(float t)
-{
-	float t2;
-	t2 = t + 100 + 100/0;
-	return t2;
-}
 
 void StartTask02(void *argument)
 {
   /* USER CODE BEGIN StartTask02 */
-	uint32_t t, temp1, temp2;
-	float	Pd = 2152.59, Ps = 1390.88, CompSpeed = 1740, ST = 20.54;
-	float t_dis, p_dis;
+	/* acquisition: one sample per second for the estimator task */
+	est_input_t in = {0};
+	TickType_t wake = xTaskGetTickCount();
 
-	float temp;
+	in.sample.p_suc_g = 1390.88;
+	in.sample.t_suc = 20.54;
+	in.sample.p_dis_g = 2152.59;
+	in.sample.compSpeed = 1740;
+	in.sample.t_dis = 56.39;
+	in.work_minutes = 30;
 
   /* Infinite loop */
   for(;;)
   {
-	  t = counter;
-	  t_dis = pred_Tdis(Ps, ST, Pd, CompSpeed);
-	  time1 = counter - t;
-	  t = counter;
-	  p_dis = pred_Pdis(641, -2.23, 56.39, 7080);
-	  time2 = counter - t;
-//	  sensor_pre_test();
-	  temp1 = 10;
-	  counter = 0;
-	  temp = te(0.1);
-	  temp1 = temp/1;
-	  temp2 = fmod(temp,1.0);
-	  osDelay(1000);
+	  in.tick = xTaskGetTickCount();
+	  estimator_task_post(&in);
+	  vTaskDelayUntil(&wake, pdMS_TO_TICKS(EST_TASK_PERIOD_MS));
   }
 
   /* USER CODE END StartTask02 */
@@ -382,23 +333,19 @@ void StartTask02(void *argument)
 void startCPU_Task(void *argument)
 {
   /* USER CODE BEGIN startCPU_Task */
+	/* run time stats and trace: binary snapshots into the trace ring, drained to ITM port 1 */
+	TickType_t wake = xTaskGetTickCount();
+	uint32_t n = 0;
+
   /* Infinite loop */
   for(;;)
   {
-
-		memset(CPU_RunInfo,0,400);				//信息缓冲区清�????
-
-		vTaskList((char *)&CPU_RunInfo);  //获取任务运行时间信息
-
-
-
-		memset(CPU_RunInfo,0,400);				//信息缓冲区清�????
-
-		vTaskGetRunTimeStats((char *)&CPU_RunInfo);
-	    printf("任务�??       运行计数         使用率\r\n");
-	    printf("%s", CPU_RunInfo);
-	    printf("---------------------------------------------\r\n\n");
-		osDelay(1000);
+	  if (n++ % (TRACE_STATS_MS / TRACE_DRAIN_MS) == 0)
+	  {
+		  trace_stats();
+	  }
+	  trace_drain();
+	  vTaskDelayUntil(&wake, pdMS_TO_TICKS(TRACE_DRAIN_MS));
   }
   /* USER CODE END startCPU_Task */
 }
@@ -420,9 +367,6 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
-  if (htim->Instance == TIM4) {
-	  counter++;
-  }
 
   /* USER CODE END Callback 1 */
 }
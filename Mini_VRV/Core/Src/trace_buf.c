@@ -0,0 +1,232 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		trace_buf.c
+ *
+ * \brief		Binary trace in a RAM ring buffer, see trace_buf.h.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "trace_buf.h"
+#include "cycle_prof.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+#define TRACE_MASK		(TRACE_RING_N - 1)
+
+trace_rec_t trace_ring[TRACE_RING_N];
+
+static uint32_t trace_head;			// index of the next record to write
+static uint32_t trace_tail;			// index of the next record to drain, drain task only
+static uint32_t trace_lost_n;		// records overwritten before they were drained
+
+static TaskStatus_t trace_tasks[TRACE_TASKS_MAX];
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_init()
+ *
+ * \brief		Clear the ring.
+*/
+//-------------------------------------------------------------------------------------------------
+void trace_init(void)
+{
+	int i;
+
+	for (i = 0; i < TRACE_RING_N; i++)
+	{
+		trace_ring[i].seq = TRACE_SEQ_BUSY;
+	}
+	trace_head = 0;
+	trace_tail = 0;
+	trace_lost_n = 0;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_write()
+ *
+ * \brief		Write a record into the slot reserved by an atomic increment of the head.
+ *
+ * \param[in]	type = trace_type_t.
+ * \param[in]	id = 8 bits.
+ * \param[in]	arg = 16 bits.
+ * \param[in]	value = value.
+*/
+//-------------------------------------------------------------------------------------------------
+void trace_write(unsigned int type, unsigned int id, unsigned int arg, uint32_t value)
+{
+	uint32_t idx = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+	trace_rec_t *rec = &trace_ring[idx & TRACE_MASK];
+
+	rec->seq = TRACE_SEQ_BUSY;
+	__DMB();								// a reader of the old record sees it change
+	rec->time = cycle_prof_now();
+	rec->info = (type & 0xFFu) | ((id & 0xFFu) << 8) | ((uint32_t)(arg & 0xFFFFu) << 16);
+	rec->value = value;
+	__DMB();								// the record is complete before seq names it
+	rec->seq = idx;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_stats()
+ *
+ * \brief		Write a snapshot of the run time stats.
+*/
+//-------------------------------------------------------------------------------------------------
+void trace_stats(void)
+{
+	uint32_t total, chars;
+	UBaseType_t n, i;
+	const TaskStatus_t *t;
+	const char *name;
+	int k, c, end;
+
+	n = uxTaskGetSystemState(trace_tasks, TRACE_TASKS_MAX, &total);
+
+	trace_write(TRACE_CLOCK, CYCLE_PROF_RUNTIME_SHIFT, 0, SystemCoreClock);
+	for (i = 0; i < n; i++)
+	{
+		t = &trace_tasks[i];
+		name = t->pcTaskName;
+		end = 0;
+		for (k = 0; (k < configMAX_TASK_NAME_LEN) && !end; k += 4)
+		{
+			chars = 0;
+			for (c = 0; c < 4; c++)
+			{
+				if ((k + c >= configMAX_TASK_NAME_LEN) || (name[k + c] == '\0'))
+				{
+					end = 1;
+					break;
+				}
+				chars |= (uint32_t)(uint8_t)name[k + c] << (8*c);
+			}
+			trace_write(TRACE_TASK_NAME, t->xTaskNumber, k, chars);
+		}
+		trace_write(TRACE_TASK_INFO, t->xTaskNumber, (t->uxCurrentPriority << 8) | t->eCurrentState,
+					t->usStackHighWaterMark);
+		trace_write(TRACE_TASK_RUNTIME, t->xTaskNumber, 0, t->ulRunTimeCounter);
+	}
+	trace_write(TRACE_TOTAL, n, (trace_lost_n > 0xFFFFu) ? 0xFFFFu : trace_lost_n, total);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_sink()
+ *
+ * \brief		Send a record to the ITM stimulus port word by word, if the debugger enabled it.
+ *
+ * \param[in]	rec = record.
+*/
+//-------------------------------------------------------------------------------------------------
+__weak void trace_sink(const trace_rec_t *rec)
+{
+	const uint32_t w[4] = {rec->seq, rec->time, rec->info, rec->value};
+	int i;
+
+	if (((ITM->TCR & ITM_TCR_ITMENA_Msk) == 0UL) || ((ITM->TER & (1UL << TRACE_ITM_PORT)) == 0UL))
+	{
+		return;
+	}
+	for (i = 0; i < 4; i++)
+	{
+		while (ITM->PORT[TRACE_ITM_PORT].u32 == 0UL)
+		{
+			__NOP();						// stimulus FIFO full
+		}
+		ITM->PORT[TRACE_ITM_PORT].u32 = w[i];
+	}
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_drain()
+ *
+ * \brief		Pass the complete records to trace_sink() and free them.
+ *
+ * \return		number of records drained.
+*/
+//-------------------------------------------------------------------------------------------------
+unsigned int trace_drain(void)
+{
+	uint32_t head, seq;
+	trace_rec_t rec;
+	const trace_rec_t *slot;
+	unsigned int n = 0;
+
+	head = __atomic_load_n(&trace_head, __ATOMIC_RELAXED);
+	while (trace_tail != head)
+	{
+		if (head - trace_tail > TRACE_RING_N)
+		{
+			/* the writers lapped the drain, skip to the oldest record still in the ring */
+			trace_lost_n += head - trace_tail - TRACE_RING_N;
+			trace_tail = head - TRACE_RING_N;
+			continue;
+		}
+
+		slot = &trace_ring[trace_tail & TRACE_MASK];
+		seq = slot->seq;
+		__DMB();
+		rec.time = slot->time;
+		rec.info = slot->info;
+		rec.value = slot->value;
+		__DMB();
+		if ((seq != trace_tail) || (slot->seq != trace_tail))
+		{
+			/* overwritten meanwhile, or its writer is not done: next drain */
+			head = __atomic_load_n(&trace_head, __ATOMIC_RELAXED);
+			if (head - trace_tail > TRACE_RING_N)
+			{
+				continue;
+			}
+			break;
+		}
+		rec.seq = seq;
+
+		trace_sink(&rec);
+		trace_tail++;
+		n++;
+	}
+	return n;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_lost()
+ *
+ * \brief		Records overwritten before they were drained.
+ *
+ * \return		number of records lost since trace_init().
+*/
+//-------------------------------------------------------------------------------------------------
+uint32_t trace_lost(void)
+{
+	return trace_lost_n;
+}
@@ -14,6 +14,7 @@
 //*************************************************************************
 //*************************************************************************
 #include "compressor_model.h"
+#include "sensor_prof.h"
 #include <stdio.h>
 #include <math.h>
 
@@ -24,37 +25,44 @@
  * \brief   This array defines the coefficient of compressor model
  */
 //-------------------------------------------------------------------------------------------------
-static const float COE_32[] = {	55.8500,	-127.29,	700.040,	1.23470,	0.06207,
-								0.23527,	1.7695,		0.0,		0.0,		1.14730,
-								0.0,		0.0,		0.88358,	-0.41507,	0.14333,
-								0.15895,	-0.058611,	0.022684,	19.922,		4.6538,
-								-195.28,	712.67,		-43.42,		0.0,		0.0,
-								0.0,		0.0,		0.0,		0.0,		0.0,
-								0.0,		0.0};
+const float COE_32[COMP_COE_N] = {	97.067,		-177.99,		297.6,		20.081,		11.098,		-1.8449,		0.44883,	0,
+								0,			0.65281,		0,			0,			0.096619,	-0.029134,		0.011636,	-0.11126,
+								0.073423,	-0.024061,		2.4395,		0.029512,	-119.08,	-85.79,			12.689,		-0.00026992,
+								0.00047164,	-0.00019762,	0.3311,		-0.53155,	0.18157,	0.0000024884,	390.25,		-150.24
+							};
+
+//static const float COE_32[] = {	175.06,		-349.46,		368.02,		13.266,		1.4529,		1.0488,		0.60195,	0,
+//								0,			0.63406,		0,			0,			0.1216,		0.097799,	-0.056657,	0.24989,
+//								0.12698,	-0.082634,		4.937,		9.961,		188.97,		-561.48, 	290.08,		-0.00044022,
+//								0.00086054,	-0.00038342,	0.41032,	-0.87047,	0.31978,	0.00019287,	579.79,		-232.29
+//								};
+
+
 
 
 //-------------------------------------------------------------------------------------------------
 /**
  * \def
- * \brief		Define the calculation of intermediate coefficients by initial coefficients.
+ * \brief		Define the calculation of intermediate coefficients by initial coefficients k[],
+ *				COMP_COE_N values laid out like COE_32[].
 */
 //-------------------------------------------------------------------------------------------------
 #define PR(pd, ps) ((pd)/(ps))	//pd:discharge pressure, ps:suction pressure
 #define SR(compSpeed) ((compSpeed)/(COMPSPEED_RATED))
 
-#define COE_A(compSpeed) (COE_32[0]+COE_32[1]*sqrt(SR(compSpeed))+COE_32[2]*SR(compSpeed))
-#define COE_B(compSpeed) (COE_32[3]+COE_32[4]*pow(SR(compSpeed), 2)+COE_32[5]*pow(SR(compSpeed), 4))
-#define COE_C(compSpeed) (COE_32[6]+COE_32[7]*SR(compSpeed)+COE_32[8]*pow(SR(compSpeed), 2))
-#define COE_D(compSpeed) (COE_32[9]+COE_32[10]*sqrt(SR(compSpeed))+COE_32[11]*SR(compSpeed))
-#define COE_Y1(compSpeed) (COE_32[12]+COE_32[13]*SR(compSpeed)+COE_32[14]*pow(SR(compSpeed), 2))
-#define COE_Y2(compSpeed) (COE_32[15]+COE_32[16]*SR(compSpeed)+COE_32[17]*pow(SR(compSpeed), 2))
-#define COE_F(compSpeed) (COE_Y1(compSpeed)-COE_Y2(compSpeed))/(pow(COE_32[18], COE_D(compSpeed))-\
-							pow(COE_32[19], COE_D(compSpeed)))
-#define COE_E(compSpeed) COE_Y1(compSpeed)-COE_F(compSpeed)*pow(COE_32[18], COE_D(compSpeed))
-#define COE_G(compSpeed) (COE_32[20]+COE_32[21]*pow(SR(compSpeed), 2)+COE_32[22]*pow(SR(compSpeed), 4))
-#define COE_Q(compSpeed) (COE_32[23]+COE_32[24]*SR(compSpeed)+COE_32[25]*pow(SR(compSpeed), 2))
-#define COE_R(compSpeed) (COE_32[26]+COE_32[27]*pow(SR(compSpeed), 2)+COE_32[28]*pow(SR(compSpeed), 4))
-#define COE_S(compSpeed) (COE_32[29]+COE_32[30]*pow(SR(compSpeed), 2)+COE_32[31]*pow(SR(compSpeed), 4))
+#define COE_A(k, compSpeed) ((k)[0]+(k)[1]*sqrt(SR(compSpeed))+(k)[2]*SR(compSpeed))
+#define COE_B(k, compSpeed) ((k)[3]+(k)[4]*pow(SR(compSpeed), 2)+(k)[5]*pow(SR(compSpeed), 4))
+#define COE_C(k, compSpeed) ((k)[6]+(k)[7]*SR(compSpeed)+(k)[8]*pow(SR(compSpeed), 2))
+#define COE_D(k, compSpeed) ((k)[9]+(k)[10]*sqrt(SR(compSpeed))+(k)[11]*SR(compSpeed))
+#define COE_Y1(k, compSpeed) ((k)[12]+(k)[13]*SR(compSpeed)+(k)[14]*pow(SR(compSpeed), 2))
+#define COE_Y2(k, compSpeed) ((k)[15]+(k)[16]*SR(compSpeed)+(k)[17]*pow(SR(compSpeed), 2))
+#define COE_F(k, compSpeed) (COE_Y1(k, compSpeed)-COE_Y2(k, compSpeed))/(pow((k)[18], COE_D(k, compSpeed))-\
+							pow((k)[19], COE_D(k, compSpeed)))
+#define COE_E(k, compSpeed) COE_Y1(k, compSpeed)-COE_F(k, compSpeed)*pow((k)[18], COE_D(k, compSpeed))
+#define COE_G(k, compSpeed) ((k)[20]+(k)[21]*pow(SR(compSpeed), 2)+(k)[22]*pow(SR(compSpeed), 4))
+#define COE_Q(k, compSpeed) ((k)[23]+(k)[24]*SR(compSpeed)+(k)[25]*pow(SR(compSpeed), 2))
+#define COE_R(k, compSpeed) ((k)[26]+(k)[27]*pow(SR(compSpeed), 2)+(k)[28]*pow(SR(compSpeed), 4))
+#define COE_S(k, compSpeed) ((k)[29]+(k)[30]*pow(SR(compSpeed), 2)+(k)[31]*pow(SR(compSpeed), 4))
 
 
 
@@ -75,19 +83,12 @@ static const float COE_32[] = {	55.8500,	-127.29,	700.040,	1.23470,	0.06207,
 //-------------------------------------------------------------------------------------------------
 float cal_volume_flow_rate(float pd, float ps, float compSpeed)
 {
-	float a, b, c, pr;
-	float volume_flow_rate;
+	comp_coe_t coe;
 
 	/* Calculated intermediate coefficients */
-	a = COE_A(compSpeed);
-	b = COE_B(compSpeed);
-	c = COE_C(compSpeed);
-	pr = PR(pd, ps);
-
-	/* Calculated volume flow rate */
-	volume_flow_rate = (a-b*pow(pr, c))*4.719476965*pow(10, (-4))/60;
+	cal_comp_coe(compSpeed, &coe);
 
-	return volume_flow_rate;
+	return cal_volume_flow_rate_coe(&coe, pd, ps);
 }
 
 
@@ -109,20 +110,120 @@ float cal_volume_flow_rate(float pd, float ps, float compSpeed)
 //-------------------------------------------------------------------------------------------------
 float cal_power(float pd, float ps, float compSpeed)
 {
-	float d, e, f, g, pr;
-	float volume_flow_rate, power;
+	comp_coe_t coe;
 
 	/* Calculated intermediate coefficients */
-	d = COE_D(compSpeed);
-	e = COE_E(compSpeed);
-	f = COE_F(compSpeed);
-	g = COE_G(compSpeed);
+	cal_comp_coe(compSpeed, &coe);
+
+	return cal_power_coe(&coe, pd, ps, cal_volume_flow_rate_coe(&coe, pd, ps));
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_comp_coe()
+ *
+ * \brief		Calculated intermediate coefficients of the compressor model.
+ *
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[out]	coe = intermediate coefficients.
+*/
+//-------------------------------------------------------------------------------------------------
+void cal_comp_coe(float compSpeed, comp_coe_t *coe)
+{
+	cal_comp_coe_k(COE_32, compSpeed, coe);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_comp_coe_k()
+ *
+ * \brief		Calculated intermediate coefficients of the compressor model from a set of
+ *				initial coefficients.
+ *
+ * \param[in]	k = COMP_COE_N initial coefficients laid out like COE_32[].
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[out]	coe = intermediate coefficients.
+*/
+//-------------------------------------------------------------------------------------------------
+void cal_comp_coe_k(const float *k, float compSpeed, comp_coe_t *coe)
+{
+	SENSOR_PROF_BEGIN();
+
+	coe->a = COE_A(k, compSpeed);
+	coe->b = COE_B(k, compSpeed);
+	coe->c = COE_C(k, compSpeed);
+	coe->d = COE_D(k, compSpeed);
+	coe->e = COE_E(k, compSpeed);
+	coe->f = COE_F(k, compSpeed);
+	coe->g = COE_G(k, compSpeed);
+	SENSOR_PROF_END(SENSOR_PROF_COMP_COE);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_volume_flow_rate_coe()
+ *
+ * \brief		Calculated volume flow rate from precomputed coefficients.
+ * 				volume_flow_rate = (a-b*pr^c)*4.719476965*10^(-4)/60
+ *
+ * \param[in]	coe = intermediate coefficients from cal_comp_coe().
+ * \param[in]	pd = discharge pressure in kPa.
+ * \param[in]	ps = suction pressure in kPa.
+ *
+ * \return		volume flow rate in m^3/s.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_volume_flow_rate_coe(const comp_coe_t *coe, float pd, float ps)
+{
+	float pr;
+	float volume_flow_rate;
+
 	pr = PR(pd, ps);
 
 	/* Calculated volume flow rate */
-	volume_flow_rate = cal_volume_flow_rate(pd, ps, compSpeed);
+	volume_flow_rate = (coe->a-coe->b*pow(pr, coe->c))*4.719476965*pow(10, (-4))/60;
+	volume_flow_rate = (volume_flow_rate < 0) ? 0.00000001 : volume_flow_rate;
+
+	return volume_flow_rate;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_power_coe()
+ *
+ * \brief		Calculated power from precomputed coefficients and volume flow rate.
+ * 				power = ((e+f*pr^d)*ps*0.000145*1000*volume_flow_rate/(4.719476965*10^(-4)/60))+g
+ *
+ * \param[in]	coe = intermediate coefficients from cal_comp_coe().
+ * \param[in]	pd = discharge pressure in kPa.
+ * \param[in]	ps = suction pressure in kPa.
+ * \param[in]	volume_flow_rate = result of cal_volume_flow_rate_coe() at the same pd, ps.
+ *
+ * \return		power in W.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_power_coe(const comp_coe_t *coe, float pd, float ps, float volume_flow_rate)
+{
+	float pr;
+	float power;
+
+	pr = PR(pd, ps);
+
 	/* Calculated power */
-	power = ((e+f*pow(pr, d))*ps*0.000145*1000*volume_flow_rate/(4.719476965*pow(10, (-4))/60))+g;
+	power = ((coe->e+coe->f*pow(pr, coe->d))*ps*0.000145*1000*volume_flow_rate/(4.719476965*pow(10, (-4))/60))+coe->g;
+	power = (power < 0) ? 0 : power;
 
 	return power;
 }
@@ -140,36 +241,63 @@ float cal_power(float pd, float ps, float compSpeed)
  * \param[in]	pd = discharge pressure in kPa.
  * \param[in]	ps = suction pressure in kPa.
  * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	U = the voltage of compressor.
  *
  * \return		current in A.
 */
 //-------------------------------------------------------------------------------------------------
-float cal_current(float pd, float ps, float compSpeed)
+float cal_current(float pd, float ps, float compSpeed, float U)
 {
-	float q, s;
-	float power, current;
+	comp_coe_t coe;
 
 	/* Calculated intermediate coefficients */
-	q = COE_Q(compSpeed);
-	s = COE_S(compSpeed);
+	cal_comp_coe(compSpeed, &coe);
+
+	return cal_current_coe(&coe, pd, ps, U);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_current_coe()
+ *
+ * \brief		Calculated current from precomputed coefficients.
+ *
+ * \param[in]	coe = intermediate coefficients from cal_comp_coe().
+ * \param[in]	pd = discharge pressure in kPa.
+ * \param[in]	ps = suction pressure in kPa.
+ * \param[in]	U = the voltage of compressor.
+ *
+ * \return		current in A.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_current_coe(const comp_coe_t *coe, float pd, float ps, float U)
+{
+	float power, current;
+
 	/* Calculated power */
-	power = cal_power(pd, ps, compSpeed);
+	power = cal_power_coe(coe, pd, ps, cal_volume_flow_rate_coe(coe, pd, ps));
 
 	/* Calculated current */
-	if (q > 0)
-		current = power/((q*power+s)*power+s);
-	else
-		current = 0;
+	if (U <= 0)
+	{
+		return 0;
+	}
+	current = power/U;
+	current = (current < 0) ? 0 : current;
 
 	return current;
 }
 
 
 
+
 void compressor_model_test(void)
 {
-	double	Pd = 2130.95102394783, Ps = 641,
-			CompSpeed = 7080;
+	double	Pd = 1883.58288520969, Ps = 480,
+			CompSpeed = 3600;
 
 	float sr, pr, COE_A, COE_B, COE_C, COE_D, COE_Y1, COE_Y2, COE_F, COE_E,
 			COE_G, COE_Q, COE_R, COE_S;
@@ -179,18 +307,18 @@ void compressor_model_test(void)
 	/* Calculated Pr */
 	pr = PR(Pd, Ps);
 	sr = SR(CompSpeed);
-	COE_A = COE_A(CompSpeed);
-	COE_B = COE_B(CompSpeed);
-	COE_C = COE_C(CompSpeed);
-	COE_D = COE_D(CompSpeed);
-	COE_Y1 = COE_Y1(CompSpeed);
-	COE_Y2 = COE_Y2(CompSpeed);
-	COE_F = COE_F(CompSpeed);
-	COE_E = COE_E(CompSpeed);
-	COE_G = COE_G(CompSpeed);
-	COE_Q = COE_Q(CompSpeed);
-	COE_R = COE_R(CompSpeed);
-	COE_S = COE_S(CompSpeed);
+	COE_A = COE_A(COE_32, CompSpeed);
+	COE_B = COE_B(COE_32, CompSpeed);
+	COE_C = COE_C(COE_32, CompSpeed);
+	COE_D = COE_D(COE_32, CompSpeed);
+	COE_Y1 = COE_Y1(COE_32, CompSpeed);
+	COE_Y2 = COE_Y2(COE_32, CompSpeed);
+	COE_F = COE_F(COE_32, CompSpeed);
+	COE_E = COE_E(COE_32, CompSpeed);
+	COE_G = COE_G(COE_32, CompSpeed);
+	COE_Q = COE_Q(COE_32, CompSpeed);
+	COE_R = COE_R(COE_32, CompSpeed);
+	COE_S = COE_S(COE_32, CompSpeed);
 	printf("pr = %f: \r\n", pr);
 	printf("sr = %f: \r\n", sr);
 	printf("COE_A = %f: \r\n", COE_A);
@@ -212,7 +340,7 @@ void compressor_model_test(void)
 
 	volume_flow_rate = cal_volume_flow_rate(Pd, Ps, CompSpeed);
 	power = cal_power(Pd, Ps, CompSpeed);
-	current =  cal_current(Pd, Ps, CompSpeed);
+	current =  cal_current(Pd, Ps, CompSpeed, 220);
 	printf("volume flow rate = %f: \r\n", volume_flow_rate);
 	printf("power = %f: \r\n", power);
 	printf("current = %f: \r\n", current);
@@ -24,14 +24,21 @@
  */
 //-------------------------------------------------------------------------------------------------
 #define COMPSPEED_RATED (3600)
+#define COMP_COE_N		(32)		// number of initial coefficients of the compressor model
 
 
 //-------------------------------------------------------------------------------------------------
 /**
- * \struct
- * \brief
+ * \struct		comp_coe_t
+ * \brief		Intermediate coefficients of the compressor model. They depend on compressor
+ *				speed only, so one set is valid for every discharge pressure tried by a solver.
  */
 //-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	float a, b, c;		// volume flow rate: a-b*pr^c
+	float d, e, f, g;	// power: e+f*pr^d, g
+} comp_coe_t;
 
 
 //-------------------------------------------------------------------------------------------------
@@ -42,6 +49,15 @@
 //------------------------------------------------------------------------------------------------
 
 
+//-------------------------------------------------------------------------------------------------
+/**
+ * \var     COE_32[]
+ * \brief   Initial coefficients of the compressor model used by default.
+ */
+//-------------------------------------------------------------------------------------------------
+extern const float COE_32[COMP_COE_N];
+
+
 
 //-------------------------------------------------------------------------------------------------
 /**
@@ -87,11 +103,90 @@ float cal_power(float pd, float ps, float compSpeed);
  * \param[in]	pd = discharge pressure in kPa.
  * \param[in]	ps = suction pressure in kPa.
  * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	U = the voltage of compressor.
+ *
+ * \return		current in A.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_current(float pd, float ps, float compSpeed, float U);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_comp_coe()
+ *
+ * \brief		Calculated intermediate coefficients of the compressor model.
+ *
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[out]	coe = intermediate coefficients.
+*/
+//-------------------------------------------------------------------------------------------------
+void cal_comp_coe(float compSpeed, comp_coe_t *coe);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_comp_coe_k()
+ *
+ * \brief		Calculated intermediate coefficients of the compressor model from a set of
+ *				initial coefficients.
+ *
+ * \param[in]	k = COMP_COE_N initial coefficients laid out like COE_32[].
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[out]	coe = intermediate coefficients.
+*/
+//-------------------------------------------------------------------------------------------------
+void cal_comp_coe_k(const float *k, float compSpeed, comp_coe_t *coe);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_volume_flow_rate_coe()
+ *
+ * \brief		Calculated volume flow rate from precomputed coefficients.
+ *
+ * \param[in]	coe = intermediate coefficients from cal_comp_coe().
+ * \param[in]	pd = discharge pressure in kPa.
+ * \param[in]	ps = suction pressure in kPa.
+ *
+ * \return		volume flow rate in m^3/s.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_volume_flow_rate_coe(const comp_coe_t *coe, float pd, float ps);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_power_coe()
+ *
+ * \brief		Calculated power from precomputed coefficients and volume flow rate.
+ *
+ * \param[in]	coe = intermediate coefficients from cal_comp_coe().
+ * \param[in]	pd = discharge pressure in kPa.
+ * \param[in]	ps = suction pressure in kPa.
+ * \param[in]	volume_flow_rate = result of cal_volume_flow_rate_coe() at the same pd, ps.
+ *
+ * \return		power in W.
+*/
+//-------------------------------------------------------------------------------------------------
+float cal_power_coe(const comp_coe_t *coe, float pd, float ps, float volume_flow_rate);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_current_coe()
+ *
+ * \brief		Calculated current from precomputed coefficients.
+ *
+ * \param[in]	coe = intermediate coefficients from cal_comp_coe().
+ * \param[in]	pd = discharge pressure in kPa.
+ * \param[in]	ps = suction pressure in kPa.
+ * \param[in]	U = the voltage of compressor.
  *
  * \return		current in A.
 */
 //-------------------------------------------------------------------------------------------------
-float cal_current(float pd, float ps, float compSpeed);
+float cal_current_coe(const comp_coe_t *coe, float pd, float ps, float U);
 
 
 void compressor_model_test(void);
@@ -127,6 +127,67 @@ float cal_vol_sat_gas(float p);
 float cal_dens_sh_gas(float p, float t);
 
 
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_h_sat_gas_ts()
+ *
+ * \brief		Calculated Saturated gas Enthalpy from a known saturation temperature.
+ *				h_sat_gas = 280998.3+332.614*t_sat-4.699265*t_sat^2-51.2569*10^(-3)*t_sat^3
+ *
+ * \param[in]	ts = saturation temperature in ℃, as returned by cal_t_sat().
+ *
+ * \return		Calculated Enthalpy of saturated gas in kJ/kg.
+ */
+//-------------------------------------------------------------------------------------------------
+float cal_h_sat_gas_ts(float ts);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_h_sh_gas_ts()
+ *
+ * \brief		Calculated Enthalpy of superheated gas from a known saturation state,
+ *				so callers that already hold t_sat and h_sat_gas do not derive them again.
+ *
+ * \param[in]	ts = saturation temperature in ℃, as returned by cal_t_sat().
+ * \param[in]	hs = enthalpy of saturated gas in kJ/kg, as returned by cal_h_sat_gas().
+ * \param[in]	t = Gas temperature in ℃.
+ *
+ * \return		Calculated Enthalpy of superheated gas in kJ/kg.
+ */
+//-------------------------------------------------------------------------------------------------
+float cal_h_sh_gas_ts(float ts, float hs, float t);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_vol_sat_gas_ts()
+ *
+ * \brief		Calculated Saturated gas specific volume from a known saturation temperature.
+ *
+ * \param[in]	ts = saturation temperature in ℃, as returned by cal_t_sat().
+ *
+ * \return		Saturated gas specific volume in m^3/s.
+ */
+//-------------------------------------------------------------------------------------------------
+float cal_vol_sat_gas_ts(float ts);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_dens_sh_gas_ts()
+ *
+ * \brief		Calculated density of superheated gas from a known saturation temperature.
+ *
+ * \param[in]	ts = saturation temperature in ℃, as returned by cal_t_sat().
+ * \param[in]	t = Gas temperature in ℃.
+ *
+ * \return		Density of superheated gas in kg/m^3.
+ */
+//-------------------------------------------------------------------------------------------------
+float cal_dens_sh_gas_ts(float ts, float t);
+
+
 void refrig_prop_test(void);
 
 #endif                                      // re-include guard
@@ -16,107 +16,171 @@
 #include "sensor_predict.h"
 #include "refrigerant_property.h"
 #include "compressor_model.h"
+#include "sensor_prof.h"
 #include <stdio.h>
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
 
 
 //-------------------------------------------------------------------------------------------------
 /**
- * \fn			pred_Tdis()
+ * \struct		suction_state_t
+ * \brief		Properties of the suction gas. They do not depend on the discharge side, so one
+ *				set serves pred_Tdis() and every iteration of pred_Pdis_temp().
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	float p_suc;		// suction gas pressure in kPa_a(absolute pressure)
+	float ts_suc;		// temperature of saturation suction gas
+	float ssh;			// superheated of suction gas
+	float vol_sat_gas;	// Saturated gas specific volume, only set when ssh <= 1
+	float dens_gas;		// density of scution gas.
+	float h_suc;		// enthalpy of suction gas
+} suction_state_t;
+
+
+static solver_stats_t *pred_stats;	// counters of the pred_Pdis_xxx() functions, see pred_set_stats()
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_suction_state()
  *
- * \brief		Predict temperature of discharge gas.
+ * \brief		Calculated properties of the suction gas.
  *
- * \param[in]	p_suc = suction gas pressure in kPa.
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
  * \param[in]	t_suc = suction gas temperature in ℃.
- * \param[in]	p_dis = discharge gas pressure in kPa.
- * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[out]	suc = properties of the suction gas.
  *
- * \return		discharge gas temperature in ℃.
+ * \return		0 if the saturated gas specific volume is zero, otherwise 1.
+*/
+//-------------------------------------------------------------------------------------------------
+static int cal_suction_state(float p_suc_g, float t_suc, suction_state_t *suc)
+{
+	float hs_suc;	//hs_suc:enthalpy of saturation suction gas
+	SENSOR_PROF_BEGIN();
+
+	// gage pressure converte to absolute pressure
+	suc->p_suc = p_suc_g + 101.35;
+
+	/* Calculated saturation temperature. */
+	suc->ts_suc = cal_t_sat(suc->p_suc);
+
+	/* Calculated superheated of suction gas */
+	suc->ssh = t_suc - suc->ts_suc;
+
+	/* Calculated density and enthalpy of suction gas. */
+	hs_suc = cal_h_sat_gas_ts(suc->ts_suc);
+	if (suc->ssh > 1)
+	{
+		suc->vol_sat_gas = 0;
+		suc->dens_gas = cal_dens_sh_gas_ts(suc->ts_suc, t_suc);
+		suc->h_suc = cal_h_sh_gas_ts(suc->ts_suc, hs_suc, t_suc);
+		SENSOR_PROF_END(SENSOR_PROF_SUCTION);
+		return 1;
+	}
+
+	suc->vol_sat_gas = cal_vol_sat_gas_ts(suc->ts_suc);
+	suc->dens_gas = 1/suc->vol_sat_gas;
+	suc->h_suc = hs_suc;
+
+	SENSOR_PROF_END(SENSOR_PROF_SUCTION);
+	return (suc->vol_sat_gas != 0);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def		H_SH_xxx
+ * \brief		Coefficients of the superheated gas enthalpy, see cal_h_sh_gas(), regrouped by
+ *				powers of the superheat dt = t - t_sat:
+ *				h_sh_gas/h_sat_gas = 1 + k1*dt + k2*dt^2
+ *				k1 = H_SH_K1_0 + H_SH_K1_1*t_sat + H_SH_K1_2*t_sat^2
+ *				k2 = H_SH_K2_0 + H_SH_K2_1*t_sat + H_SH_K2_2*t_sat^2
+ */
+//-------------------------------------------------------------------------------------------------
+#define H_SH_K1_0	(3.3247e-3f)
+#define H_SH_K1_1	(30.40633e-6f)
+#define H_SH_K1_2	(76.64206e-8f)
+#define H_SH_K2_0	(3.62592e-7f)
+#define H_SH_K2_1	(-18.47693e-8f)
+#define H_SH_K2_2	(-60.2765e-10f)
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_tdis()
+ *
+ * \brief		Calculated temperature of discharge gas from a known suction state.
+ *				The enthalpy model of the superheated gas is a quadratic in the superheat dt,
+ *				k2*dt^2 + k1*dt - (h_dis/hs_dis - 1) = 0, solved with the form
+ *				dt = 2*(h_dis/hs_dis - 1)/(k1 + sqrt(k1^2 + 4*k2*(h_dis/hs_dis - 1)))
+ *				which is the same root as (-b+sqrt(b^2-4ac))/(2a) without its cancellation.
+ *				k1 > 0 over the whole range of the saturation temperature.
+ *
+ * \param[in]	suc = properties of the suction gas.
+ * \param[in]	coe = intermediate coefficients of the compressor model.
+ * \param[in]	fw = share of the power in the discharge gas enthalpy, FW by default.
+ * \param[in]	p_dis = discharge gas pressure in kPa_a(absolute pressure).
+ * \param[out]	t_dis = discharge gas temperature in ℃, TDIS_NO_ROOT_VALUE if there is no root.
+ *
+ * \return		TDIS_OK or TDIS_NO_ROOT.
 */
 //-------------------------------------------------------------------------------------------------
-float pred_Tdis(float p_suc, float t_suc, float p_dis, float compSpeed)
+static tdis_status_t cal_tdis(const suction_state_t *suc, const comp_coe_t *coe, double fw, float p_dis,
+							  float *t_dis)
 {
 	float volume_flow_rate, power;
-	float z_fw, coe_a, coe_b, coe_c;
-	float ts_suc;	//ts:temperature of saturation suction gas
+	float z_fw, k1, k2, k, disc;
 	float ts_dis;	//ts_dis:temperaturs of saturation discharge gas
-	float dens_gas;	//dens_gas:density of scution gas.
 	float mr;	//mr:density and flow rate.
-	float h_suc;	//h_suc:enthalpy of suction gas
 	float h_dis;	//h_dis:enthalpy of discharge gas
 	float hs_dis;	//hs_dis:enthalpy of saturation discharge gas
-	float ssh;	//ssh:superheated of suction gas
-	float t_dis;	//t_dis:temperaturs of discharge gas
 
 	/* Calculated volume flow rate. */
-	volume_flow_rate = cal_volume_flow_rate(p_dis, p_suc, compSpeed);
+	volume_flow_rate = cal_volume_flow_rate_coe(coe, p_dis, suc->p_suc);
 
 	/* Calculated power */
-	power = cal_power(p_dis, p_suc, compSpeed);
-
-	/* Calculated saturation temperature. */
-	ts_suc = cal_t_sat(p_suc);
-
-	/* Calculated superheated of suction gas */
-	ssh = t_suc - ts_suc;
-
-	/* Calculated density of suction gas. */
-	if (ssh > 1)
-		dens_gas = cal_dens_sh_gas(p_suc, t_suc);
-	else
-		dens_gas = 1/cal_vol_sat_gas(p_suc);
+	power = cal_power_coe(coe, p_dis, suc->p_suc, volume_flow_rate);
 
 	/* Calculated compressor density and flow rate. */
-	mr = volume_flow_rate*dens_gas;
-
-	/* Calculated enthalpy of suction gas */
-	if (ssh > 1)
-		h_suc = cal_h_sh_gas(p_suc, t_suc);
-	else
-		h_suc = cal_h_sat_gas(p_suc);
+	mr = volume_flow_rate*suc->dens_gas;
 
 	/* Calculated enthalpy of discharge gas */
-	if (ssh < 2)
-		z_fw = 0.2 * ssh + 0.6;
+	if (suc->ssh < 2)
+		z_fw = 0.2 * suc->ssh + 0.6;
 	else
 		z_fw = 1;
-	h_dis = (power * FW * z_fw) / mr + h_suc;
+	h_dis = (power * fw * z_fw) / mr + suc->h_suc;
 
-	/* calculate coefficient of coe_a,coe_b,coe_c. */
-	/* temperaturs of discharge saturation gas */
+	/* temperaturs and enthalpy of discharge saturation gas */
 	ts_dis = cal_t_sat(p_dis);
-	/*
-		3.62592×10^(-7)-18.47693×10^(-8)×ts_dis-60.2765×10^(-10)×ts_dis^2
-	*/
-	coe_a = 3.62592*pow(10,(-7))-18.47693*pow(10,(-8))*
-			ts_dis-60.2765*pow(10,(-10))*pow(ts_dis,2);
-	/*
-		3.3247×10^(-3)-2×3.62592×10^(-7)×ts_dis+30.40633×10^(-6)×ts_dis
-		+2×18.47693×10^(-8)×ts_dis^2+76.64206×10^(-8)×ts_dis^2
-		+2×60.2765×10^(-10)×ts_dis^3
-	*/
-	coe_b = 3.3247*pow(10,(-3))-2*3.62592*pow(10,(-7))*ts_dis+30.40633*pow(10,(-6))*
-			ts_dis+2*18.47693*pow(10,(-8))*pow(ts_dis,2)+76.64206*pow(10,(-8))*
-			pow(ts_dis,2)+2*60.2765*pow(10,(-10))*pow(ts_dis,3);
-	/*
-		1-3.3247×10^(-3)×ts_dis+3.62592×10^(-7)×ts_dis^2-30.40633×10^(-6)
-		×ts_dis^2-18.47693×10^(-8)×ts_dis^3-76.64206×10^(-8)×ts_dis^3-60.2765
-		×10^(-10)×ts_dis^4-h_dis/hs_dis
-	*/
-	hs_dis = cal_h_sat_gas(p_dis);
-	coe_c = 1-3.3247*pow(10,(-3))*ts_dis+3.62592*pow(10,(-7))*pow(ts_dis,2)-30.40633*
-			pow(10,(-6))*pow(ts_dis,2)-18.47693*pow(10,(-8))*pow(ts_dis,3)-76.64206*
-			pow(10,(-8))*pow(ts_dis,3)-60.2765*pow(10,(-10))*pow(ts_dis,4)-h_dis/hs_dis;
-
-	/* calculate temperature of discharge gas.(-b+SQRT(b^2-4*a*c))/(2*a) */
-	float sqrt_num;
-	sqrt_num = pow(coe_b,2)-4*coe_a*coe_c;
-	if (sqrt_num >= 0)
-		t_dis = (-coe_b+sqrt(sqrt_num))/(2*coe_a);
-	else
-		t_dis = 150;
+	hs_dis = cal_h_sat_gas_ts(ts_dis);
 
-	return t_dis;
+	/* quadratic in dt = t_dis - ts_dis */
+	k1 = H_SH_K1_0 + ts_dis*(H_SH_K1_1 + ts_dis*H_SH_K1_2);
+	k2 = H_SH_K2_0 + ts_dis*(H_SH_K2_1 + ts_dis*H_SH_K2_2);
+	k = h_dis/hs_dis - 1;
+
+	disc = k1*k1 + 4*k2*k;
+	if (!(disc >= 0))
+	{
+		*t_dis = TDIS_NO_ROOT_VALUE;
+		return TDIS_NO_ROOT;
+	}
+
+	*t_dis = ts_dis + 2*k/(k1 + sqrtf(disc));
+
+	return TDIS_OK;
 }
 
 
@@ -124,69 +188,148 @@ float pred_Tdis(float p_suc, float t_suc, float p_dis, float compSpeed)
 
 //-------------------------------------------------------------------------------------------------
 /**
- * \fn			pred_Pdis()
+ * \fn			cal_delay_gain()
  *
- * \brief		Predict pressure of discharge gas.
+ * \brief		Gain of one step of the first order delay, y = pre + (x - pre)*gain.
  *
- * \param[in]	p_suc = suction gas pressure in kPa.
- * \param[in]	t_suc = suction gas temperature in ℃.
+ * \param[in]	tau = time constant in s.
+ * \param[in]	T_interval = t[i]-t[i-1] in s.
+ *
+ * \return		1-e^(-T_interval/tau).
+*/
+//-------------------------------------------------------------------------------------------------
+static double cal_delay_gain(int tau, float T_interval)
+{
+	return 1-pow(2.718281828459, -(T_interval/tau));
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_delay()
+ *
+ * \brief		One step of the first order delay.
+ *
+ * \param[in]	pre = previous output of the delay.
+ * \param[in]	x = input of the delay.
+ * \param[in]	tau = time constant in s.
+ * \param[in]	T_interval = t[i]-t[i-1] in s.
+ *
+ * \return		output of the delay.
+*/
+//-------------------------------------------------------------------------------------------------
+static float cal_delay(float pre, float x, int tau, float T_interval)
+{
+	return pre+1*(x-pre)*cal_delay_gain(tau, T_interval);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_iter_budget()
+ *
+ * \brief		Iteration limit of a solver for a caller budget.
+ *
+ * \param[in]	budget = iterations the caller can afford, 0 for no limit.
+ * \param[in]	iter_max = iteration limit of the solver.
+ *
+ * \return		the smaller of both.
+*/
+//-------------------------------------------------------------------------------------------------
+static unsigned int cal_iter_budget(unsigned int budget, unsigned int iter_max)
+{
+	return ((budget != 0) && (budget < iter_max)) ? budget : iter_max;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_solver_stats()
+ *
+ * \brief		Add one solver run to its convergence counters.
+ *
+ * \param[in]	st = counters of the solver.
+ * \param[in]	res = result of the run.
+*/
+//-------------------------------------------------------------------------------------------------
+static void cal_solver_stats(solver_stats_t *st, const pdis_result_t *res)
+{
+	st->runs++;
+	st->not_converged += !res->converged;
+	st->iterations += res->iterations;
+	st->hist[(res->iterations < SOLVER_HIST_N) ? res->iterations : (SOLVER_HIST_N - 1)]++;
+	if (res->residual > st->residual_max)
+		st->residual_max = res->residual;
+	if (res->err_bound > st->err_bound_max)
+		st->err_bound_max = res->err_bound;
+	st->residual_sum += res->residual;
+	st->err_bound_sum += res->err_bound;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_pdis_temp()
+ *
+ * \brief		Calculated pressure of discharge gas by temperature from a known suction state.
+ *				Bisection, stopped after max_iter iterations at the latest.
+ *
+ * \param[in]	suc = properties of the suction gas.
+ * \param[in]	coe = intermediate coefficients of the compressor model.
+ * \param[in]	fw = share of the power in the discharge gas enthalpy, FW by default.
  * \param[in]	t_dis = discharge gas temperature in ℃.
- * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	max_iter = iteration budget, must be > 0.
+ * \param[out]	res = discharge gas pressure in kPa(gage pressure), bound and iterations.
  *
- * \return		discharge gas pressure in kPa.
+ * \return		1 if the enthalpy tolerance was met, otherwise 0.
 */
 //-------------------------------------------------------------------------------------------------
-float pred_Pdis(float p_suc, float t_suc, float t_dis, float compSpeed)
+static int cal_pdis_temp(const suction_state_t *suc, const comp_coe_t *coe, double fw, float t_dis,
+						 unsigned int max_iter, pdis_result_t *res)
 {
 	float pd_int1 = 100, pd_int2=4300, pd_int, hd_int;
 	float v_flow, power;
-	float dens_gas;	//dens_gas:density of scution gas.
-	float ts_suc;	//ts:temperature of saturation suction gas
-	float ssh;	//ssh:superheated of suction gas
-	float mr;	//mr:density and flow rate.
-	float h_suc;	//h_suc:enthalpy of suction gas
-	float h_dis;	//h_dis:enthalpy of discharge gas
+	float mr;			//mr:density and flow rate.
+	float h_dis;		//h_dis:enthalpy of discharge gas
+	unsigned int i;
+	SENSOR_PROF_BEGIN();
 
-	for (size_t i = 0; i < 100; i++)
+	res->converged = 0;
+	for (i = 0; i < max_iter; i++)
 	{
 		pd_int = (pd_int1+pd_int2)/2;
+		res->err_bound = (pd_int2-pd_int1)/2;
 
 		/* Calculated volume flow rate. */
-		v_flow = cal_volume_flow_rate(pd_int, p_suc, compSpeed);
+		v_flow = cal_volume_flow_rate_coe(coe, pd_int, suc->p_suc);
 
 		/* Calculated power */
-		power = cal_power(pd_int, p_suc, compSpeed);
-
-		/* Calculated saturation temperature. */
-		ts_suc = cal_t_sat(p_suc);
-
-		/* Calculated superheated of suction gas */
-		ssh = t_suc - ts_suc;
-
-		/* Calculated density of suction gas. */
-		if (ssh > 1)
-			dens_gas = cal_dens_sh_gas(p_suc, t_suc);
-		else
-			dens_gas = 1/cal_vol_sat_gas(p_suc);
+		power = cal_power_coe(coe, pd_int, suc->p_suc, v_flow);
 
 		/* Calculated compressor density and flow rate. */
-		mr = v_flow*dens_gas;
-
-		/* Calculated enthalpy of suction gas */
-		if (ssh > 1)
-			h_suc = cal_h_sh_gas(p_suc, t_suc);
-		else
-			h_suc = cal_h_sat_gas(p_suc);
+		mr = v_flow*suc->dens_gas;
 
 		/* Calculated enthalpy of discharge gas */
-		h_dis = (power * FW) / mr + h_suc;
+		h_dis = (power * fw) / mr + suc->h_suc;
 
 		/* Calculated enthalpy of int discharge gas */
 		hd_int = cal_h_sh_gas(pd_int, t_dis);
 
 		/* reset pd_int1 or pd_int2 */
 		if (fabs(hd_int - h_dis) < 0.1)
+		{
+			res->converged = 1;
+			i++;
 			break;
+		}
 		else
 		{
 			if (hd_int < h_dis)
@@ -196,26 +339,782 @@ float pred_Pdis(float p_suc, float t_suc, float t_dis, float compSpeed)
 		}
 	}
 
-	return pd_int;
+	res->p_dis = pd_int - 101.35;
+	res->iterations = i;
+	res->residual = fabsf(hd_int - h_dis);
+	SENSOR_PROF_END(SENSOR_PROF_PDIS_TEMP);
+	return res->converged;
 }
 
 
 
 
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_pdis_curr()
+ *
+ * \brief		Calculated pressure of discharge gas by current.
+ *				Bisection, stopped after max_iter iterations at the latest.
+ *
+ * \param[in]	p_suc = suction gas pressure in kPa_a(absolute pressure).
+ * \param[in]	coe = intermediate coefficients of the compressor model.
+ * \param[in]	I_test = the current of driver in amp.
+ * \param[in]	U = the voltage of compressor.
+ * \param[in]	max_iter = iteration budget, must be > 0.
+ * \param[out]	res = discharge gas pressure in kPa(gage pressure), bound and iterations.
+ *
+ * \return		1 if the current tolerance was met, otherwise 0.
+*/
+//-------------------------------------------------------------------------------------------------
+static int cal_pdis_curr(float p_suc, const comp_coe_t *coe, float I_test, float U,
+						 unsigned int max_iter, pdis_result_t *res)
+{
+	float Pd_int1 = 100, Pd_int2=4300, Pd_int;
+	float I;
+	unsigned int i;
+	SENSOR_PROF_BEGIN();
 
+	res->converged = 0;
+	for (i = 0; i < max_iter; i++)
+	{
+		Pd_int = (Pd_int1+Pd_int2)/2;
+		res->err_bound = (Pd_int2-Pd_int1)/2;
+
+		/* calculating current I */
+		I = cal_current_coe(coe, Pd_int, p_suc, U);
+		if (fabs(I - I_test) < 0.001)
+		{
+			res->converged = 1;
+			i++;
+			break;
+		}
+		else
+		{
+			if ((I - I_test) < 0)
+			{
+				Pd_int1 = Pd_int;
+			}
+			else
+			{
+				Pd_int2 = Pd_int;
+			}
+		}
+	}
 
+	res->p_dis = Pd_int - 101.35;
+	res->iterations = i;
+	res->residual = fabsf(I - I_test);
+	SENSOR_PROF_END(SENSOR_PROF_PDIS_CURR);
+	return res->converged;
+}
 
 
 
 
-void sensor_pre_test(void)
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Tdis()
+ *
+ * \brief		Predict temperature of discharge gas.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	t_suc = suction gas temperature in ℃.
+ * \param[in]	p_dis_g = discharge gas pressure in kPa(gage pressure).
+ * \param[in]	compSpeed = compressor speed in rpm.
+ *
+ * \return		discharge gas temperature in ℃.
+*/
+//-------------------------------------------------------------------------------------------------
+float pred_Tdis(float p_suc_g, float t_suc, float p_dis_g, float compSpeed)
+{
+	suction_state_t suc;
+	comp_coe_t coe;
+	float p_dis;	//discharge gas pressure in kPa_a(absolute pressure)
+	float t_dis;
+	SENSOR_PROF_BEGIN();
+
+	// gage pressure converte to absolute pressure
+	p_dis = p_dis_g + 101.35;
+
+	cal_suction_state(p_suc_g, t_suc, &suc);
+	cal_comp_coe(compSpeed, &coe);
+	cal_tdis(&suc, &coe, FW, p_dis, &t_dis);
+
+	SENSOR_PROF_END(SENSOR_PROF_PRED_TDIS);
+	return t_dis;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Tdis_status()
+ *
+ * \brief		Predict temperature of discharge gas and report whether the model has a solution.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	t_suc = suction gas temperature in ℃.
+ * \param[in]	p_dis_g = discharge gas pressure in kPa(gage pressure).
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[out]	t_dis = discharge gas temperature in ℃, TDIS_NO_ROOT_VALUE if there is no root.
+ *
+ * \return		TDIS_OK or TDIS_NO_ROOT.
+*/
+//-------------------------------------------------------------------------------------------------
+tdis_status_t pred_Tdis_status(float p_suc_g, float t_suc, float p_dis_g, float compSpeed, float *t_dis)
 {
-	float	Pd = 2152.59, Ps = 1390.88, CompSpeed = 1740, ST = 20.54;
-	float t_dis, p_dis;
+	suction_state_t suc;
+	comp_coe_t coe;
 
-	t_dis = pred_Tdis(Ps, ST, Pd, CompSpeed);
-	p_dis = pred_Pdis(641, -2.23, 56.39, 7080);
+	cal_suction_state(p_suc_g, t_suc, &suc);
+	cal_comp_coe(compSpeed, &coe);
 
+	return cal_tdis(&suc, &coe, FW, p_dis_g + 101.35, t_dis);
 }
 
 
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Tdis_delay()
+ *
+ * \brief		Predict temperature of discharge gas by first order delay.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	t_suc = suction gas temperature in ℃.
+ * \param[in]	p_dis_g = discharge gas pressure in kPa(gage pressure).
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	tau = 时间常数tau在开机前5分钟为300；正常运行阶段为100；关机（压缩机转速为0）为200
+ * \param[in]	T_interval = t[i]-t[i-1]：i和i-1时刻的时间间隔
+ *
+ * \return		discharge gas temperature in ℃.
+*/
+//-------------------------------------------------------------------------------------------------
+float pre_temp;	//TODO: TEMP
+float pred_Tdis_delay(float p_suc_g, float t_suc, float p_dis_g, float compSpeed, int tau, float T_interval)
+{
+	float t_dis, res;
+	// static float pre_temp = 22.2;//TODO: TEMP
+	if ((tau != 300) && (tau != 100) && (tau != 200))
+	{
+		return 0;
+	}
+
+	t_dis = pred_Tdis(p_suc_g, t_suc, p_dis_g, compSpeed);
+
+	res = cal_delay(pre_temp, t_dis, tau, T_interval);
+	pre_temp = res;
+
+	return res;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_temp()
+ *
+ * \brief		Predict pressure of discharge gas by temperature.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	t_suc = suction gas temperature in ℃.
+ * \param[in]	t_dis = discharge gas temperature in ℃.
+ * \param[in]	compSpeed = compressor speed in rpm.
+ *
+ * \return		discharge gas pressure in kPa(gage pressure).
+*/
+//-------------------------------------------------------------------------------------------------
+float pred_Pdis_temp(float p_suc_g, float t_suc, float t_dis, float compSpeed)
+{
+	suction_state_t suc;
+	comp_coe_t coe;
+	pdis_result_t res;
+
+	if (!cal_suction_state(p_suc_g, t_suc, &suc))
+	{
+		return 0;
+	}
+	cal_comp_coe(compSpeed, &coe);
+	cal_pdis_temp(&suc, &coe, FW, t_dis, PDIS_TEMP_ITER_MAX, &res);
+	if (pred_stats != NULL)
+		cal_solver_stats(&pred_stats[EST_SOLVER_PDIS_TEMP], &res);
+
+	return res.p_dis;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_curr()
+ *
+ * \brief		Predict pressure of discharge gas by current.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	I_test = the current of driver in amp.
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	U = the voltage of compressor.
+ *
+ * \return		discharge gas pressure in kPa.
+*/
+//-------------------------------------------------------------------------------------------------
+float pred_Pdis_curr(float p_suc_g, float I_test, float compSpeed,  float U)
+{
+	comp_coe_t coe;
+	pdis_result_t res;
+	float p_suc;	//suction gas pressure in kPa_a(absolute pressure)
+
+	// gage pressure converte to absolute pressure
+	p_suc = p_suc_g + 101.35;
+
+	cal_comp_coe(compSpeed, &coe);
+	cal_pdis_curr(p_suc, &coe, I_test, U, PDIS_CURR_ITER_MAX, &res);
+	if (pred_stats != NULL)
+		cal_solver_stats(&pred_stats[EST_SOLVER_PDIS_CURR], &res);
+
+	return res.p_dis;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_temp_budget()
+ *
+ * \brief		Predict pressure of discharge gas by temperature within an iteration budget.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	t_suc = suction gas temperature in ℃.
+ * \param[in]	t_dis = discharge gas temperature in ℃.
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	max_iter = iteration budget, 0 or more than PDIS_TEMP_ITER_MAX for PDIS_TEMP_ITER_MAX.
+ * \param[out]	res = estimate, error bound, iterations and converged flag.
+ *
+ * \return		1 if converged, otherwise 0. res->iterations is 0 if there is no estimate.
+*/
+//-------------------------------------------------------------------------------------------------
+int pred_Pdis_temp_budget(float p_suc_g, float t_suc, float t_dis, float compSpeed,
+						  unsigned int max_iter, pdis_result_t *res)
+{
+	suction_state_t suc;
+	comp_coe_t coe;
+
+	if (!cal_suction_state(p_suc_g, t_suc, &suc))
+	{
+		res->p_dis = 0;
+		res->err_bound = 0;
+		res->iterations = 0;
+		res->converged = 0;
+		res->residual = 0;
+		return 0;
+	}
+	cal_comp_coe(compSpeed, &coe);
+	cal_pdis_temp(&suc, &coe, FW, t_dis, cal_iter_budget(max_iter, PDIS_TEMP_ITER_MAX), res);
+	if (pred_stats != NULL)
+		cal_solver_stats(&pred_stats[EST_SOLVER_PDIS_TEMP], res);
+
+	return res->converged;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_curr_budget()
+ *
+ * \brief		Predict pressure of discharge gas by current within an iteration budget.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	I_test = the current of driver in amp.
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	U = the voltage of compressor.
+ * \param[in]	max_iter = iteration budget, 0 or more than PDIS_CURR_ITER_MAX for PDIS_CURR_ITER_MAX.
+ * \param[out]	res = estimate, error bound, iterations and converged flag.
+ *
+ * \return		1 if converged, otherwise 0.
+*/
+//-------------------------------------------------------------------------------------------------
+int pred_Pdis_curr_budget(float p_suc_g, float I_test, float compSpeed, float U,
+						  unsigned int max_iter, pdis_result_t *res)
+{
+	comp_coe_t coe;
+
+	cal_comp_coe(compSpeed, &coe);
+	cal_pdis_curr(p_suc_g + 101.35, &coe, I_test, U, cal_iter_budget(max_iter, PDIS_CURR_ITER_MAX), res);
+	if (pred_stats != NULL)
+		cal_solver_stats(&pred_stats[EST_SOLVER_PDIS_CURR], res);
+
+	return res->converged;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_unchanged()
+ *
+ * \brief		Check the inputs of the selected outputs against the sample of the last full solve.
+ *
+ * \param[in]	ctx = estimator context.
+ * \param[in]	sample = measured signals.
+ * \param[in]	mask = EST_OUT_xxx bits of the outputs to calculate.
+ *
+ * \return		1 if the outputs of the last full solve can be reused, otherwise 0.
+*/
+//-------------------------------------------------------------------------------------------------
+static int cal_unchanged(const estimator_ctx_t *ctx, const estimator_sample_t *sample, unsigned int mask)
+{
+	const estimator_sample_t *last = &ctx->steady_in;
+	const estimator_eps_t *eps = &ctx->eps;
+
+	if (!ctx->skip_enabled || !ctx->steady_mask || (mask & ~ctx->steady_mask) ||
+		(ctx->steady_budget != ctx->iter_budget))
+	{
+		return 0;
+	}
+
+	/* used by every output */
+	if (!(fabsf(sample->p_suc_g - last->p_suc_g) <= eps->p) ||
+		!(fabsf(sample->compSpeed - last->compSpeed) <= eps->speed))
+	{
+		return 0;
+	}
+	if ((mask & (EST_OUT_TDIS | EST_OUT_TDIS_DELAY | EST_OUT_PDIS_TEMP)) &&
+		!(fabsf(sample->t_suc - last->t_suc) <= eps->t))
+	{
+		return 0;
+	}
+	if ((mask & (EST_OUT_TDIS | EST_OUT_TDIS_DELAY)) &&
+		!(fabsf(sample->p_dis_g - last->p_dis_g) <= eps->p))
+	{
+		return 0;
+	}
+	if ((mask & EST_OUT_PDIS_TEMP) &&
+		!(fabsf(sample->t_dis - last->t_dis) <= eps->t))
+	{
+		return 0;
+	}
+	if ((mask & EST_OUT_PDIS_CURR) &&
+		(!(fabsf(sample->I_test - last->I_test) <= eps->I) || (sample->U != last->U)))
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			cal_steady()
+ *
+ * \brief		Full solve of the selected outputs, without the first order delay.
+ *
+ * \param[in]	ctx = estimator context, for the iteration budget, the model constants and the
+ *				convergence counters.
+ * \param[in]	sample = measured signals.
+ * \param[in]	mask = EST_OUT_xxx bits of the outputs to calculate.
+ * \param[out]	out = calculated outputs. EST_OUT_TDIS is set whenever t_dis was calculated,
+ *				also if only EST_OUT_TDIS_DELAY was selected.
+*/
+//-------------------------------------------------------------------------------------------------
+static void cal_steady(estimator_ctx_t *ctx, const estimator_sample_t *sample, unsigned int mask,
+					   estimator_outputs_t *out)
+{
+	suction_state_t suc;
+	comp_coe_t coe;
+	pdis_result_t res;
+	int suc_ok = 0;
+
+	out->valid = 0;
+	out->not_converged = 0;
+
+	/* Shared by every output */
+	cal_comp_coe_k(ctx->params.coe, sample->compSpeed, &coe);
+	if (mask & (EST_OUT_TDIS | EST_OUT_TDIS_DELAY | EST_OUT_PDIS_TEMP))
+	{
+		suc_ok = cal_suction_state(sample->p_suc_g, sample->t_suc, &suc);
+	}
+	else
+	{
+		suc.p_suc = sample->p_suc_g + 101.35;
+	}
+
+	/* temperature of discharge gas */
+	if (mask & (EST_OUT_TDIS | EST_OUT_TDIS_DELAY))
+	{
+		if (cal_tdis(&suc, &coe, ctx->params.fw, sample->p_dis_g + 101.35, &out->t_dis) != TDIS_OK)
+		{
+			out->not_converged |= EST_OUT_TDIS;
+		}
+		out->valid |= EST_OUT_TDIS;
+	}
+
+	/* pressure of discharge gas by temperature */
+	if ((mask & EST_OUT_PDIS_TEMP) && suc_ok)
+	{
+		if (!cal_pdis_temp(&suc, &coe, ctx->params.fw, sample->t_dis,
+						   cal_iter_budget(ctx->iter_budget, PDIS_TEMP_ITER_MAX), &res))
+		{
+			out->not_converged |= EST_OUT_PDIS_TEMP;
+		}
+		if (ctx->stats_enabled)
+			cal_solver_stats(&ctx->stats[EST_SOLVER_PDIS_TEMP], &res);
+		out->p_dis_temp = res.p_dis;
+		out->p_dis_temp_err = res.err_bound;
+		out->valid |= EST_OUT_PDIS_TEMP;
+	}
+
+	/* pressure of discharge gas by current */
+	if (mask & EST_OUT_PDIS_CURR)
+	{
+		if (!cal_pdis_curr(suc.p_suc, &coe, sample->I_test, sample->U,
+						   cal_iter_budget(ctx->iter_budget, PDIS_CURR_ITER_MAX), &res))
+		{
+			out->not_converged |= EST_OUT_PDIS_CURR;
+		}
+		if (ctx->stats_enabled)
+			cal_solver_stats(&ctx->stats[EST_SOLVER_PDIS_CURR], &res);
+		out->p_dis_curr = res.p_dis;
+		out->p_dis_curr_err = res.err_bound;
+		out->valid |= EST_OUT_PDIS_CURR;
+	}
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_init()
+ *
+ * \brief		Initialize the estimator context. The change detection is on with zero
+ *				epsilons, i.e. only bit-identical inputs skip the solve.
+ *
+ * \param[out]	ctx = estimator context.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_init(estimator_ctx_t *ctx)
+{
+	static const estimator_eps_t eps_exact = {0, 0, 0, 0};
+
+	ctx->pre_temp = 0;
+	ctx->initialized = 0;
+	ctx->gap_max = 0;
+	ctx->iter_budget = 0;
+	ctx->steady_mask = 0;
+	ctx->steady_budget = 0;
+	ctx->steps = 0;
+	ctx->skipped = 0;
+	ctx->stats_enabled = 0;
+	estimator_reset_stats(ctx);
+	estimator_default_params(&ctx->params);
+	estimator_set_skip(ctx, &eps_exact);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_default_params()
+ *
+ * \brief		Model constants used by the pred_xxx() functions.
+ *
+ * \param[out]	params = model constants.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_default_params(estimator_params_t *params)
+{
+	params->fw = FW;
+	params->tau[EST_PHASE_OFF] = 200;
+	params->tau[EST_PHASE_STARTUP] = 300;
+	params->tau[EST_PHASE_RUNNING] = 100;
+	params->coe = COE_32;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_set_params()
+ *
+ * \brief		Replace the model constants of a context.
+ *
+ * \param[in]	ctx = estimator context.
+ * \param[in]	params = model constants, NULL for the defaults.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_set_params(estimator_ctx_t *ctx, const estimator_params_t *params)
+{
+	if (params == NULL)
+	{
+		estimator_default_params(&ctx->params);
+	}
+	else
+	{
+		ctx->params = *params;
+	}
+	ctx->steady_mask = 0;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_phase()
+ *
+ * \brief		Phase of operation by the running time of the compressor.
+ *
+ * \param[in]	work_minutes = running time of the compressor in minutes, 0 while off.
+ *
+ * \return		EST_PHASE_OFF, EST_PHASE_STARTUP or EST_PHASE_RUNNING.
+*/
+//-------------------------------------------------------------------------------------------------
+est_phase_t estimator_phase(float work_minutes)
+{
+	if (work_minutes < 0.001)
+	{
+		return EST_PHASE_OFF;
+	}
+	return (work_minutes < EST_STARTUP_MINUTES) ? EST_PHASE_STARTUP : EST_PHASE_RUNNING;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_set_skip()
+ *
+ * \brief		Configure the change detection of estimator_step().
+ *
+ * \param[in]	ctx = estimator context.
+ * \param[in]	eps = largest input changes which reuse the last full solve, NULL to always solve.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_set_skip(estimator_ctx_t *ctx, const estimator_eps_t *eps)
+{
+	if (eps == NULL)
+	{
+		ctx->skip_enabled = 0;
+		return;
+	}
+	ctx->eps = *eps;
+	ctx->skip_enabled = 1;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_set_stats()
+ *
+ * \brief		Switch the convergence counters of the pressure solvers on or off.
+ *
+ * \param[in]	ctx = estimator context.
+ * \param[in]	enabled = 1 to count, 0 to stop.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_set_stats(estimator_ctx_t *ctx, int enabled)
+{
+	ctx->stats_enabled = enabled;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_reset_stats()
+ *
+ * \brief		Clear the convergence counters of a context.
+ *
+ * \param[in]	ctx = estimator context.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_reset_stats(estimator_ctx_t *ctx)
+{
+	memset(ctx->stats, 0, sizeof(ctx->stats));
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_set_stats()
+ *
+ * \brief		Convergence counters of the pred_Pdis_xxx() functions.
+ *
+ * \param[in]	stats = EST_SOLVER_N counters, NULL to stop counting.
+*/
+//-------------------------------------------------------------------------------------------------
+void pred_set_stats(solver_stats_t *stats)
+{
+	pred_stats = stats;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			solver_stats_merge()
+ *
+ * \brief		Add the counters of src to dst.
+ *
+ * \param[in]	dst = counters.
+ * \param[in]	src = counters to add.
+*/
+//-------------------------------------------------------------------------------------------------
+void solver_stats_merge(solver_stats_t *dst, const solver_stats_t *src)
+{
+	dst->runs += src->runs;
+	dst->not_converged += src->not_converged;
+	dst->iterations += src->iterations;
+	for (int i = 0; i < SOLVER_HIST_N; i++)
+		dst->hist[i] += src->hist[i];
+	if (src->residual_max > dst->residual_max)
+		dst->residual_max = src->residual_max;
+	if (src->err_bound_max > dst->err_bound_max)
+		dst->err_bound_max = src->err_bound_max;
+	dst->residual_sum += src->residual_sum;
+	dst->err_bound_sum += src->err_bound_sum;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_delay_gain()
+ *
+ * \brief		Gain of the first order delay for one sample, as estimator_step() applies it.
+ *
+ * \param[in]	ctx = estimator context, for the tau schedule and gap_max.
+ * \param[in]	sample = measured signals, tau and T_interval.
+ * \param[in]	seeded = 1 if the delay holds a previous output.
+ *
+ * \return		1 to seed the delay with t_dis, 0 if the delay does not advance.
+*/
+//-------------------------------------------------------------------------------------------------
+double estimator_delay_gain(const estimator_ctx_t *ctx, const estimator_sample_t *sample, int seeded)
+{
+	if ((sample->tau != ctx->params.tau[EST_PHASE_OFF]) && (sample->tau != ctx->params.tau[EST_PHASE_STARTUP]) &&
+		(sample->tau != ctx->params.tau[EST_PHASE_RUNNING]))
+	{
+		return 0;
+	}
+	if (!seeded || ((ctx->gap_max > 0) && (sample->T_interval > ctx->gap_max)))
+	{
+		return 1;
+	}
+	return cal_delay_gain(sample->tau, sample->T_interval);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_step()
+ *
+ * \brief		Calculate the selected virtual sensor outputs of one sample in a single pass.
+ *
+ * \param[in]	ctx = estimator context, holds the state of the first order delay.
+ * \param[in]	sample = measured signals.
+ * \param[in]	mask = EST_OUT_xxx bits of the outputs to calculate.
+ * \param[out]	outputs = calculated outputs, see outputs->valid.
+ *
+ * \return		EST_OUT_xxx bits of the outputs which were calculated.
+*/
+//-------------------------------------------------------------------------------------------------
+unsigned int estimator_step(estimator_ctx_t *ctx, const estimator_sample_t *sample, unsigned int mask,
+							estimator_outputs_t *outputs)
+{
+	const estimator_outputs_t *steady = &ctx->steady;
+	SENSOR_PROF_BEGIN();
+
+	/* full solve only if the inputs changed */
+	ctx->steps++;
+	if (cal_unchanged(ctx, sample, mask))
+	{
+		ctx->skipped++;
+	}
+	else
+	{
+		cal_steady(ctx, sample, mask, &ctx->steady);
+		ctx->steady_in = *sample;
+		ctx->steady_mask = mask & EST_OUT_ALL;
+		ctx->steady_budget = ctx->iter_budget;
+	}
+
+	*outputs = *steady;
+	outputs->valid = steady->valid & mask & ~EST_OUT_TDIS_DELAY;
+	outputs->not_converged = steady->not_converged & mask & ~EST_OUT_TDIS_DELAY;
+
+	/* first order delay, advanced on every step */
+	if ((mask & EST_OUT_TDIS_DELAY) && (steady->valid & EST_OUT_TDIS))
+	{
+		if (steady->not_converged & EST_OUT_TDIS)
+		{
+			outputs->not_converged |= EST_OUT_TDIS_DELAY;
+		}
+		if ((sample->tau == ctx->params.tau[EST_PHASE_OFF]) || (sample->tau == ctx->params.tau[EST_PHASE_STARTUP]) ||
+			(sample->tau == ctx->params.tau[EST_PHASE_RUNNING]))
+		{
+			/* after a gap in the data the delayed state is stale, start again from t_dis */
+			if ((ctx->gap_max > 0) && (sample->T_interval > ctx->gap_max))
+			{
+				ctx->initialized = 0;
+			}
+			if (!ctx->initialized)
+			{
+				ctx->pre_temp = steady->t_dis;
+				ctx->initialized = 1;
+			}
+			ctx->pre_temp = cal_delay(ctx->pre_temp, steady->t_dis, sample->tau, sample->T_interval);
+			outputs->t_dis_delay = ctx->pre_temp;
+			outputs->valid |= EST_OUT_TDIS_DELAY;
+		}
+	}
+
+	SENSOR_PROF_END(SENSOR_PROF_EST_STEP);
+	return outputs->valid;
+}
+
+
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sensor_pre_test()
+ *
+ * \brief		Spot check of the prediction. The replay of the logged data is done by
+ *				tools/sensor_replay.c.
+*/
+//-------------------------------------------------------------------------------------------------
+void sensor_pre_test(void)
+{
+	float p_dis_a;
+
+	// p_dis_t = pred_Pdis_temp(641, -2.23, 56.39, 7080);
+	p_dis_a = pred_Pdis_curr(1584.304, 0.002282, 0, 220);
+	// printf("p_dis_t = %f: \r\n", p_dis_t);
+	printf("p_dis_a = %f: \r\n", p_dis_a);
+}
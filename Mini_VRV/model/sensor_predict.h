@@ -24,21 +24,215 @@
  */
 //-------------------------------------------------------------------------------------------------
 #define FW (0.8)
+#define EST_STARTUP_MINUTES	(5)		// WORK_MINUTES below which the compressor is starting up
 
 //-------------------------------------------------------------------------------------------------
 /**
- * \struct
- * \brief
+ * \def		PDIS_xxx_ITER_MAX
+ * \brief		Iteration limit of the discharge pressure solvers. Every iteration halves the
+ *				bracket [100, 4300] kPa_a and costs a fixed number of model evaluations, so the
+ *				worst case execution time is this limit (or the caller budget) times the time of
+ *				one iteration.
  */
 //-------------------------------------------------------------------------------------------------
+#define PDIS_TEMP_ITER_MAX	(100)		// pred_Pdis_temp()
+#define PDIS_CURR_ITER_MAX	(20)		// pred_Pdis_curr()
 
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def		TDIS_NO_ROOT_VALUE
+ * \brief		Discharge gas temperature in ℃ reported by pred_Tdis() when the model has no
+ *				solution, see TDIS_NO_ROOT.
+ */
+//-------------------------------------------------------------------------------------------------
+#define TDIS_NO_ROOT_VALUE	(150)
 
 //-------------------------------------------------------------------------------------------------
 /**
- * \enum
- * \brief
+ * \def		EST_OUT_xxx
+ * \brief		Output selection bits of estimator_step().
+ */
+//-------------------------------------------------------------------------------------------------
+#define EST_OUT_TDIS		(0x01u)		// discharge gas temperature, see pred_Tdis()
+#define EST_OUT_TDIS_DELAY	(0x02u)		// discharge gas temperature by first order delay, see pred_Tdis_delay()
+#define EST_OUT_PDIS_TEMP	(0x04u)		// discharge gas pressure by temperature, see pred_Pdis_temp()
+#define EST_OUT_PDIS_CURR	(0x08u)		// discharge gas pressure by current, see pred_Pdis_curr()
+#define EST_OUT_ALL			(EST_OUT_TDIS | EST_OUT_TDIS_DELAY | EST_OUT_PDIS_TEMP | EST_OUT_PDIS_CURR)
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		estimator_sample_t
+ * \brief		One sample of the measured signals. Fields that feed only outputs which are not
+ *				selected are ignored.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	float p_suc_g;		// suction gas pressure in kPa(gage pressure).
+	float t_suc;		// suction gas temperature in ℃.
+	float p_dis_g;		// discharge gas pressure in kPa(gage pressure), used by EST_OUT_TDIS*.
+	float compSpeed;	// compressor speed in rpm.
+	float t_dis;		// discharge gas temperature in ℃, used by EST_OUT_PDIS_TEMP.
+	float I_test;		// the current of driver in amp, used by EST_OUT_PDIS_CURR.
+	float U;			// the voltage of compressor, used by EST_OUT_PDIS_CURR.
+	int tau;			// time constant of the delay, see pred_Tdis_delay().
+	float T_interval;	// t[i]-t[i-1] in s, used by EST_OUT_TDIS_DELAY.
+} estimator_sample_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		estimator_outputs_t
+ * \brief		Virtual sensor outputs of one estimator_step().
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	unsigned int valid;	// EST_OUT_xxx bits of the outputs below which were calculated.
+	float t_dis;		// discharge gas temperature in ℃.
+	float t_dis_delay;	// discharge gas temperature after first order delay in ℃.
+	float p_dis_temp;	// discharge gas pressure by temperature in kPa(gage pressure).
+	float p_dis_curr;	// discharge gas pressure by current in kPa(gage pressure).
+	unsigned int not_converged;	// EST_OUT_xxx bits of the outputs without solution: pressures which ran
+								// out of budget, temperatures without root (TDIS_NO_ROOT).
+	float p_dis_temp_err;		// error bound of p_dis_temp in kPa, see pdis_result_t.
+	float p_dis_curr_err;		// error bound of p_dis_curr in kPa, see pdis_result_t.
+} estimator_outputs_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		pdis_result_t
+ * \brief		Result of a discharge pressure solver run within an iteration budget.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	float p_dis;			// best estimate, middle of the last bracket, in kPa(gage pressure).
+	float err_bound;		// half width of the last bracket in kPa: |p_dis - root| <= err_bound as
+							// long as the root lies in the initial bracket.
+	unsigned int iterations;// iterations run.
+	int converged;			// 1 if the tolerance was met, 0 if the budget ran out first.
+	float residual;			// |model - measurement| at p_dis: enthalpy in J/kg by temperature,
+							// current in amp by current.
+} pdis_result_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		est_solver_t
+ * \brief		Iterative solvers with convergence counters, see solver_stats_t.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	EST_SOLVER_PDIS_TEMP = 0,	// pred_Pdis_temp(), EST_OUT_PDIS_TEMP
+	EST_SOLVER_PDIS_CURR,		// pred_Pdis_curr(), EST_OUT_PDIS_CURR
+	EST_SOLVER_N
+} est_solver_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		solver_stats_t
+ * \brief		Convergence counters of one solver, see estimator_set_stats(). Every run of the
+ *				solver adds its pdis_result_t; runs skipped by the change detection are not counted.
+ */
+//-------------------------------------------------------------------------------------------------
+#define SOLVER_HIST_N		(32)		// bins of solver_stats_t.hist[], the last one for SOLVER_HIST_N-1 or more
+
+typedef struct
+{
+	unsigned long runs;				// solver runs.
+	unsigned long not_converged;	// runs which ran out of iterations.
+	unsigned long iterations;		// iterations of all runs.
+	unsigned long hist[SOLVER_HIST_N];	// runs by iterations.
+	float residual_max;				// largest residual at exit, see pdis_result_t.
+	float err_bound_max;			// largest half width of the bracket at exit in kPa.
+	double residual_sum;			// sum of the residuals at exit, for the mean.
+	double err_bound_sum;			// sum of the half widths at exit, for the mean.
+} solver_stats_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		estimator_eps_t
+ * \brief		Change detection of estimator_step(): a sample whose inputs all lie within these
+ *				distances of the last fully solved sample reuses its outputs, and only the first
+ *				order delay is advanced. Zero means bit-identical.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	float p;			// p_suc_g and p_dis_g in kPa.
+	float t;			// t_suc and t_dis in ℃.
+	float speed;		// compSpeed in rpm.
+	float I;			// I_test in amp. U must be identical.
+} estimator_eps_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		est_phase_t
+ * \brief		Phase of operation by WORK_MINUTES, see estimator_phase().
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	EST_PHASE_OFF = 0,	// compressor off
+	EST_PHASE_STARTUP,	// first EST_STARTUP_MINUTES minutes
+	EST_PHASE_RUNNING,
+	EST_PHASE_N
+} est_phase_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		estimator_params_t
+ * \brief		Model constants of the estimator, see estimator_set_params().
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	double fw;				// share of the compressor power in the discharge gas enthalpy, FW.
+	int tau[EST_PHASE_N];	// time constant of the delay by phase in s, 200/300/100.
+	const float *coe;		// COMP_COE_N initial coefficients of the compressor model, COE_32[].
+} estimator_params_t;
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		estimator_ctx_t
+ * \brief		State of one estimator instance. Every unit (or replayed log) owns its own context.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	float pre_temp;		// last output of the first order delay in ℃.
+	int initialized;	// pre_temp is valid; the first delayed sample is seeded with pred_Tdis().
+	float gap_max;		// T_interval in s above which the delay is seeded again, 0 for never.
+	unsigned int iter_budget;	// iteration budget of each pressure solver, 0 for PDIS_xxx_ITER_MAX.
+	estimator_params_t params;	// model constants, see estimator_set_params().
+
+	/* change detection, see estimator_set_skip() */
+	int skip_enabled;
+	estimator_eps_t eps;
+	estimator_sample_t steady_in;	// inputs of the last full solve.
+	estimator_outputs_t steady;		// outputs of the last full solve, without the delay.
+	unsigned int steady_mask;		// EST_OUT_xxx bits of the last full solve, 0 if none.
+	unsigned int steady_budget;		// iter_budget of the last full solve.
+	unsigned long steps;			// calls of estimator_step().
+	unsigned long skipped;			// calls which reused the last full solve.
+
+	/* convergence counters, see estimator_set_stats() */
+	int stats_enabled;
+	solver_stats_t stats[EST_SOLVER_N];
+} estimator_ctx_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		tdis_status_t
+ * \brief		Status of the discharge gas temperature, see pred_Tdis_status().
  */
 //------------------------------------------------------------------------------------------------
+typedef enum
+{
+	TDIS_OK = 0,		// solution found.
+	TDIS_NO_ROOT,		// the enthalpy model has no real root, t_dis = TDIS_NO_ROOT_VALUE.
+} tdis_status_t;
 
 
 
@@ -48,32 +242,298 @@
  *
  * \brief		Predict temperature of discharge gas.
  *
- * \param[in]	p_suc = suction gas pressure in kPa.
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	t_suc = suction gas temperature in ℃.
+ * \param[in]	p_dis_g = discharge gas pressure in kPa(gage pressure).
+ * \param[in]	compSpeed = compressor speed in rpm.
+ *
+ * \return		discharge gas temperature in ℃, TDIS_NO_ROOT_VALUE if there is no solution.
+*/
+//-------------------------------------------------------------------------------------------------
+float pred_Tdis(float p_suc_g, float t_suc, float p_dis_g, float compSpeed);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Tdis_status()
+ *
+ * \brief		Predict temperature of discharge gas and report whether the model has a solution.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	t_suc = suction gas temperature in ℃.
+ * \param[in]	p_dis_g = discharge gas pressure in kPa(gage pressure).
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[out]	t_dis = discharge gas temperature in ℃, TDIS_NO_ROOT_VALUE if there is no root.
+ *
+ * \return		TDIS_OK or TDIS_NO_ROOT.
+*/
+//-------------------------------------------------------------------------------------------------
+tdis_status_t pred_Tdis_status(float p_suc_g, float t_suc, float p_dis_g, float compSpeed, float *t_dis);
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Tdis_delay()
+ *
+ * \brief		Predict temperature of discharge gas by first order delay.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
  * \param[in]	t_suc = suction gas temperature in ℃.
- * \param[in]	p_dis = discharge gas pressure in kPa.
+ * \param[in]	p_dis_g = discharge gas pressure in kPa(gage pressure).
  * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	tau = 时间常数tau在开机前5分钟为300；正常运行阶段为100；关机（压缩机转速为0）为200
+ * \param[in]	T_interval = t[i]-t[i-1]：i和i-1时刻的时间间隔
  *
  * \return		discharge gas temperature in ℃.
 */
 //-------------------------------------------------------------------------------------------------
-float pred_Tdis(float p_suc, float t_suc, float p_dis, float compSpeed);
+float pred_Tdis_delay(float p_suc_g, float t_suc, float p_dis_g, float compSpeed, int tau, float T_interval);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_temp()
+ *
+ * \brief		Predict pressure of discharge gas by temperature.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	t_suc = suction gas temperature in ℃.
+ * \param[in]	t_dis = discharge gas temperature in ℃.
+ * \param[in]	compSpeed = compressor speed in rpm.
+ *
+ * \return		discharge gas pressure in kPa(gage pressure).
+*/
+//-------------------------------------------------------------------------------------------------
+float pred_Pdis_temp(float p_suc_g, float t_suc, float t_dis, float compSpeed);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_curr()
+ *
+ * \brief		Predict pressure of discharge gas by current.
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	I_test = the current of driver in amp.
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	U = the voltage of compressor.
+ *
+ * \return		discharge gas pressure in kPa(gage pressure).
+*/
+//-------------------------------------------------------------------------------------------------
+float pred_Pdis_curr(float P_suc, float I_test, float compSpeed,  float U);
 
 
 //-------------------------------------------------------------------------------------------------
 /**
- * \fn			pred_Pdis()
+ * \fn			pred_Pdis_temp_budget()
  *
- * \brief		Predict pressure of discharge gas.
+ * \brief		Predict pressure of discharge gas by temperature within an iteration budget.
+ *				Anytime version of pred_Pdis_temp(): the bisection stops at the tolerance or
+ *				after max_iter iterations, whichever comes first, and reports the best bracketed
+ *				estimate. With max_iter = 0 the result equals pred_Pdis_temp().
  *
- * \param[in]	p_suc = suction gas pressure in kPa.
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
  * \param[in]	t_suc = suction gas temperature in ℃.
  * \param[in]	t_dis = discharge gas temperature in ℃.
  * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	max_iter = iteration budget, 0 or more than PDIS_TEMP_ITER_MAX for PDIS_TEMP_ITER_MAX.
+ * \param[out]	res = estimate, error bound, iterations and converged flag.
+ *
+ * \return		1 if converged, otherwise 0. res->iterations is 0 if there is no estimate.
+*/
+//-------------------------------------------------------------------------------------------------
+int pred_Pdis_temp_budget(float p_suc_g, float t_suc, float t_dis, float compSpeed,
+						  unsigned int max_iter, pdis_result_t *res);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_Pdis_curr_budget()
+ *
+ * \brief		Predict pressure of discharge gas by current within an iteration budget.
+ *				Anytime version of pred_Pdis_curr(), see pred_Pdis_temp_budget().
+ *
+ * \param[in]	p_suc_g = suction gas pressure in kPa(gage pressure).
+ * \param[in]	I_test = the current of driver in amp.
+ * \param[in]	compSpeed = compressor speed in rpm.
+ * \param[in]	U = the voltage of compressor.
+ * \param[in]	max_iter = iteration budget, 0 or more than PDIS_CURR_ITER_MAX for PDIS_CURR_ITER_MAX.
+ * \param[out]	res = estimate, error bound, iterations and converged flag.
+ *
+ * \return		1 if converged, otherwise 0.
+*/
+//-------------------------------------------------------------------------------------------------
+int pred_Pdis_curr_budget(float p_suc_g, float I_test, float compSpeed, float U,
+						  unsigned int max_iter, pdis_result_t *res);
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_init()
+ *
+ * \brief		Initialize the estimator context. The change detection is on with zero
+ *				epsilons, i.e. only bit-identical inputs skip the solve.
+ *
+ * \param[out]	ctx = estimator context.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_init(estimator_ctx_t *ctx);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_set_stats()
+ *
+ * \brief		Switch the convergence counters ctx->stats[] of the pressure solvers on or off.
+ *				Off by default; when off a solve costs one test more. The counters keep their
+ *				values when switched, see estimator_reset_stats().
+ *
+ * \param[in]	ctx = estimator context.
+ * \param[in]	enabled = 1 to count, 0 to stop.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_set_stats(estimator_ctx_t *ctx, int enabled);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_reset_stats()
+ *
+ * \brief		Clear the convergence counters of a context.
+ *
+ * \param[in]	ctx = estimator context.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_reset_stats(estimator_ctx_t *ctx);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			pred_set_stats()
+ *
+ * \brief		Convergence counters of the pred_Pdis_xxx() functions, which have no context.
+ *				Not thread safe, the counters are shared by every caller.
+ *
+ * \param[in]	stats = EST_SOLVER_N counters, NULL to stop counting.
+*/
+//-------------------------------------------------------------------------------------------------
+void pred_set_stats(solver_stats_t *stats);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			solver_stats_merge()
+ *
+ * \brief		Add the counters of src to dst, e.g. of several contexts.
  *
- * \return		discharge gas pressure in kPa.
+ * \param[in]	dst = counters.
+ * \param[in]	src = counters to add.
 */
 //-------------------------------------------------------------------------------------------------
-float pred_Pdis(float p_suc, float t_suc, float t_dis, float compSpeed);
+void solver_stats_merge(solver_stats_t *dst, const solver_stats_t *src);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_set_skip()
+ *
+ * \brief		Configure the change detection of estimator_step(). ctx->steps and
+ *				ctx->skipped count the calls and the skipped full solves.
+ *
+ * \param[in]	ctx = estimator context.
+ * \param[in]	eps = largest input changes which reuse the last full solve, NULL to always solve.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_set_skip(estimator_ctx_t *ctx, const estimator_eps_t *eps);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_default_params()
+ *
+ * \brief		Model constants used by the pred_xxx() functions: FW, tau 200/300/100, COE_32[].
+ *
+ * \param[out]	params = model constants.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_default_params(estimator_params_t *params);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_set_params()
+ *
+ * \brief		Replace the model constants of a context. The outputs of the last full solve are
+ *				dropped, the state of the first order delay is kept.
+ *
+ * \param[in]	ctx = estimator context.
+ * \param[in]	params = model constants, NULL for estimator_default_params(). params->coe
+ *				must stay valid while the context is used.
+*/
+//-------------------------------------------------------------------------------------------------
+void estimator_set_params(estimator_ctx_t *ctx, const estimator_params_t *params);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_phase()
+ *
+ * \brief		Phase of operation, picks the time constant of the delay from params.tau[].
+ *
+ * \param[in]	work_minutes = running time of the compressor in minutes, 0 while off.
+ *
+ * \return		EST_PHASE_OFF, EST_PHASE_STARTUP or EST_PHASE_RUNNING.
+*/
+//-------------------------------------------------------------------------------------------------
+est_phase_t estimator_phase(float work_minutes);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_delay_gain()
+ *
+ * \brief		Gain of the first order delay for one sample, as estimator_step() applies it:
+ *				t_dis_delay = pre + (t_dis - pre)*gain. The delay is linear in pre, so a run
+ *				of samples composes to t_dis_delay = A*pre + B; replay tools use this to split
+ *				one log over several threads.
+ *
+ * \param[in]	ctx = estimator context, for the tau schedule and gap_max.
+ * \param[in]	sample = measured signals, tau and T_interval.
+ * \param[in]	seeded = 1 if the delay holds a previous output (ctx->initialized).
+ *
+ * \return		the gain, 1 to seed the delay with t_dis, 0 if tau is not in the schedule and
+ *				the delay does not advance.
+*/
+//-------------------------------------------------------------------------------------------------
+double estimator_delay_gain(const estimator_ctx_t *ctx, const estimator_sample_t *sample, int seeded);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			estimator_step()
+ *
+ * \brief		Calculate the selected virtual sensor outputs of one sample in a single pass.
+ *				Suction state, compressor coefficients and saturation properties are derived
+ *				once and shared by every selected output. The results are the same as calling
+ *				pred_Tdis(), pred_Tdis_delay(), pred_Pdis_temp() and pred_Pdis_curr() one by one.
+ *				If the inputs did not change, see estimator_set_skip(), the outputs of the last
+ *				full solve are reused and only the first order delay is advanced.
+ *
+ * \param[in]	ctx = estimator context, holds the state of the first order delay and the
+ *				iteration budget of the pressure solvers.
+ * \param[in]	sample = measured signals, sample->tau must be one of ctx->params.tau[].
+ * \param[in]	mask = EST_OUT_xxx bits of the outputs to calculate.
+ * \param[out]	outputs = calculated outputs, see outputs->valid.
+ *
+ * \return		EST_OUT_xxx bits of the outputs which were calculated.
+*/
+//-------------------------------------------------------------------------------------------------
+unsigned int estimator_step(estimator_ctx_t *ctx, const estimator_sample_t *sample, unsigned int mask,
+							estimator_outputs_t *outputs);
+
 
 
 
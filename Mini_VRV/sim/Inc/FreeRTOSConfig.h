@@ -0,0 +1,79 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		FreeRTOSConfig.h
+ *
+ * \brief		Kernel configuration of the simulation build (sim/) on the FreeRTOS POSIX
+ * \brief		port. Priorities, tick rate, task names, static allocation and the run time
+ * \brief		stats are those of Core/Inc/FreeRTOSConfig.h, so the task set behaves as on
+ * \brief		the target; the stacks are those of host threads and much larger.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+#include <assert.h>
+
+extern uint32_t SystemCoreClock;
+extern void configureTimerForRunTimeStats(void);
+extern unsigned long getRunTimeCounterValue(void);
+
+#define configUSE_PREEMPTION                     1
+#define configSUPPORT_STATIC_ALLOCATION          1
+#define configSUPPORT_DYNAMIC_ALLOCATION         1
+#define configUSE_IDLE_HOOK                      1	// sleeps, so the idle task does not spin a host core
+#define configUSE_TICK_HOOK                      1	// HAL tick, TIM7 on the target
+#define configCPU_CLOCK_HZ                       ( SystemCoreClock )
+#define configTICK_RATE_HZ                       ((TickType_t)1000)
+#define configMAX_PRIORITIES                     ( 56 )
+#define configMINIMAL_STACK_SIZE                 ((unsigned short)16384)	// words, >= PTHREAD_STACK_MIN bytes
+#define configSTACK_DEPTH_TYPE                   uint32_t
+#define configMAX_TASK_NAME_LEN                  ( 16 )
+#define configGENERATE_RUN_TIME_STATS            1
+#define configUSE_TRACE_FACILITY                 1
+#define configUSE_STATS_FORMATTING_FUNCTIONS     0
+#define configUSE_16_BIT_TICKS                   0
+#define configUSE_MUTEXES                        1
+#define configQUEUE_REGISTRY_SIZE                8
+#define configUSE_RECURSIVE_MUTEXES              1
+#define configUSE_COUNTING_SEMAPHORES            1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION  0
+#define configUSE_CO_ROUTINES                    0
+#define configUSE_TIMERS                         0
+#define configUSE_NEWLIB_REENTRANT               0
+#define configCHECK_FOR_STACK_OVERFLOW           0
+
+#define INCLUDE_vTaskPrioritySet             1
+#define INCLUDE_uxTaskPriorityGet            1
+#define INCLUDE_vTaskDelete                  1
+#define INCLUDE_vTaskSuspend                 1
+#define INCLUDE_vTaskDelayUntil              1
+#define INCLUDE_xTaskDelayUntil              1
+#define INCLUDE_vTaskDelay                   1
+#define INCLUDE_xTaskGetSchedulerState       1
+#define INCLUDE_uxTaskGetStackHighWaterMark  1
+#define INCLUDE_xTaskGetCurrentTaskHandle    1
+#define INCLUDE_eTaskGetState                1
+
+#define configASSERT( x ) assert( x )
+
+/* run time stats on the cycle counter, as on the target, see cycle_prof.h */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS configureTimerForRunTimeStats
+#define portGET_RUN_TIME_COUNTER_VALUE getRunTimeCounterValue
+
+/* 1 to write a TRACE_TASK_IN record on every task switch, see trace_buf.h */
+#define TRACE_TASK_SWITCHES 0
+#if TRACE_TASK_SWITCHES
+  #include "trace_buf.h"
+  #define traceTASK_SWITCHED_IN() trace_write(TRACE_TASK_IN, pxCurrentTCB->uxTCBNumber, 0, 0)
+#endif
+
+#endif /* FREERTOS_CONFIG_H */
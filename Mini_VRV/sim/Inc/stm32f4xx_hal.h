@@ -0,0 +1,169 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		stm32f4xx_hal.h
+ *
+ * \brief		Host stand-in for the STM32 HAL and CMSIS headers in the simulation build
+ * \brief		(sim/). Core/Inc/main.h includes it as on the target, so the application
+ * \brief		modules get the few pieces they use: the DWT cycle counter, counting host
+ * \brief		time at SIM_CORE_CLOCK, an ITM which the debugger never enabled, PRIMASK
+ * \brief		mapped to the tick signal of the FreeRTOS POSIX port, and the HAL tick and
+ * \brief		GPIO calls, see hal_stub.c.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#ifndef __STM32F4xx_HAL_H
+#define __STM32F4xx_HAL_H
+
+#include <stdint.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define SIM_CORE_CLOCK		(100000000u)	// virtual core clock in Hz, HCLK of the target
+
+#define __weak				__attribute__((weak))
+#define __DMB()				__sync_synchronize()
+#define __NOP()				__asm__ volatile ("" ::: "memory")
+#define __CLZ(x)			((uint8_t)(((x) == 0u) ? 32 : __builtin_clz(x)))
+#define __get_PRIMASK()		sim_get_primask()
+#define __set_PRIMASK(x)	sim_set_primask(x)
+#define __disable_irq()		sim_set_primask(1u)
+#define __enable_irq()		sim_set_primask(0u)
+
+extern uint32_t SystemCoreClock;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		DWT_Type, CoreDebug_Type, ITM_Type
+ * \brief		Registers of the core used by the application, reduced to the used fields.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+	volatile union
+	{
+		uint8_t u8;
+		uint16_t u16;
+		uint32_t u32;
+	} PORT[32];
+	volatile uint32_t TER;
+	volatile uint32_t TCR;
+} ITM_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk			(1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk		(1UL << 24)
+#define ITM_TCR_ITMENA_Msk				(1UL)
+
+#define DWT					(sim_dwt())
+#define CoreDebug			(&sim_core_debug)
+#define ITM					(&sim_itm)
+
+extern CoreDebug_Type sim_core_debug;
+extern ITM_Type sim_itm;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		GPIO_PinState, HAL_StatusTypeDef
+ * \brief		As in the HAL.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef enum
+{
+	HAL_OK = 0,
+	HAL_ERROR,
+	HAL_BUSY,
+	HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef struct
+{
+	uint32_t ODR;				// output data
+	uint32_t IDR;				// input data, set by the simulation
+} GPIO_TypeDef;
+
+#define SIM_GPIO_PORTS		(11)	// GPIOA .. GPIOK
+extern GPIO_TypeDef sim_gpio[SIM_GPIO_PORTS];
+#define GPIOA				(&sim_gpio[0])
+#define GPIOB				(&sim_gpio[1])
+#define GPIOC				(&sim_gpio[2])
+#define GPIOD				(&sim_gpio[3])
+#define GPIOE				(&sim_gpio[4])
+#define GPIOF				(&sim_gpio[5])
+#define GPIOG				(&sim_gpio[6])
+#define GPIOH				(&sim_gpio[7])
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sim_dwt()
+ *
+ * \brief		The cycle counter, refreshed from the monotonic host clock at SIM_CORE_CLOCK
+ *				while DWT_CTRL_CYCCNTENA is set. A write to CYCCNT while it is stopped sets
+ *				its origin.
+ *
+ * \return		the DWT registers.
+*/
+//-------------------------------------------------------------------------------------------------
+DWT_Type *sim_dwt(void);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sim_get_primask(), sim_set_primask()
+ *
+ * \brief		PRIMASK of the calling thread: 1 while the tick signal of the POSIX port
+ *				(SIGALRM) is blocked, so the scheduler cannot switch tasks.
+*/
+//-------------------------------------------------------------------------------------------------
+uint32_t sim_get_primask(void);
+void sim_set_primask(uint32_t primask);
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			HAL_xxx()
+ *
+ * \brief		HAL calls of the firmware, see hal_stub.c. The tick counts the FreeRTOS
+ *				ticks (TIM7 on the target); the GPIO pins are bits in sim_gpio[].
+*/
+//-------------------------------------------------------------------------------------------------
+HAL_StatusTypeDef HAL_Init(void);
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority);
+void HAL_IncTick(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+#endif /* __STM32F4xx_HAL_H */
@@ -0,0 +1,227 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		hal_stub.c
+ *
+ * \brief		Host stand-ins of the STM32 HAL and the core registers for the simulation
+ * \brief		build, see sim/Inc/stm32f4xx_hal.h. TIM7, the HAL time base, becomes the FreeRTOS
+ * \brief		tick hook; the GPIO pins are bits in memory; the cycle counter runs on the
+ * \brief		monotonic host clock.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <signal.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+uint32_t SystemCoreClock = SIM_CORE_CLOCK;
+
+CoreDebug_Type sim_core_debug;
+ITM_Type sim_itm;								// TCR = 0: no debugger, the trace sink is the host
+GPIO_TypeDef sim_gpio[SIM_GPIO_PORTS];
+
+static DWT_Type sim_dwt_regs;
+static uint64_t sim_cycle_origin;				// host time of CYCCNT = 0 in cycles
+
+static volatile uint32_t uwTick;
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sim_host_cycles()
+ *
+ * \brief		Monotonic host time in cycles of SIM_CORE_CLOCK.
+*/
+//-------------------------------------------------------------------------------------------------
+static uint64_t sim_host_cycles(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec) / (1000000000u / SIM_CORE_CLOCK);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sim_dwt()
+ *
+ * \brief		The cycle counter, refreshed from the host clock. Written while it is
+ *				stopped, as by cycle_prof_init(), CYCCNT sets the origin.
+ *
+ * \return		the DWT registers.
+*/
+//-------------------------------------------------------------------------------------------------
+DWT_Type *sim_dwt(void)
+{
+	uint64_t now = sim_host_cycles();
+
+	if ((sim_dwt_regs.CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0UL)
+	{
+		/* stopped: a write sets the origin for the start */
+		sim_cycle_origin = now - sim_dwt_regs.CYCCNT;
+		return &sim_dwt_regs;
+	}
+	sim_dwt_regs.CYCCNT = (uint32_t)(now - sim_cycle_origin);
+	return &sim_dwt_regs;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sim_get_primask()
+ *
+ * \brief		PRIMASK of the calling thread, 1 if the tick signal is blocked in it. The POSIX
+ *				port of V10.4 and later ticks with SIGALRM, blocks all signals in its critical
+ *				sections and tick handler, and starts each task thread blocked until it first
+ *				runs: only the running task can take the tick, so blocking SIGALRM in it defers
+ *				the tick as PRIMASK defers TIM7 and SysTick. Leaving the outermost kernel
+ *				critical section unblocks all signals, which PRIMASK would survive: no FreeRTOS
+ *				call may sit between __disable_irq() and __set_PRIMASK(), none does in
+ *				cycle_prof.c.
+ *
+ * \return		1 in a masked section, a kernel critical section or the tick hook, 0 otherwise.
+*/
+//-------------------------------------------------------------------------------------------------
+uint32_t sim_get_primask(void)
+{
+	sigset_t cur;
+
+	pthread_sigmask(SIG_SETMASK, NULL, &cur);
+	return (uint32_t)(sigismember(&cur, SIGALRM) == 1);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sim_set_primask()
+ *
+ * \brief		Block (1) or unblock (0) the tick signal in the calling thread.
+*/
+//-------------------------------------------------------------------------------------------------
+void sim_set_primask(uint32_t primask)
+{
+	sigset_t set;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGALRM);
+	pthread_sigmask(primask ? SIG_BLOCK : SIG_UNBLOCK, &set, NULL);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			HAL_Init()
+ *
+ * \brief		Clear the pins and the tick.
+*/
+//-------------------------------------------------------------------------------------------------
+HAL_StatusTypeDef HAL_Init(void)
+{
+	int i;
+
+	for (i = 0; i < SIM_GPIO_PORTS; i++)
+	{
+		sim_gpio[i].ODR = 0;
+		sim_gpio[i].IDR = 0;
+	}
+	return HAL_InitTick(0);
+}
+
+
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+	(void)TickPriority;
+	uwTick = 0;
+	return HAL_OK;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			HAL_IncTick()
+ *
+ * \brief		From vApplicationTickHook(), where the target has the TIM7 interrupt.
+*/
+//-------------------------------------------------------------------------------------------------
+void HAL_IncTick(void)
+{
+	uwTick++;
+}
+
+
+uint32_t HAL_GetTick(void)
+{
+	return uwTick;
+}
+
+
+void HAL_Delay(uint32_t Delay)
+{
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+	{
+		vTaskDelay(pdMS_TO_TICKS(Delay) + 1);
+	}
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			HAL_GPIO_xxx()
+ *
+ * \brief		Pins of sim_gpio[]: writes go to ODR, reads come from IDR.
+*/
+//-------------------------------------------------------------------------------------------------
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	if (PinState != GPIO_PIN_RESET)
+	{
+		GPIOx->ODR |= GPIO_Pin;
+	}
+	else
+	{
+		GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+	}
+}
+
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	GPIOx->ODR ^= GPIO_Pin;
+}
+
+
+void Error_Handler(void)
+{
+	fprintf(stderr, "Error_Handler\n");
+	exit(1);
+}
@@ -0,0 +1,560 @@
+//*************************************************************************
+//*************************************************************************
+/**
+ * \file		main_sim.c
+ *
+ * \brief		Host simulation of the Mini_VRV task set on the FreeRTOS POSIX port, in place
+ * \brief		of the CubeMX main.c. The tasks of the firmware are created with their names
+ * \brief		and priorities; the acquisition task (myTask02) posts the rows of recorded
+ * \brief		*_tdis.csv logs to the estimator task at the logged time, in real time or
+ * \brief		accelerated by -x, and the estimator period is shortened by the same factor.
+ * \brief		CPU_Task drains the trace ring as on the target; the sink here measures the
+ * \brief		release jitter of the estimator and can write the records to a file for
+ * \brief		trace_decode.py --raw. After the last row the task latencies, the CPU time of
+ * \brief		every task and the execution time probes are printed.
+ *
+ * \brief		Times are host times, counted in cycles of a virtual 100 MHz core (see
+ * \brief		sim_dwt()); they show the scheduling, not the execution time on the target.
+ *
+ * \copyright	CARRIER CONFIDENTIAL & PROPRIETARY
+ *				COPYRIGHT, CARRIER CORPORATION, 2020
+ *				UNPUBLISHED WORK, ALL RIGHTS RESERVED
+ *
+ * \author		Julien Wang
+*/
+//*************************************************************************
+//*************************************************************************
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "estimator_task.h"
+#include "cycle_prof.h"
+#include "trace_buf.h"
+#include "csv_reader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \def
+ * \brief
+ */
+//-------------------------------------------------------------------------------------------------
+#define SIM_INTERVAL_MS		(2000)		// nominal sample interval of a row without timestamp
+#define SIM_GAP_MS			(10000)		// default longest wait for a row in log time, -g
+#define SIM_STACK			(configMINIMAL_STACK_SIZE)	// stack of every task in words
+#define SIM_VOLTAGE			(220)		// U of the compressor, as in sensor_replay
+#define SIM_MASK			(EST_OUT_TDIS | EST_OUT_TDIS_DELAY | EST_OUT_PDIS_TEMP)	// as in main.c
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \enum		sim_col_t
+ * \brief		Columns of a *_tdis.csv log used by the simulation.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef enum
+{
+	COL_PD = 0,
+	COL_PS,
+	COL_SPEED,
+	COL_ST,
+	COL_WORK_MINUTES,
+	COL_T_DIS,
+	COL_N
+} sim_col_t;
+
+static const char *const sim_cols[COL_N] = {"Pd", "Ps", "CompSpeed", "ST", "WORK_MINUTES", "T_dis"};
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		sim_row_t
+ * \brief		One row of the logs, time in ms since the first row of the first log.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	int64_t time;
+	float data[COL_N];
+} sim_row_t;
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \struct		sim_jitter_t
+ * \brief		Start of the estimator work in every period, from the TRACE_EST_PERIOD records.
+ */
+//-------------------------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t n;					// periods
+	uint32_t start_last;		// cycle counter at the start of the last period
+	int64_t dev_min;			// deviation of the interval between two starts from the period, cycles
+	int64_t dev_max;
+	int64_t dev_abs_sum;
+	uint32_t late_max;			// largest release delay in ticks
+} sim_jitter_t;
+
+
+static sim_row_t *sim_rows;
+static size_t sim_n_rows;
+static unsigned int sim_speed = 1;			// -x
+static int64_t sim_gap_ms = SIM_GAP_MS;		// -g
+static TickType_t sim_period;				// period of the estimator task in ticks
+static volatile int sim_done;				// set by the acquisition task after the last row
+static TickType_t sim_end_tick;
+
+static FILE *sim_trace;						// -t, records for trace_decode.py --raw
+static char sim_trace_buf[1 << 16];
+static uint32_t sim_trace_n;
+static sim_jitter_t sim_jitter;
+
+static StaticTask_t sim_idle_tcb;
+static StackType_t sim_idle_stack[SIM_STACK];
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sim_load()
+ *
+ * \brief		Append the rows of a log to sim_rows[]. Rows without timestamp, and the first
+ *				row of a log after another, follow the previous one by SIM_INTERVAL_MS; a
+ *				time going back counts as no time passed, as in sensor_replay.
+ *
+ * \param[in]	path = log.
+ *
+ * \return		0, or 1 if the log cannot be read or lacks a column.
+*/
+//-------------------------------------------------------------------------------------------------
+static int sim_load(const char *path)
+{
+	csv_reader_t csv;
+	int idx[COL_N];
+	int64_t t, pre_t = CSV_TIME_NONE, clock;
+	size_t cap = sim_n_rows;
+	sim_row_t *row;
+
+	if (csv_open(&csv, path) != 0)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return 1;
+	}
+	if ((csv_next_row(&csv) < 0) || (csv_bind(&csv, sim_cols, COL_N, idx) != 0))
+	{
+		fprintf(stderr, "%s: not a *_tdis.csv log, needs Pd, Ps, CompSpeed, ST, WORK_MINUTES, T_dis\n", path);
+		csv_close(&csv);
+		return 1;
+	}
+
+	clock = (sim_n_rows > 0) ? sim_rows[sim_n_rows - 1].time : 0;
+	while (csv_next_row(&csv) >= 0)
+	{
+		if (sim_n_rows == cap)
+		{
+			cap = (cap > 0) ? 2 * cap : 4096;
+			row = realloc(sim_rows, cap * sizeof(*sim_rows));
+			if (row == NULL)
+			{
+				csv_close(&csv);
+				return 1;
+			}
+			sim_rows = row;
+		}
+		row = &sim_rows[sim_n_rows];
+		if (!csv_row_project(&csv, idx, COL_N, row->data))
+		{
+			continue;
+		}
+
+		t = csv_field_time_ms(&csv.fields[0]);
+		if ((t == CSV_TIME_NONE) || (pre_t == CSV_TIME_NONE))
+		{
+			clock += (sim_n_rows > 0) ? SIM_INTERVAL_MS : 0;
+		}
+		else if (t > pre_t)
+		{
+			clock += t - pre_t;
+		}
+		if (t != CSV_TIME_NONE)
+		{
+			pre_t = t;
+		}
+		row->time = clock;
+		sim_n_rows++;
+	}
+	csv_close(&csv);
+	return 0;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			trace_sink()
+ *
+ * \brief		Output of trace_drain(): the release jitter of the estimator task from its
+ *				TRACE_EST_PERIOD records, and with -t every record to the trace file.
+ *
+ * \param[in]	rec = record.
+*/
+//-------------------------------------------------------------------------------------------------
+void trace_sink(const trace_rec_t *rec)
+{
+	const uint32_t w[4] = {rec->seq, rec->time, rec->info, rec->value};
+	sim_jitter_t *j = &sim_jitter;
+	uint32_t start, late;
+	int64_t dev;
+
+	if (sim_trace != NULL)
+	{
+		fwrite(w, sizeof(w), 1, sim_trace);
+		sim_trace_n++;
+	}
+	if ((rec->info & 0xFFu) != TRACE_EST_PERIOD)
+	{
+		return;
+	}
+
+	/* the record is written at the end of the work, value is its length */
+	start = rec->time - rec->value;
+	late = rec->info >> 16;
+	if (j->n > 0)
+	{
+		dev = (int64_t)(uint32_t)(start - j->start_last)
+			- (int64_t)sim_period * SystemCoreClock / configTICK_RATE_HZ;
+		if ((j->n == 1) || (dev < j->dev_min))
+		{
+			j->dev_min = dev;
+		}
+		if ((j->n == 1) || (dev > j->dev_max))
+		{
+			j->dev_max = dev;
+		}
+		j->dev_abs_sum += (dev < 0) ? -dev : dev;
+	}
+	if (late > j->late_max)
+	{
+		j->late_max = late;
+	}
+	j->start_last = start;
+	j->n++;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sim_us()
+ *
+ * \brief		Cycles of the virtual core in microseconds.
+*/
+//-------------------------------------------------------------------------------------------------
+static double sim_us(double cycles)
+{
+	return cycles * 1e6 / SystemCoreClock;
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			sim_report()
+ *
+ * \brief		Print the latencies of the estimator task, the CPU time of the tasks, the
+ *				probes and the solver counters.
+*/
+//-------------------------------------------------------------------------------------------------
+static void sim_report(void)
+{
+	static TaskStatus_t tasks[TRACE_TASKS_MAX];
+	const estimator_ctx_t *ctx = estimator_task_ctx();
+	const sim_jitter_t *j = &sim_jitter;
+	const solver_stats_t *s;
+	est_task_stats_t st;
+	cycle_prof_stats_t ps;
+	uint32_t total, share, mean;
+	UBaseType_t n, i;
+	unsigned int id;
+
+	share = estimator_task_stats(&st);
+	n = uxTaskGetSystemState(tasks, TRACE_TASKS_MAX, &total);
+
+	printf("%lu rows, %.1f s of log in %.1f s (x%u), estimator period %lu ms\n", (unsigned long)sim_n_rows,
+		   (sim_n_rows > 0) ? sim_rows[sim_n_rows - 1].time * 0.001 : 0.0,
+		   (double)sim_end_tick / configTICK_RATE_HZ, sim_speed,
+		   (unsigned long)(sim_period * 1000u / configTICK_RATE_HZ));
+
+	printf("\nestTask: %lu periods, %lu samples, %lu dropped, %lu idle, %lu overruns, cpu %lu.%02lu %%\n",
+		   (unsigned long)st.periods, (unsigned long)st.samples, (unsigned long)st.dropped,
+		   (unsigned long)st.idle, (unsigned long)st.overruns,
+		   (unsigned long)(share / 100), (unsigned long)(share % 100));
+	printf("release: late max %lu ticks", (unsigned long)st.late_max);
+	if (j->n > 1)
+	{
+		printf(", start interval - period: min %.1f us, max %.1f us, mean |.| %.1f us",
+			   sim_us((double)j->dev_min), sim_us((double)j->dev_max), sim_us((double)j->dev_abs_sum / (j->n - 1)));
+	}
+	printf("\nwork: busy max %.1f us, last %.1f us\n", sim_us((double)st.busy_max * (1u << CYCLE_PROF_RUNTIME_SHIFT)),
+		   sim_us((double)st.busy_last * (1u << CYCLE_PROF_RUNTIME_SHIFT)));
+
+	printf("\n%-16s %5s %12s %8s\n", "task", "prio", "run time", "cpu %");
+	for (i = 0; i < n; i++)
+	{
+		printf("%-16s %5lu %12lu %8.2f\n", tasks[i].pcTaskName, (unsigned long)tasks[i].uxCurrentPriority,
+			   (unsigned long)tasks[i].ulRunTimeCounter,
+			   (total > 0) ? 100.0 * tasks[i].ulRunTimeCounter / total : 0.0);
+	}
+
+	printf("\n%-16s %10s %10s %10s %10s  (us, host)\n", "probe", "count", "mean", "min", "max");
+	for (id = 0; id < CYCLE_PROF_N; id++)
+	{
+		mean = cycle_prof_read(id, &ps);
+		if (ps.count > 0)
+		{
+			printf("%-16s %10lu %10.2f %10.2f %10.2f\n", cycle_prof_name(id), (unsigned long)ps.count,
+				   sim_us(mean), sim_us(ps.min), sim_us(ps.max));
+		}
+	}
+
+	s = &ctx->stats[EST_SOLVER_PDIS_TEMP];
+	if (s->runs > 0)
+	{
+		printf("\npdis_temp solver: %lu runs, %lu not converged, %.2f iterations per run\n",
+			   s->runs, s->not_converged, (double)s->iterations / s->runs);
+	}
+	if (sim_trace != NULL)
+	{
+		printf("trace: %lu records, %lu lost\n", (unsigned long)sim_trace_n, (unsigned long)trace_lost());
+	}
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			StartDefaultTask()
+ *
+ * \brief		As on the target: wakes every tick.
+*/
+//-------------------------------------------------------------------------------------------------
+static void StartDefaultTask(void *argument)
+{
+	(void)argument;
+	for (;;)
+	{
+		vTaskDelay(1);
+	}
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			StartTask02()
+ *
+ * \brief		Acquisition: post every row at its log time divided by -x; waits for a row
+ *				longer than -g s of log time are cut. in.tick keeps the log time, so the
+ *				estimator sees the true interval between the samples.
+*/
+//-------------------------------------------------------------------------------------------------
+static void StartTask02(void *argument)
+{
+	est_input_t in;
+	TickType_t start, wake, due;
+	int64_t wait_ms = 0, dt;
+	const sim_row_t *row;
+	size_t i;
+
+	(void)argument;
+	memset(&in, 0, sizeof(in));
+	in.sample.U = SIM_VOLTAGE;
+	start = xTaskGetTickCount();
+	wake = start;
+
+	for (i = 0; i < sim_n_rows; i++)
+	{
+		row = &sim_rows[i];
+		dt = (i > 0) ? row->time - sim_rows[i - 1].time : 0;
+		wait_ms += (dt > sim_gap_ms) ? sim_gap_ms : dt;
+		due = start + (TickType_t)(wait_ms * configTICK_RATE_HZ / 1000 / sim_speed);
+		if (due > wake)
+		{
+			vTaskDelayUntil(&wake, due - wake);
+		}
+
+		in.sample.p_dis_g = row->data[COL_PD];
+		in.sample.p_suc_g = row->data[COL_PS];
+		in.sample.compSpeed = row->data[COL_SPEED];
+		in.sample.t_suc = row->data[COL_ST];
+		in.sample.t_dis = row->data[COL_T_DIS];
+		in.work_minutes = row->data[COL_WORK_MINUTES];
+		in.tick = (TickType_t)(row->time * configTICK_RATE_HZ / 1000);
+		estimator_task_post(&in);
+	}
+
+	/* two more periods for the estimator to take the last samples */
+	vTaskDelay(2 * sim_period);
+	sim_end_tick = xTaskGetTickCount() - start;
+	sim_done = 1;
+	vTaskDelete(NULL);
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			startCPU_Task()
+ *
+ * \brief		As on the target: run time stats and drain of the trace ring. Prints the
+ *				report and ends the simulation once the acquisition is done.
+*/
+//-------------------------------------------------------------------------------------------------
+static void startCPU_Task(void *argument)
+{
+	TickType_t wake = xTaskGetTickCount();
+	uint32_t n = 0;
+
+	(void)argument;
+	for (;;)
+	{
+		if (n++ % (TRACE_STATS_MS / TRACE_DRAIN_MS) == 0)
+		{
+			trace_stats();
+		}
+		trace_drain();
+		if (sim_done)
+		{
+			trace_stats();
+			trace_drain();
+			sim_report();
+			if (sim_trace != NULL)
+			{
+				fclose(sim_trace);
+			}
+			fflush(stdout);
+			exit(0);
+		}
+		vTaskDelayUntil(&wake, pdMS_TO_TICKS(TRACE_DRAIN_MS));
+	}
+}
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			configureTimerForRunTimeStats(), getRunTimeCounterValue()
+ *
+ * \brief		Run time stats on the cycle counter, as in main.c.
+*/
+//-------------------------------------------------------------------------------------------------
+void configureTimerForRunTimeStats(void)
+{
+	cycle_prof_init();
+}
+
+unsigned long getRunTimeCounterValue(void)
+{
+	return cycle_prof_runtime();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * \fn			vApplicationTickHook(), vApplicationIdleHook(), vApplicationGetIdleTaskMemory()
+ *
+ * \brief		Hooks of the kernel: the HAL tick (TIM7 on the target), an idle task which
+ *				sleeps instead of spinning a host core, and its static memory.
+*/
+//-------------------------------------------------------------------------------------------------
+void vApplicationTickHook(void)
+{
+	HAL_IncTick();
+}
+
+void vApplicationIdleHook(void)
+{
+	const struct timespec ts = {0, 100000};
+
+	nanosleep(&ts, NULL);
+}
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack, configSTACK_DEPTH_TYPE *size)
+{
+	*tcb = &sim_idle_tcb;
+	*stack = sim_idle_stack;
+	*size = SIM_STACK;
+}
+
+
+
+
+int main(int argc, char *argv[])
+{
+	const char *trace_path = NULL;
+	int a, files = 0;
+
+	for (a = 1; a < argc; a++)
+	{
+		if ((strcmp(argv[a], "-x") == 0) && (a + 1 < argc))
+			sim_speed = (unsigned int)atol(argv[++a]);
+		else if ((strcmp(argv[a], "-g") == 0) && (a + 1 < argc))
+			sim_gap_ms = (int64_t)(atof(argv[++a]) * 1000);
+		else if ((strcmp(argv[a], "-t") == 0) && (a + 1 < argc))
+			trace_path = argv[++a];
+		else if (argv[a][0] == '-')
+			break;
+		else if (sim_load(argv[a]) != 0)
+			return 1;
+		else
+			files++;
+	}
+	if ((a < argc) || (files == 0) || (sim_speed == 0) || (sim_speed > EST_TASK_PERIOD_MS))
+	{
+		printf("usage: %s [-x speed] [-g s] [-t trace.bin] log_tdis.csv...\n"
+			   "  -x  run x times faster than the log, 1..%d (default 1)\n"
+			   "  -g  longest wait for a row in s of log time (default %d)\n"
+			   "  -t  write the trace records, see trace_decode.py --raw\n",
+			   argv[0], EST_TASK_PERIOD_MS, SIM_GAP_MS / 1000);
+		return 1;
+	}
+	if (sim_n_rows == 0)
+	{
+		fprintf(stderr, "no rows\n");
+		return 1;
+	}
+	if (trace_path != NULL)
+	{
+		if ((sim_trace = fopen(trace_path, "wb")) == NULL)
+		{
+			fprintf(stderr, "%s: cannot create\n", trace_path);
+			return 1;
+		}
+		setvbuf(sim_trace, sim_trace_buf, _IOFBF, sizeof(sim_trace_buf));
+	}
+
+	HAL_Init();
+	trace_init();
+	sim_period = pdMS_TO_TICKS(EST_TASK_PERIOD_MS) / sim_speed;
+	estimator_task_init(SIM_MASK, sim_period);
+
+	/* names and priorities of main.c, osPriorityNormal = 24, osPriorityLow = 8, osPriorityHigh = 40 */
+	xTaskCreate(StartDefaultTask, "defaultTask", SIM_STACK, NULL, 24, NULL);
+	xTaskCreate(StartTask02, "myTask02", SIM_STACK, NULL, 24, NULL);
+	xTaskCreate(startCPU_Task, "CPU_Task", SIM_STACK, NULL, 8, NULL);
+	xTaskCreate(estimator_task, "estTask", SIM_STACK, NULL, 40, NULL);
+
+	vTaskStartScheduler();
+	return 1;
+}
@@ -0,0 +1,187 @@
+"""
+Cross-check of the C model (C_code/src, through sensor_native) against the Python
+reference (infer_sensor_algorithm) over the logged data.
+
+Every log (*.csv except *_result.csv) under the given directories, by default
+C_code/temp_data and C_code/temp_data1, is run through both implementations with
+the same inputs, rows with the compressor running only:
+    T_dis    cal_tdis from the logged Pd, Ps, CompSpeed, ST
+    Pd       cal_pd from the logged T_dis, every --pd-stride row (dichotomy_test1 is slow)
+    dens     cal_density of the suction gas from Ps, ST
+The logged pressures are gage, as in sensor_replay, and are converted to absolute.
+Rows with a suction superheat below --ssh-min are reported apart (low_ssh): there the C
+model scales fw down (z_fw in cal_steady) and below 1 K takes saturated gas
+(cal_suction_state), the reference does neither. They are compared against the
+tolerance only with --all-rows.
+
+For every column the number of rows, the max and mean absolute difference, the log and
+row of the max, and the rows where only one implementation has no value (NaN) are
+printed. The exit status is 1 if a max difference or NaN mismatch count is beyond the
+tolerance (-t col=tol), 2 if the library is not built or there are no logs.
+
+usage: python cross_check.py [-t T_dis=0.01] [--coe python|c] [--pd-stride 20] [--ssh-min 2]
+                             [--all-rows] [-v] [dir|file ...]
+"""
+import argparse
+import glob
+import os
+import sys
+import warnings
+
+import numpy as np
+import pandas as pd
+
+import infer_sensor_algorithm
+import sensor_native
+from property import Property
+
+P_ATM = 101.35
+COLUMNS = ('T_dis', 'Pd', 'dens')
+# max absolute difference, degC, kPa, kg/m^3
+TOLERANCE = {'T_dis': 0.01, 'Pd': 0.5, 'dens': 0.001}
+
+
+class ColumnStats():
+    """
+    Absolute differences of one column over all logs.
+    """
+
+    def __init__(self):
+        self.rows = 0
+        self.sum = 0.0
+        self.max = 0.0
+        self.where = ''
+        self.nan_mismatch = 0
+
+    def add(self, ref, nat, name, index):
+        ref = np.asarray(ref, dtype=np.float64)
+        nat = np.asarray(nat, dtype=np.float64)
+        both = np.isfinite(ref) & np.isfinite(nat)
+        self.nan_mismatch += int(np.count_nonzero(np.isfinite(ref) != np.isfinite(nat)))
+        diff = np.abs(ref[both] - nat[both])
+        if not len(diff):
+            return 0.0
+        self.rows += len(diff)
+        self.sum += float(diff.sum())
+        i = int(np.argmax(diff))
+        if diff[i] > self.max:
+            self.max = float(diff[i])
+            self.where = '%s:%s' % (name, np.asarray(index)[both][i])
+        return float(diff[i])
+
+    def mean(self):
+        return self.sum / self.rows if self.rows else 0.0
+
+
+def find_logs(paths):
+    logs = []
+    for path in paths:
+        if os.path.isdir(path):
+            logs += glob.glob(os.path.join(path, '*.csv'))
+        else:
+            logs += glob.glob(path)
+    return sorted(f for f in logs if not f.endswith('_result.csv'))
+
+
+def check_log(path, ref, nat, args, stats):
+    """
+    Run one log through both implementations.
+
+    Returns
+    ----------
+    line: str, max difference of every column in the log
+    """
+    d = pd.read_csv(path, index_col=0)
+    d = d[d['CompSpeed'] > 0]
+    if not len(d):
+        return '%s: no running rows' % path
+    pd_abs = d['Pd'] + P_ATM
+    ps_abs = d['Ps'] + P_ATM
+    ssh = d['ST'] - Property().cal_t_sat(ps_abs)
+    groups = {'': np.ones(len(d), dtype=bool)} if args.all_rows else \
+        {'': (ssh >= args.ssh_min).values, 'low_ssh': (ssh < args.ssh_min).values}
+    name = os.path.basename(path)
+
+    with warnings.catch_warnings():
+        warnings.simplefilter('ignore')
+        out = {
+            'T_dis': (ref.cal_tdis(d['Fw'], pd_abs, ps_abs, d['CompSpeed'], d['ST'], d['CompSpeed_rated']),
+                      nat.cal_tdis(d['Fw'], pd_abs, ps_abs, d['CompSpeed'], d['ST'], d['CompSpeed_rated'])),
+            'dens': (ref.cal_density(ps_abs, d['ST']), nat.cal_density(ps_abs, d['ST'])),
+        }
+        rows = slice(None, None, args.pd_stride)
+        s = d.iloc[rows]
+        out['Pd'] = (ref.cal_pd(s['Fw'], s['T_dis'], ps_abs.iloc[rows], s['CompSpeed'], s['ST'], s['CompSpeed_rated']),
+                     nat.cal_pd(s['Fw'], s['T_dis'], ps_abs.iloc[rows], s['CompSpeed'], s['ST'], s['CompSpeed_rated']))
+
+    worst = []
+    for col in COLUMNS:
+        r, n = out[col]
+        for group, mask in groups.items():
+            mask = mask[rows] if col == 'Pd' else mask
+            index = (s if col == 'Pd' else d).index[mask]
+            m = stats[col + ('/' + group if group else '')].add(np.asarray(r)[mask], np.asarray(n)[mask], name, index)
+            if not group:
+                worst.append('%s %.4g' % (col, m))
+    return '%s: %d rows, max %s' % (path, len(d), ', '.join(worst))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Cross-check the C model against the Python reference.')
+    parser.add_argument('paths', nargs='*', help='directories or files of logs')
+    parser.add_argument('-t', '--tol', action='append', default=[], metavar='COL=TOL',
+                        help='max absolute difference of a column, default ' +
+                        ' '.join('%s=%g' % kv for kv in TOLERANCE.items()))
+    parser.add_argument('--nan-tol', type=int, default=0, help='rows with a NaN in only one implementation')
+    parser.add_argument('--coe', choices=('python', 'c'), default='python',
+                        help='coefficients of the C model: the defaults of Compressor_model or COE_32')
+    parser.add_argument('--pd-stride', type=int, default=20, help='solve Pd on every n-th row')
+    parser.add_argument('--ssh-min', type=float, default=2.0, help='suction superheat below which rows are low_ssh')
+    parser.add_argument('--all-rows', action='store_true', help='check the low_ssh rows against the tolerance too')
+    parser.add_argument('-v', '--verbose', action='store_true', help='print the max differences of every log')
+    args = parser.parse_args()
+
+    tol = dict(TOLERANCE)
+    for item in args.tol:
+        col, _, value = item.partition('=')
+        if col not in tol:
+            parser.error('unknown column %s' % col)
+        tol[col] = float(value)
+
+    top = os.path.dirname(os.path.abspath(__file__))
+    logs = find_logs(args.paths or [os.path.join(top, 'C_code', 'temp_data'), os.path.join(top, 'C_code', 'temp_data1')])
+    ref = infer_sensor_algorithm.InferSensor()
+    nat = sensor_native.InferSensor(c_defaults=args.coe == 'c')
+    if not nat.native:
+        print('C library not found, run make lib in C_code or set SENSOR_LIB', file=sys.stderr)
+        return 2
+    if not logs:
+        print('no logs', file=sys.stderr)
+        return 2
+
+    stats = {}
+    for col in COLUMNS:
+        stats[col] = ColumnStats()
+        if not args.all_rows:
+            stats[col + '/low_ssh'] = ColumnStats()
+    for path in logs:
+        line = check_log(path, ref, nat, args, stats)
+        if args.verbose:
+            print(line)
+
+    failed = False
+    print('%d logs, coefficients %s' % (len(logs), args.coe))
+    print('%-14s %9s %12s %12s %9s %9s  %s' % ('column', 'rows', 'max', 'mean', 'nan', 'tol', 'max at'))
+    for key, st in stats.items():
+        col = key.split('/')[0]
+        checked = '/' not in key
+        bad = checked and (st.max > tol[col] or st.nan_mismatch > args.nan_tol)
+        failed |= bad
+        print('%-14s %9d %12.6g %12.6g %9d %9s  %s%s' % (key, st.rows, st.max, st.mean(), st.nan_mismatch,
+                                                      '%g' % tol[col] if checked else '-', st.where,
+                                                      '  FAIL' if bad else ''))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
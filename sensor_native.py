@@ -0,0 +1,204 @@
+import ctypes
+import os
+import numbers
+
+import numpy as np
+import pandas as pd
+
+import infer_sensor_algorithm
+from compressor_model import Compressor_model
+
+
+class _Col(ctypes.Structure):
+    _fields_ = [('v', ctypes.POINTER(ctypes.c_double)), ('stride', ctypes.c_long)]
+
+
+class _Cfg(ctypes.Structure):
+    _fields_ = [('fw', ctypes.c_double), ('comp_speed_rated', ctypes.c_double),
+                ('coe', ctypes.POINTER(ctypes.c_float))]
+
+
+def _load_lib():
+    """
+    Load the batch library of C_code (make lib), or the file named by SENSOR_LIB.
+
+    Returns
+    ----------
+    lib: ctypes.CDLL or None if the library is not built
+    """
+    path = os.environ.get('SENSOR_LIB', os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), 'C_code', 'libsensor_predict.so'))
+    try:
+        lib = ctypes.CDLL(path)
+    except OSError:
+        return None
+    cfg_p = ctypes.POINTER(_Cfg)
+    out_p = ctypes.POINTER(ctypes.c_double)
+    for name in ('batch_tdis', 'batch_pdis_temp', 'batch_pdis_curr'):
+        fn = getattr(lib, name)
+        fn.argtypes = [cfg_p, ctypes.c_long, _Col, _Col, _Col, _Col, out_p]
+        fn.restype = ctypes.c_long
+    lib.batch_density.argtypes = [ctypes.c_long, _Col, _Col, out_p]
+    lib.batch_density.restype = None
+    return lib
+
+
+_lib = _load_lib()
+# default coefficients of Compressor_model, the C model defaults to COE_32
+_COE_DEFAULT = Compressor_model(2.0, 1.0, 1.0, 0.0, 1.0).coe_a
+
+
+def _is_array(x):
+    return isinstance(x, (pd.Series, np.ndarray, list, tuple)) and np.ndim(x) > 0
+
+
+class _Batch():
+    """
+    Rows of one call: float64 views of the inputs, no copy for float64 arrays and Series.
+    """
+
+    def __init__(self, *args):
+        self.index = None
+        self.n = None
+        for x in args:
+            if _is_array(x):
+                if self.n is None:
+                    self.n = len(x)
+                elif len(x) != self.n:
+                    raise ValueError('inputs have different lengths')
+                if self.index is None and isinstance(x, pd.Series):
+                    self.index = x.index
+        self.scalar = self.n is None
+        if self.scalar:
+            self.n = 1
+        self.keep = []
+
+    def col(self, x):
+        if not _is_array(x):
+            a = np.array([x], dtype=np.float64)
+            stride = 0
+        else:
+            a = np.asarray(x, dtype=np.float64)
+            if a.ndim != 1:
+                raise ValueError('inputs must be 1-D')
+            if a.strides[0] % a.itemsize:
+                a = np.ascontiguousarray(a)
+            stride = a.strides[0] // a.itemsize
+        self.keep.append(a)
+        return _Col(ctypes.cast(a.ctypes.data, ctypes.POINTER(ctypes.c_double)), stride)
+
+    def result(self, out, series=True):
+        if self.scalar:
+            return float(out[0])
+        if series and self.index is not None:
+            return pd.Series(out, index=self.index)
+        return out
+
+
+def _groups(n, fw, rated):
+    """
+    Rows with the same fw and rated speed.
+
+    Returns
+    ----------
+    groups: list of (fw, rated, rows), rows is None for all rows
+    """
+    if not _is_array(fw) and not _is_array(rated):
+        return [(float(fw), float(rated), None)]
+    key = np.empty((n, 2))
+    key[:, 0] = np.asarray(fw, dtype=np.float64)
+    key[:, 1] = np.asarray(rated, dtype=np.float64)
+    if (key == key[0]).all():
+        return [(key[0, 0], key[0, 1], None)]
+    values, inverse = np.unique(key, axis=0, return_inverse=True)
+    inverse = inverse.reshape(-1)
+    return [(v[0], v[1], np.flatnonzero(inverse == i)) for i, v in enumerate(values)]
+
+
+class InferSensor(infer_sensor_algorithm.InferSensor):
+    """
+    InferSensor with cal_tdis, cal_pd and cal_density computed by the C model
+    (C_code/src/sensor_batch.c). Same arguments and results as infer_sensor_algorithm,
+    falls back to it if the library is not built (make lib in C_code).
+    The discharge pressure is solved by the C solver, not by dichotomy_test1.
+    With c_defaults the C model keeps its own coefficients (COE_32) when no
+    custom_init_coe is given. unsolved is the number of rows of the last call
+    without a root or not converged.
+    """
+
+    def __init__(self, c_defaults=False) -> None:
+        super().__init__()
+        self.native = _lib is not None
+        self.c_defaults = c_defaults
+        self.unsolved = 0
+
+    def _run(self, fn, fw, rated, coe, args):
+        batch = _Batch(fw, rated, *args)
+        out = np.empty(batch.n)
+        if isinstance(coe, list) and len(coe) == 32:
+            coe_c = (ctypes.c_float * 32)(*coe)
+        elif self.c_defaults:
+            coe_c = None
+        else:
+            coe_c = (ctypes.c_float * 32)(*_COE_DEFAULT)
+        self.unsolved = 0
+        for g_fw, g_rated, rows in _groups(batch.n, fw, rated):
+            cfg = _Cfg(g_fw, g_rated, coe_c)
+            if rows is None:
+                cols = [batch.col(x) for x in args]
+                self.unsolved += fn(ctypes.byref(cfg), batch.n, *cols, out.ctypes.data_as(ctypes.POINTER(ctypes.c_double)))
+            else:
+                cols = [batch.col(np.asarray(x, dtype=np.float64)[rows] if _is_array(x) else x) for x in args]
+                part = np.empty(len(rows))
+                self.unsolved += fn(ctypes.byref(cfg), len(rows), *cols, part.ctypes.data_as(ctypes.POINTER(ctypes.c_double)))
+                out[rows] = part
+        return batch, out
+
+    def cal_density(self, pa, t, coe_init=None):
+        if not self.native or coe_init is not None:
+            return super().cal_density(pa, t, coe_init)
+        batch = _Batch(pa, t)
+        out = np.empty(batch.n)
+        _lib.batch_density(batch.n, batch.col(pa), batch.col(t), out.ctypes.data_as(ctypes.POINTER(ctypes.c_double)))
+        return batch.result(out)
+
+    def cal_tdis(self, fw, Pd, Ps, CompSpeed, ST, CompSpeed_rated, custom_init_coe=None):
+        if not self.native:
+            return super().cal_tdis(fw, Pd, Ps, CompSpeed, ST, CompSpeed_rated, custom_init_coe)
+        batch, out = self._run(_lib.batch_tdis, fw, CompSpeed_rated, custom_init_coe, (Pd, Ps, CompSpeed, ST))
+        return batch.result(out)
+
+    def cal_pd(self, fw, t_dis, Ps, CompSpeed, ST, CompSpeed_rated, custom_init_coe=None):
+        if not self.native:
+            return super().cal_pd(fw, t_dis, Ps, CompSpeed, ST, CompSpeed_rated, custom_init_coe)
+        if not _is_array(t_dis) and not isinstance(t_dis, numbers.Number):
+            return 'TYPE ERROR'
+        batch, out = self._run(_lib.batch_pdis_temp, fw, CompSpeed_rated, custom_init_coe, (t_dis, Ps, CompSpeed, ST))
+        return batch.result(out, series=False)
+
+    def cal_pd_curr(self, Ps, current, CompSpeed, U, CompSpeed_rated, custom_init_coe=None):
+        """
+        Calculated discharge pressure from the current of the compressor, C model only
+
+        Parameters
+        ----------
+        Ps: Number or Series
+            kPa
+        current: Number or Series
+            A
+        CompSpeed: Number or Series
+            rpm
+        U: Number or Series
+            V
+        CompSpeed_rated: Number or Series
+            rpm
+
+        Returns
+        ----------
+        Pd: Numerical-> flot or np.array
+            Discharge pressure in kPa
+        """
+        if not self.native:
+            raise RuntimeError('cal_pd_curr needs the C library, run make lib in C_code')
+        batch, out = self._run(_lib.batch_pdis_curr, 0.0, CompSpeed_rated, custom_init_coe, (Ps, current, CompSpeed, U))
+        return batch.result(out, series=False)
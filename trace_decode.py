@@ -0,0 +1,218 @@
+"""
+Decoder of the binary trace of Mini_VRV (Core/Src/trace_buf.c).
+
+The firmware writes 16 byte records (seq, time, info, value; little endian words) into
+a RAM ring and drains them to ITM stimulus port 1. The input is either the SWO capture
+(ITM packets, e.g. the file output of the debugger's SWV/trace port), or with --raw a
+plain stream of records, such as a memory dump of trace_ring[] or the output of the
+host simulation.
+
+For every snapshot of the run time stats (TRACE_CLOCK .. TRACE_TOTAL) the task table is
+rebuilt: number, name, priority, state, stack high water mark, run time and the CPU
+share since the previous snapshot (since the start for the first one). The periods of
+the estimator task (TRACE_EST_PERIOD) and the task switches (TRACE_TASK_IN, if enabled)
+are summed up. Records missing in the stream (seq gaps) and records the firmware lost
+are reported.
+
+usage: python trace_decode.py [--raw] [--port 1] [-a] [--csv file] trace.bin
+"""
+import argparse
+import csv
+import struct
+import sys
+
+TRACE_CLOCK = 1
+TRACE_TASK_NAME = 2
+TRACE_TASK_INFO = 3
+TRACE_TASK_RUNTIME = 4
+TRACE_TOTAL = 5
+TRACE_TASK_IN = 6
+TRACE_EST_PERIOD = 7
+
+STATES = 'XRBSD'    # eRunning, eReady, eBlocked, eSuspended, eDeleted
+
+
+def itm_words(data, port):
+    """
+    Payload of the software source packets of one stimulus port, as 32 bit words.
+    Local timestamp, overflow, extension and hardware source packets are skipped.
+    """
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        h = data[i]
+        i += 1
+        if h == 0x00 or h == 0x70:              # synchronisation, overflow
+            continue
+        if h & 0x03:                            # source packet
+            size = (1, 2, 4)[(h & 0x03) - 1]
+            if not h & 0x04 and h >> 3 == port:
+                out += data[i:i + size]
+            i += size
+            continue
+        if h & 0x0F == 0 or h & 0x0B == 0x08:   # local timestamp, extension
+            if h & 0x80:
+                while i < n and data[i] & 0x80:
+                    i += 1
+                i += 1
+            continue
+        # global timestamp and reserved headers: skip the continuation bytes
+        while i < n and data[i] & 0x80:
+            i += 1
+        i += 1
+    return bytes(out)
+
+
+def records(data):
+    """
+    Records of a stream, sorted by seq if it is a ring dump (seq not monotonic).
+    """
+    n = len(data) // 16
+    recs = [struct.unpack_from('<4I', data, 16 * k) for k in range(n)]
+    recs = [r for r in recs if r[0] != 0xFFFFFFFF]
+    if any(b[0] < a[0] for a, b in zip(recs, recs[1:])):
+        recs.sort(key=lambda r: r[0])
+    return recs
+
+
+class Decoder():
+    """
+    Rebuilds the task table and the CPU shares from the records.
+    """
+
+    def __init__(self):
+        self.clock = None
+        self.shift = 0
+        self.t_hi = 0
+        self.t_last = None
+        self.names = {}
+        self.snap = {}
+        self.prev_runtime = {}
+        self.prev_total = None
+        self.snapshots = []
+        self.gaps = 0
+        self.missing = 0
+        self.lost = 0
+        self.switches = {}
+        self.est = {'periods': 0, 'samples': 0, 'idle': 0, 'busy_sum': 0, 'busy_max': 0, 'late_max': 0}
+        self.seq = None
+
+    def time(self, t):
+        """ cycle counter extended to 64 bits, records are at most 2^32 cycles apart """
+        if self.t_last is not None and t < self.t_last:
+            self.t_hi += 1 << 32
+        self.t_last = t
+        return self.t_hi + t
+
+    def seconds(self, cycles):
+        return cycles / self.clock if self.clock else float('nan')
+
+    def add(self, rec):
+        seq, t, info, value = rec
+        if self.seq is not None and seq != self.seq + 1:
+            self.gaps += 1
+            self.missing += (seq - self.seq - 1) & 0xFFFFFFFF
+        self.seq = seq
+        kind, rid, arg = info & 0xFF, (info >> 8) & 0xFF, info >> 16
+        t = self.time(t)
+
+        if kind == TRACE_CLOCK:
+            self.clock = value
+            self.shift = rid
+            self.snap = {}
+        elif kind == TRACE_TASK_NAME:
+            name = self.names.get(rid, '') if arg else ''
+            name = name[:arg] + value.to_bytes(4, 'little').split(b'\0')[0].decode('ascii', 'replace')
+            self.names[rid] = name
+        elif kind == TRACE_TASK_INFO:
+            self.snap.setdefault(rid, {}).update(prio=arg >> 8, state=arg & 0xFF, stack=value)
+        elif kind == TRACE_TASK_RUNTIME:
+            self.snap.setdefault(rid, {})['runtime'] = value
+        elif kind == TRACE_TOTAL:
+            self.lost = arg
+            self.close_snapshot(t, rid, value)
+        elif kind == TRACE_TASK_IN:
+            self.switches[rid] = self.switches.get(rid, 0) + 1
+        elif kind == TRACE_EST_PERIOD:
+            e = self.est
+            e['periods'] += 1
+            e['samples'] += rid
+            e['idle'] += rid == 0
+            e['busy_sum'] += value
+            e['busy_max'] = max(e['busy_max'], value)
+            e['late_max'] = max(e['late_max'], arg)
+
+    def close_snapshot(self, t, n, total):
+        if n != len(self.snap):
+            print('snapshot at %.3f s: %d tasks announced, %d decoded' % (self.seconds(t), n, len(self.snap)),
+                  file=sys.stderr)
+        d_total = total - self.prev_total if self.prev_total is not None else total
+        rows = []
+        for num in sorted(self.snap):
+            s = self.snap[num]
+            rt = s.get('runtime', 0)
+            d_rt = rt - self.prev_runtime.get(num, 0) if self.prev_total is not None else rt
+            rows.append({'num': num, 'name': self.names.get(num, '?'), 'prio': s.get('prio', -1),
+                         'state': STATES[s['state']] if s.get('state', 9) < len(STATES) else '?',
+                         'stack': s.get('stack', -1), 'runtime': rt,
+                         'cpu': 100.0 * d_rt / d_total if d_total > 0 else float('nan')})
+            self.prev_runtime[num] = rt
+        self.prev_total = total
+        self.snapshots.append({'time': self.seconds(t), 'total': total, 'lost': self.lost, 'tasks': rows})
+
+
+def print_snapshot(snap):
+    print('t=%.3f s  total run time %d  lost %d' % (snap['time'], snap['total'], snap['lost']))
+    print('%4s %-16s %5s %5s %8s %12s %8s' % ('num', 'task', 'prio', 'state', 'stack', 'run time', 'cpu %'))
+    for r in sorted(snap['tasks'], key=lambda r: -r['cpu'] if r['cpu'] == r['cpu'] else 0):
+        print('%4d %-16s %5d %5s %8d %12d %8.2f' % (r['num'], r['name'], r['prio'], r['state'], r['stack'],
+                                                    r['runtime'], r['cpu']))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode the binary trace of Mini_VRV.')
+    parser.add_argument('file', help='SWO capture, or record stream with --raw')
+    parser.add_argument('--raw', action='store_true', help='the file holds records, not ITM packets')
+    parser.add_argument('--port', type=int, default=1, help='ITM stimulus port of the trace')
+    parser.add_argument('-a', '--all', action='store_true', help='print every snapshot, not only the last')
+    parser.add_argument('--csv', help='write every task of every snapshot to a csv file')
+    args = parser.parse_args()
+
+    with open(args.file, 'rb') as f:
+        data = f.read()
+    if not args.raw:
+        data = itm_words(data, args.port)
+    dec = Decoder()
+    for rec in records(data):
+        dec.add(rec)
+
+    if not dec.snapshots:
+        print('no snapshot of the run time stats in %s' % args.file, file=sys.stderr)
+        return 1
+    for snap in dec.snapshots if args.all else dec.snapshots[-1:]:
+        print_snapshot(snap)
+        print()
+    print('%d snapshots, %d gaps in the stream (%d records), %d records lost in the firmware' %
+          (len(dec.snapshots), dec.gaps, dec.missing, dec.lost))
+    e = dec.est
+    if e['periods']:
+        print('estimator: %d periods, %d samples, %d idle, busy mean %.1f us max %.1f us, late max %d ticks' %
+              (e['periods'], e['samples'], e['idle'], 1e6 * dec.seconds(e['busy_sum'] / e['periods']),
+               1e6 * dec.seconds(e['busy_max']), e['late_max']))
+    if dec.switches:
+        print('task switches: ' + ', '.join('%s %d' % (dec.names.get(k, k), v) for k, v in sorted(dec.switches.items())))
+
+    if args.csv:
+        with open(args.csv, 'w', newline='') as f:
+            w = csv.writer(f)
+            w.writerow(['time', 'num', 'task', 'prio', 'state', 'stack', 'runtime', 'cpu'])
+            for snap in dec.snapshots:
+                for r in snap['tasks']:
+                    w.writerow(['%.6f' % snap['time'], r['num'], r['name'], r['prio'], r['state'], r['stack'],
+                                r['runtime'], '%.4f' % r['cpu']])
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())